@@ -0,0 +1,366 @@
+// ac-fakehost: a simulated remote host for the fleet benchmark.
+//
+// RemoteWorker runs it in place of ssh as "ac-fakehost [options] HOST
+// COMMAND" and it answers the commands RemoteWorker sends the way a Linux
+// host would: the connection test, the agent check and upload, one-shot
+// /proc sample frames, and the shell and ac-agent streams. Counters are a
+// deterministic function of the host name and the wall clock, so separate
+// invocations for one host continue each other's counters. Plain C++ and
+// one short-lived or streaming process per command, like ssh.
+//
+//   --latency MS        delay before every answer (default 20)
+//   --jitter MS         uniform spread of that delay (default 10)
+//   --fail-rate P       connection refused on the connection test
+//   --drop-rate P       session lost before an answer
+//   --reboot-every S    counters and uptime restart every S seconds
+//   --agent-missing P   agent check reports no ac-agent, so it is uploaded
+
+#include "AgentProtocol.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+namespace {
+constexpr double kTwoPi = 6.283185307179586;
+constexpr int kHz = 100;
+// Hosts without --reboot-every booted some days before this (2024-01-01)
+constexpr double kBootEpoch = 1704067200.0;
+
+struct Options {
+    double latencyMs = 20.0;
+    double jitterMs = 10.0;
+    double failRate = 0.0;
+    double dropRate = 0.0;
+    double rebootEvery = 0.0;
+    double agentMissing = 0.0;
+};
+
+uint64_t hashName(const std::string &name)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// rate(t) = base * (1 + amplitude * sin(omega * t + phase)) and its integral,
+// so counters grow at a varying but always positive rate
+struct Wave {
+    double base;
+    double amplitude;
+    double omega;
+    double phase;
+
+    double integral(double from, double to) const
+    {
+        return base * ((to - from) + amplitude / omega
+                       * (std::cos(omega * from + phase) - std::cos(omega * to + phase)));
+    }
+    double at(double t) const { return base * (1.0 + amplitude * std::sin(omega * t + phase)); }
+};
+
+// Everything a sample frame carries, for one host at one moment
+struct Counters {
+    double uptime;
+    uint64_t cpuTotal;
+    uint64_t cpuIdle;
+    uint64_t memTotalKb;
+    uint64_t memAvailableKb;
+    uint64_t netRx;
+    uint64_t netTx;
+    uint64_t sectorsRead;
+    uint64_t sectorsWritten;
+    uint64_t fsBlocks;
+    uint64_t fsAvailable;
+};
+
+class HostModel
+{
+public:
+    HostModel(const std::string &name, double rebootEvery)
+        : m_seed(hashName(name))
+        , m_rebootEvery(rebootEvery)
+    {
+        m_cpus = 2 << (m_seed % 4);
+        m_memTotalKb = uint64_t(4) << (20 + (m_seed >> 2) % 4);
+        // busy * (1 +- amplitude) stays within [0, 1]
+        const double busy = 0.1 + 0.4 * fraction(1);
+        m_busy = {busy, 0.9, kTwoPi / (60.0 + 240.0 * fraction(2)), kTwoPi * fraction(3)};
+        m_memory = {0.3 + 0.4 * fraction(4), 0.3, kTwoPi / 1800.0, kTwoPi * fraction(5)};
+        m_rx = {2e5 + 2e7 * fraction(6), 0.9, kTwoPi / 120.0, kTwoPi * fraction(7)};
+        m_tx = {1e5 + 5e6 * fraction(8), 0.9, kTwoPi / 90.0, kTwoPi * fraction(9)};
+        m_read = {100.0 + 4000.0 * fraction(10), 0.9, kTwoPi / 45.0, kTwoPi * fraction(11)};
+        m_write = {100.0 + 8000.0 * fraction(12), 0.9, kTwoPi / 75.0, kTwoPi * fraction(13)};
+        m_fsUsed = 0.2 + 0.6 * fraction(14);
+        m_boot = kBootEpoch - 86400.0 * 30.0 * fraction(15);
+        m_rebootOffset = m_rebootEvery * fraction(16);
+    }
+
+    Counters sample(double now) const
+    {
+        double boot = m_boot;
+        if (m_rebootEvery > 0.0) {
+            boot = std::floor((now - m_rebootOffset) / m_rebootEvery) * m_rebootEvery + m_rebootOffset;
+        }
+
+        Counters c;
+        c.uptime = now - boot;
+        const double total = c.uptime * kHz * m_cpus;
+        c.cpuTotal = uint64_t(total);
+        c.cpuIdle = uint64_t(total - std::fmin(total, m_busy.integral(boot, now) * kHz * m_cpus));
+        c.memTotalKb = m_memTotalKb;
+        const double used = std::fmin(0.95, std::fmax(0.05, m_memory.at(now)));
+        c.memAvailableKb = uint64_t(m_memTotalKb * (1.0 - used));
+        c.netRx = uint64_t(m_rx.integral(boot, now));
+        c.netTx = uint64_t(m_tx.integral(boot, now));
+        c.sectorsRead = uint64_t(m_read.integral(boot, now));
+        c.sectorsWritten = uint64_t(m_write.integral(boot, now));
+        c.fsBlocks = 25u << 20;
+        c.fsAvailable = uint64_t(c.fsBlocks * (1.0 - std::fmin(0.98, m_fsUsed + c.uptime / 86400.0 * 0.001)));
+        return c;
+    }
+
+private:
+    uint64_t m_seed;
+    double m_rebootEvery;
+    int m_cpus;
+    uint64_t m_memTotalKb;
+    Wave m_busy;
+    Wave m_memory;
+    Wave m_rx;
+    Wave m_tx;
+    Wave m_read;
+    Wave m_write;
+    double m_fsUsed;
+    double m_boot;
+    double m_rebootOffset;
+
+    // The index-th stable value in [0, 1) for this host (splitmix64)
+    double fraction(uint64_t index) const
+    {
+        uint64_t z = m_seed + index * 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return double((z ^ (z >> 31)) >> 11) / 9007199254740992.0;
+    }
+};
+
+class FakeHost
+{
+public:
+    FakeHost(const std::string &name, const Options &options)
+        : m_name(name)
+        , m_options(options)
+        , m_model(name, options.rebootEvery)
+        , m_rng(std::random_device()() ^ uint32_t(::getpid()))
+    {
+    }
+
+    int run(const std::string &command)
+    {
+        if (command.find("echo 'connected'") != std::string::npos) {
+            delay();
+            if (chance(m_options.failRate)) {
+                std::fprintf(stderr, "ssh: connect to host %s port 22: Connection refused\n", m_name.c_str());
+                return 255;
+            }
+            std::puts("connected");
+            return 0;
+        }
+        if (command.rfind("uname -sm", 0) == 0) {
+            if (!answerable()) return 255;
+            struct utsname system;
+            ::uname(&system);
+            std::printf("Linux %s\n", system.machine);
+            if (!chance(m_options.agentMissing)) std::puts("present");
+            return 0;
+        }
+        if (command.rfind("mkdir -p", 0) == 0) {
+            char buffer[65536];
+            while (::read(STDIN_FILENO, buffer, sizeof(buffer)) > 0) {}
+            if (!answerable()) return 255;
+            std::puts("installed");
+            return 0;
+        }
+        if (command.rfind("exec ", 0) == 0 && command.find("ac-agent-") != std::string::npos) {
+            return serveAgent();
+        }
+        if (command.find("while read -r _") != std::string::npos) {
+            return serveShell();
+        }
+        if (command.find("@@sample") != std::string::npos) {
+            if (!answerable()) return 255;
+            std::string frame;
+            textFrame(frame);
+            std::fputs(frame.c_str(), stdout);
+            return 0;
+        }
+
+        std::fprintf(stderr, "sh: command not supported by ac-fakehost\n");
+        return 127;
+    }
+
+private:
+    std::string m_name;
+    Options m_options;
+    HostModel m_model;
+    std::mt19937 m_rng;
+
+    bool chance(double p) { return p > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(m_rng) < p; }
+
+    void delay()
+    {
+        const double spread = std::uniform_real_distribution<double>(-1.0, 1.0)(m_rng) * m_options.jitterMs;
+        const double ms = std::fmax(0.0, m_options.latencyMs + spread);
+        std::this_thread::sleep_for(std::chrono::microseconds(int64_t(ms * 1000.0)));
+    }
+
+    // Waits out the latency; false when the session drops instead
+    bool answerable()
+    {
+        delay();
+        if (!chance(m_options.dropRate)) return true;
+        std::fprintf(stderr, "Connection to %s closed by remote host.\n", m_name.c_str());
+        return false;
+    }
+
+    static double now()
+    {
+        using namespace std::chrono;
+        return duration<double>(system_clock::now().time_since_epoch()).count();
+    }
+
+    static bool writeAll(const char *data, size_t size)
+    {
+        while (size > 0) {
+            const ssize_t n = ::write(STDOUT_FILENO, data, size);
+            if (n <= 0) return false;
+            data += n;
+            size -= size_t(n);
+        }
+        return true;
+    }
+
+    void textFrame(std::string &out) const
+    {
+        const Counters c = m_model.sample(now());
+        const uint64_t busy = c.cpuTotal - c.cpuIdle;
+        char text[1024];
+        std::snprintf(text, sizeof(text),
+                      "@@sample\n"
+                      "@uptime\n%.2f %.2f\n"
+                      "@stat\ncpu  %llu %llu %llu %llu %llu 0 %llu 0 0 0\n"
+                      "@meminfo\nMemTotal: %llu\nMemAvailable: %llu\n"
+                      "@netdev\nInter-|   Receive\n face |bytes\n"
+                      "    lo: 1000 10 0 0 0 0 0 0 1000 10 0 0 0 0 0 0\n"
+                      "  eth0: %llu 0 0 0 0 0 0 0 %llu 0 0 0 0 0 0 0\n"
+                      "@diskstats\n   8       0 sda 0 0 %llu 0 0 0 %llu 0 0 0 0\n"
+                      "@statfs\n%llu %llu %llu 4096\n"
+                      "@@end\n",
+                      c.uptime, c.uptime * 0.5,
+                      (unsigned long long)(busy * 7 / 10), (unsigned long long)(busy / 20),
+                      (unsigned long long)(busy * 2 / 10), (unsigned long long)(c.cpuIdle * 95 / 100),
+                      (unsigned long long)(c.cpuIdle - c.cpuIdle * 95 / 100),
+                      (unsigned long long)(busy - busy * 7 / 10 - busy / 20 - busy * 2 / 10),
+                      (unsigned long long)c.memTotalKb, (unsigned long long)c.memAvailableKb,
+                      (unsigned long long)c.netRx, (unsigned long long)c.netTx,
+                      (unsigned long long)c.sectorsRead, (unsigned long long)c.sectorsWritten,
+                      (unsigned long long)c.fsBlocks, (unsigned long long)c.fsAvailable,
+                      (unsigned long long)c.fsAvailable);
+        out = text;
+    }
+
+    void agentFrame(std::string &out) const
+    {
+        const Counters c = m_model.sample(now());
+        AgentSample sample;
+        sample.set(AgentUptimeMs, uint64_t(c.uptime * 1000.0));
+        sample.set(AgentCpuTotal, c.cpuTotal);
+        sample.set(AgentCpuIdle, c.cpuIdle);
+        sample.set(AgentMemTotalKb, c.memTotalKb);
+        sample.set(AgentMemAvailableKb, c.memAvailableKb);
+        sample.set(AgentNetRxBytes, c.netRx);
+        sample.set(AgentNetTxBytes, c.netTx);
+        sample.set(AgentDiskReadSectors, c.sectorsRead);
+        sample.set(AgentDiskWrittenSectors, c.sectorsWritten);
+        sample.set(AgentFsUsedBytes, (c.fsBlocks - c.fsAvailable) * 4096);
+        sample.set(AgentFsAvailableBytes, c.fsAvailable * 4096);
+        out.clear();
+        agentEncode(sample, out);
+    }
+
+    // One answer per newline on stdin, until stdin closes or the session
+    // drops
+    template <typename Frame>
+    int serve(Frame frame)
+    {
+        std::string out;
+        char requests[64];
+        for (;;) {
+            const ssize_t n = ::read(STDIN_FILENO, requests, sizeof(requests));
+            if (n <= 0) return 0;
+            for (ssize_t i = 0; i < n; ++i) {
+                if (requests[i] != '\n') continue;
+                if (!answerable()) return 255;
+                frame(out);
+                if (!writeAll(out.data(), out.size())) return 1;
+            }
+        }
+    }
+
+    int serveAgent()
+    {
+        if (!writeAll(kAgentMagic, kAgentMagicSize)) return 1;
+        return serve([this](std::string &out) { agentFrame(out); });
+    }
+
+    int serveShell()
+    {
+        return serve([this](std::string &out) { textFrame(out); });
+    }
+};
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    int i = 1;
+    for (; i + 1 < argc && std::strncmp(argv[i], "--", 2) == 0; i += 2) {
+        const double value = std::atof(argv[i + 1]);
+        if (std::strcmp(argv[i], "--latency") == 0) {
+            options.latencyMs = value;
+        } else if (std::strcmp(argv[i], "--jitter") == 0) {
+            options.jitterMs = value;
+        } else if (std::strcmp(argv[i], "--fail-rate") == 0) {
+            options.failRate = value;
+        } else if (std::strcmp(argv[i], "--drop-rate") == 0) {
+            options.dropRate = value;
+        } else if (std::strcmp(argv[i], "--reboot-every") == 0) {
+            options.rebootEvery = value;
+        } else if (std::strcmp(argv[i], "--agent-missing") == 0) {
+            options.agentMissing = value;
+        } else {
+            std::fprintf(stderr, "ac-fakehost: unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (argc - i != 2) {
+        std::fprintf(stderr, "usage: ac-fakehost [options] HOST COMMAND\n");
+        return 2;
+    }
+
+    FakeHost host(argv[i], options);
+    const int status = host.run(argv[i + 1]);
+    std::fflush(stdout);
+    return status;
+}
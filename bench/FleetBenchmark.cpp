@@ -0,0 +1,312 @@
+// Remote monitoring at fleet scale.
+//
+// Runs ServerManager against simulated hosts: every worker talks to
+// ac-fakehost instead of ssh, one local process per command or stream, so
+// the process, pipe and event-loop costs are the real ones while the
+// hosts' answers come with configurable latency, jitter, failures and
+// counter resets. Each fleet size is connected with connectAll() and then
+// polled for a fixed time, measuring:
+//
+//   connect ms    connectAll() until every server connected or failed
+//   samples/s     stats updates that reached the server list model
+//   latency       PollScheduler's poll dispatch to the sample being applied
+//   UI CPU        CPU time of the main thread over wall time
+//   lag           how late a 10 ms timer on the main thread fires
+//   RSS, threads  of the whole process at the end of the run
+//
+// Servers are written straight into a private settings file, so the
+// application's own server list is never touched.
+
+#include "DDSketch.h"
+#include "PollScheduler.h"
+#include "ServerManager.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QSettings>
+#include <QTextStream>
+#include <QTimer>
+#include <ctime>
+#include <sys/resource.h>
+
+namespace {
+constexpr int kProbeIntervalMs = 10;
+constexpr int kConnectDeadlineMs = 10 * 60 * 1000;
+constexpr int kSettleMs = 1000;
+
+struct FleetOptions {
+    int intervalSeconds = 5;
+    int durationSeconds = 30;
+    bool streaming = true;
+    bool agent = true;
+    int maxConnects = 32;
+    int maxPolls = 32;
+    QStringList fakeHostOptions;
+};
+
+struct RunResult {
+    int servers = 0;
+    qint64 connectMs = 0;
+    int connectFailures = 0;
+    double samplesPerSecond = 0.0;
+    double latencyP50 = 0.0;
+    double latencyP99 = 0.0;
+    double uiCpuPercent = 0.0;
+    double lagP99 = 0.0;
+    double lagMax = 0.0;
+    qint64 rssKb = 0;
+    qint64 peakRssKb = 0;
+    int threads = 0;
+};
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// Measures how late the main thread's event loop serves a timer
+class LoopProbe
+{
+public:
+    LoopProbe()
+    {
+        m_timer.setTimerType(Qt::PreciseTimer);
+        QObject::connect(&m_timer, &QTimer::timeout, [this]() {
+            const double lag = qMax(0.0, m_clock.nsecsElapsed() / 1e6 - kProbeIntervalMs);
+            m_lag.add(lag);
+            m_max = qMax(m_max, lag);
+            m_clock.start();
+        });
+        reset();
+        m_timer.start(kProbeIntervalMs);
+    }
+
+    void reset()
+    {
+        m_lag.clear();
+        m_max = 0.0;
+        m_clock.start();
+    }
+    double quantile(double q) const { return m_lag.quantile(q); }
+    double max() const { return m_max; }
+
+private:
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    DDSketch m_lag;
+    double m_max = 0.0;
+};
+
+double threadCpuMs()
+{
+    timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+qint64 statusValue(const char *key)
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        if (line.startsWith(key)) return line.mid(qstrlen(key)).trimmed().split(' ').value(0).toLongLong();
+    }
+    return 0;
+}
+
+// Peak RSS since the last reset; writing 5 to clear_refs resets VmHWM
+void resetPeakRss()
+{
+    QFile file("/proc/self/clear_refs");
+    if (file.open(QIODevice::WriteOnly)) file.write("5\n");
+}
+
+// Every streaming server holds a process with three pipes
+void raiseFileLimit()
+{
+    rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0) return;
+    limit.rlim_cur = limit.rlim_max;
+    ::setrlimit(RLIMIT_NOFILE, &limit);
+    out() << "Open file limit: " << qint64(limit.rlim_cur) << "\n";
+}
+
+void writeFleet(int count, const FleetOptions &options)
+{
+    QSettings settings("AlisaCorp", "SystemMonitor");
+    settings.clear();
+    settings.setValue("streamingMode", options.streaming);
+    settings.setValue("agentMode", options.agent);
+    settings.setValue("maxConcurrentConnects", options.maxConnects);
+    settings.setValue("maxConcurrentPolls", options.maxPolls);
+
+    settings.beginWriteArray("servers", count);
+    for (int i = 0; i < count; ++i) {
+        const QString name = QString("sim-%1").arg(i);
+        settings.setArrayIndex(i);
+        settings.setValue("id", name);
+        settings.setValue("name", name);
+        settings.setValue("host", name);
+        settings.setValue("port", 22);
+        settings.setValue("username", "bench");
+        settings.setValue("tags", QStringList{"bench", QString("group-%1").arg(i % 10)});
+        settings.setValue("pollInterval", options.intervalSeconds);
+    }
+    settings.endArray();
+}
+
+RunResult runFleet(int count, const FleetOptions &options)
+{
+    RunResult result;
+    result.servers = count;
+    writeFleet(count, options);
+    resetPeakRss();
+
+    ServerManager manager;
+    manager.setFakeHosts(options.fakeHostOptions);
+    LoopProbe probe;
+
+    QEventLoop loop;
+    QObject::connect(&manager, &ServerManager::connectAllChanged, &loop, [&]() {
+        if (!manager.connectingAll()) loop.quit();
+    });
+    QTimer::singleShot(kConnectDeadlineMs, &loop, &QEventLoop::quit);
+    manager.connectAll();
+    if (manager.connectingAll()) loop.exec();
+    result.connectMs = manager.connectAllMs();
+    result.connectFailures = manager.connectAllFailures();
+
+    qint64 samples = 0;
+    QObject::connect(&manager, &ServerManager::serverStatsUpdated, &loop, [&samples]() { ++samples; });
+
+    manager.pollScheduler()->resetLatency();
+    probe.reset();
+    const double cpuStart = threadCpuMs();
+    QElapsedTimer wall;
+    wall.start();
+    QTimer::singleShot(options.durationSeconds * 1000, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    const double seconds = qMax<qint64>(wall.elapsed(), 1) / 1000.0;
+    result.samplesPerSecond = samples / seconds;
+    result.latencyP50 = manager.pollScheduler()->latency().quantile(0.5);
+    result.latencyP99 = manager.pollScheduler()->latency().quantile(0.99);
+    result.uiCpuPercent = 100.0 * (threadCpuMs() - cpuStart) / (seconds * 1000.0);
+    result.lagP99 = probe.quantile(0.99);
+    result.lagMax = probe.max();
+    result.rssKb = statusValue("VmRSS:");
+    result.peakRssKb = statusValue("VmHWM:");
+    result.threads = int(statusValue("Threads:"));
+    return result;
+}
+
+void printResults(const QList<RunResult> &results)
+{
+    out() << "\n"
+          << qSetFieldWidth(12) << Qt::right
+          << "servers" << "connect ms" << "failed" << "samples/s" << "p50 ms" << "p99 ms"
+          << "UI CPU %" << "lag p99" << "lag max" << "RSS MB" << "peak MB" << "threads"
+          << qSetFieldWidth(0) << "\n";
+
+    for (const RunResult &r : results) {
+        out() << qSetFieldWidth(12)
+              << r.servers
+              << r.connectMs
+              << r.connectFailures
+              << QString::number(r.samplesPerSecond, 'f', 1)
+              << QString::number(r.latencyP50, 'f', 1)
+              << QString::number(r.latencyP99, 'f', 1)
+              << QString::number(r.uiCpuPercent, 'f', 1)
+              << QString::number(r.lagP99, 'f', 1)
+              << QString::number(r.lagMax, 'f', 1)
+              << QString::number(r.rssKb / 1024.0, 'f', 1)
+              << QString::number(r.peakRssKb / 1024.0, 'f', 1)
+              << r.threads
+              << qSetFieldWidth(0) << "\n";
+    }
+    out().flush();
+}
+
+void settle()
+{
+    // Lets the released workers and their processes go away
+    QEventLoop loop;
+    QTimer::singleShot(kSettleMs, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ac-fleet-bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Remote monitoring at fleet scale against simulated hosts");
+    parser.addHelpOption();
+    parser.addOption({"servers", "Comma-separated fleet sizes.", "list", "1,100,1000,5000"});
+    parser.addOption({"duration", "Seconds of polling per fleet size.", "s", "30"});
+    parser.addOption({"interval", "Poll interval of every server in seconds.", "s", "5"});
+    parser.addOption({"latency", "Simulated host latency in ms.", "ms", "20"});
+    parser.addOption({"jitter", "Uniform spread of the latency in ms.", "ms", "10"});
+    parser.addOption({"fail-rate", "Share of connection attempts refused.", "p", "0"});
+    parser.addOption({"drop-rate", "Share of answers lost with the session.", "p", "0"});
+    parser.addOption({"reboot-every", "Simulated hosts reboot every S seconds (0: never).", "s", "0"});
+    parser.addOption({"agent-missing", "Share of agent checks that find no ac-agent, so it is uploaded.", "p", "0"});
+    parser.addOption({"max-connects", "Concurrent connection attempts.", "n", "32"});
+    parser.addOption({"max-polls", "Concurrent polls.", "n", "32"});
+    parser.addOption({"no-stream", "Poll with one process per sample instead of streaming."});
+    parser.addOption({"no-agent", "Stream from the shell sampler instead of ac-agent."});
+    parser.addOption({{"v", "verbose"}, "Log worker activity to stderr."});
+    parser.process(app);
+
+    if (!parser.isSet("verbose")) {
+        QLoggingCategory::setFilterRules("*.debug=false");
+    }
+
+    const QString fakeHost = QCoreApplication::applicationDirPath() + "/ac-fakehost";
+    if (!QFile::exists(fakeHost)) {
+        out() << fakeHost << " not found; build the ac-fakehost target\n";
+        return 1;
+    }
+
+    // Keeps the simulated fleet out of the application's settings
+    const QString settingsDir = QDir::tempPath() + "/ac-fleet-bench";
+    QDir().mkpath(settingsDir);
+    QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, settingsDir);
+
+    FleetOptions options;
+    options.intervalSeconds = qMax(1, parser.value("interval").toInt());
+    options.durationSeconds = qMax(1, parser.value("duration").toInt());
+    options.streaming = !parser.isSet("no-stream");
+    options.agent = !parser.isSet("no-agent");
+    options.maxConnects = qMax(1, parser.value("max-connects").toInt());
+    options.maxPolls = qMax(1, parser.value("max-polls").toInt());
+    for (const char *name : {"latency", "jitter", "fail-rate", "drop-rate", "reboot-every", "agent-missing"}) {
+        options.fakeHostOptions << QString("--") + name << parser.value(name);
+    }
+
+    raiseFileLimit();
+    out() << "Hosts: " << options.fakeHostOptions.join(' ')
+          << (options.streaming ? (options.agent ? ", agent stream" : ", shell stream") : ", polling")
+          << ", every " << options.intervalSeconds << " s for " << options.durationSeconds << " s\n";
+    out().flush();
+
+    QList<RunResult> results;
+    for (const QString &size : parser.value("servers").split(',', Qt::SkipEmptyParts)) {
+        const int count = qMax(1, size.trimmed().toInt());
+        out() << "Running " << count << " servers\n";
+        out().flush();
+        results.append(runFleet(count, options));
+        settle();
+    }
+
+    printResults(results);
+    QDir(settingsDir).removeRecursively();
+    return 0;
+}
@@ -0,0 +1,374 @@
+// Scanner throughput benchmark.
+//
+// Builds a deterministic synthetic tree (source trees, node_modules, build
+// output) and runs ScanWorker over it with a cold page cache, a warm page
+// cache and a warm rescan that reuses the scan index. Cold and warm runs are
+// repeated for each stat backend (synchronous and io_uring). The same
+// parameters always produce the same tree, so numbers from different
+// scanner changes can be compared directly.
+
+#include "DiskAnalyzer.h"
+#include "ScanIndex.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr char kTreeMarker[] = ".ac-bench-tree";
+
+struct TreeShape {
+    int projects = 20;
+    int fanout = 4;
+    int depth = 4;
+    qint64 files = 200000;
+    quint64 seed = 1;
+
+    QString key() const
+    {
+        return QString("projects=%1 fanout=%2 depth=%3 files=%4 seed=%5")
+            .arg(projects).arg(fanout).arg(depth).arg(files).arg(seed);
+    }
+};
+
+struct RunResult {
+    QString name;
+    bool skipped = false;
+    QString note;
+    qint64 dirs = 0;
+    qint64 files = 0;
+    qint64 targets = 0;
+    qint64 elapsedMs = 0;
+    qint64 firstResultMs = -1;
+    qint64 peakRssKb = 0;
+};
+
+// xorshift64*, fixed so trees do not change with the standard library
+class Rng
+{
+public:
+    explicit Rng(quint64 seed) : m_state(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+
+    quint64 next()
+    {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1Dull;
+    }
+    int bounded(int n) { return int(next() % quint64(n)); }
+
+private:
+    quint64 m_state;
+};
+
+struct DirSpec {
+    QString path;
+    const char *extension;
+};
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+void addSourceTree(QList<DirSpec> &dirs, const QString &path, int fanout, int depth)
+{
+    dirs.append({path, ".c"});
+    if (depth == 0) return;
+    for (int i = 0; i < fanout; ++i) {
+        addSourceTree(dirs, path + "/mod" + QString::number(i), fanout, depth - 1);
+    }
+}
+
+// Directory layout of one project: a source tree, a node_modules with many
+// small packages (some nested), and build output
+void addProject(QList<DirSpec> &dirs, const QString &path, const TreeShape &shape, Rng &rng)
+{
+    dirs.append({path, ".txt"});
+    addSourceTree(dirs, path + "/src", shape.fanout, shape.depth);
+
+    const QString modules = path + "/node_modules";
+    dirs.append({modules, ".js"});
+    const int packages = shape.fanout * 25;
+    for (int i = 0; i < packages; ++i) {
+        const QString package = modules + "/pkg-" + QString::number(i);
+        dirs.append({package, ".js"});
+        dirs.append({package + "/lib", ".js"});
+        if (rng.bounded(8) == 0) {
+            dirs.append({package + "/node_modules", ".js"});
+            dirs.append({package + "/node_modules/dep-" + QString::number(i), ".js"});
+        }
+    }
+
+    dirs.append({path + "/build", ".o"});
+    for (int i = 0; i < shape.fanout; ++i) {
+        const QString target = path + "/build/target-" + QString::number(i);
+        dirs.append({target, ".o"});
+        for (int j = 0; j < shape.fanout; ++j) {
+            dirs.append({target + "/obj-" + QString::number(j), ".o"});
+        }
+    }
+}
+
+bool createFile(const QString &path, qint64 size)
+{
+#ifdef Q_OS_UNIX
+    // Sparse files: the scanner only looks at st_size
+    const QByteArray name = QFile::encodeName(path);
+    int fd = ::open(name.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool ok = ::ftruncate(fd, size) == 0;
+    ::close(fd);
+    return ok;
+#else
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.resize(size);
+#endif
+}
+
+// Only a directory this benchmark created, or an empty one, may be deleted
+bool isDisposable(const QString &root)
+{
+    const QDir dir(root);
+    return !dir.exists() || QFile::exists(dir.filePath(kTreeMarker))
+        || dir.isEmpty(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+}
+
+bool buildTree(const QString &root, const TreeShape &shape)
+{
+    QFile marker(root + "/" + kTreeMarker);
+    if (marker.open(QIODevice::ReadOnly) && QString::fromUtf8(marker.readAll()) == shape.key()) {
+        out() << "Reusing tree in " << root << "\n";
+        return true;
+    }
+    marker.close();
+
+    if (!isDisposable(root)) {
+        qWarning() << root << "is not empty and has no" << kTreeMarker << "- refusing to delete it;"
+                   << "pass an empty or new directory as --root";
+        return false;
+    }
+    if (QDir(root).exists()) {
+        out() << "Removing stale tree in " << root << "\n";
+        QDir(root).removeRecursively();
+    }
+
+    // An empty marker first, so an interrupted build can still be replaced
+    if (!QDir().mkpath(root) || !marker.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot create" << root;
+        return false;
+    }
+    marker.close();
+
+    QElapsedTimer timer;
+    timer.start();
+    Rng rng(shape.seed);
+
+    QList<DirSpec> dirs;
+    for (int i = 0; i < shape.projects; ++i) {
+        addProject(dirs, root + "/project-" + QString::number(i), shape, rng);
+    }
+    for (const DirSpec &dir : std::as_const(dirs)) {
+        if (!QDir().mkpath(dir.path)) {
+            qWarning() << "Cannot create" << dir.path;
+            return false;
+        }
+    }
+
+    // Mostly small files with a long tail, roughly like real checkouts
+    for (qint64 i = 0; i < shape.files; ++i) {
+        const DirSpec &dir = dirs.at(rng.bounded(int(dirs.size())));
+        const qint64 size = qint64(1) << (8 + rng.bounded(rng.bounded(16) == 0 ? 20 : 8));
+        if (!createFile(dir.path + "/f" + QString::number(i) + dir.extension, size)) {
+            qWarning() << "Cannot create files in" << dir.path;
+            return false;
+        }
+        if ((i + 1) % 100000 == 0) {
+            out() << "  " << (i + 1) << " files\n";
+            out().flush();
+        }
+    }
+
+    if (!marker.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    marker.write(shape.key().toUtf8());
+
+    out() << "Built " << dirs.size() << " directories and " << shape.files << " files in "
+          << timer.elapsed() << " ms\n";
+    return true;
+}
+
+bool dropCaches()
+{
+#ifdef Q_OS_LINUX
+    ::sync();
+    QFile file("/proc/sys/vm/drop_caches");
+    return file.open(QIODevice::WriteOnly) && file.write("3\n") == 2;
+#else
+    return false;
+#endif
+}
+
+// Peak RSS since the last reset; writing 5 to clear_refs resets VmHWM
+void resetPeakRss()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/clear_refs");
+    if (file.open(QIODevice::WriteOnly)) file.write("5\n");
+#endif
+}
+
+qint64 peakRssKb()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        if (line.startsWith("VmHWM:")) return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+    }
+#endif
+    return 0;
+}
+
+RunResult runScan(const QString &name, const QString &root, bool buildUsageTree, bool keepIndex,
+                  DirectoryLister::Backend backend)
+{
+    RunResult result;
+    result.name = name;
+
+    if (!keepIndex) QFile::remove(ScanIndex::indexPathFor(root));
+
+    ScanWorker worker;
+    worker.setScanPath(root);
+    worker.setBuildUsageTree(buildUsageTree);
+    worker.setIoBackend(backend);
+
+    QElapsedTimer timer;
+    QObject::connect(&worker, &ScanWorker::targetsFound, [&](const QList<CleanupTarget> &targets) {
+        if (result.firstResultMs < 0 && !targets.isEmpty()) result.firstResultMs = timer.elapsed();
+        result.targets += targets.size();
+    });
+    QObject::connect(&worker, &ScanWorker::scanStats, [&](qint64 dirs, qint64 files, qint64, qint64) {
+        result.dirs = dirs;
+        result.files = files;
+    });
+
+    resetPeakRss();
+    timer.start();
+    // Same thread, so the signals above are delivered synchronously
+    worker.doScan();
+    result.elapsedMs = timer.elapsed();
+    result.peakRssKb = peakRssKb();
+    return result;
+}
+
+void printResults(const QList<RunResult> &results)
+{
+    out() << "\n"
+          << qSetFieldWidth(16) << Qt::left << "run" << Qt::right
+          << "dirs/s" << "files/s" << "total ms" << "first ms" << "peak RSS MB" << "targets"
+          << qSetFieldWidth(0) << "\n";
+
+    for (const RunResult &r : results) {
+        out() << qSetFieldWidth(16) << Qt::left << r.name << Qt::right;
+        if (r.skipped) {
+            out() << qSetFieldWidth(0) << r.note << "\n";
+            continue;
+        }
+        const double seconds = qMax<qint64>(r.elapsedMs, 1) / 1000.0;
+        out() << QString::number(r.dirs / seconds, 'f', 0)
+              << QString::number(r.files / seconds, 'f', 0)
+              << r.elapsedMs
+              << (r.firstResultMs >= 0 ? QString::number(r.firstResultMs) : QString("-"))
+              << QString::number(r.peakRssKb / 1024.0, 'f', 1)
+              << r.targets
+              << qSetFieldWidth(0) << "\n";
+    }
+    out().flush();
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // Keeps the benchmark's scan indexes apart from the application's
+    QCoreApplication::setApplicationName("ac-scan-bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Scanner throughput on a deterministic synthetic tree");
+    parser.addHelpOption();
+    parser.addOption({"root", "Directory for the synthetic tree.", "path",
+                      QDir::tempPath() + "/ac-scan-bench"});
+    parser.addOption({"projects", "Number of projects.", "n", "20"});
+    parser.addOption({"fanout", "Subdirectories per source directory.", "n", "4"});
+    parser.addOption({"depth", "Depth of each source tree.", "n", "4"});
+    parser.addOption({"files", "Total number of files.", "n", "200000"});
+    parser.addOption({"seed", "Seed for the tree layout.", "n", "1"});
+    parser.addOption({"backend", "Stat backend: sync, io_uring or both.", "name", "both"});
+    parser.addOption({"no-tree", "Do not build the full usage tree while scanning."});
+    parser.addOption({"cleanup", "Remove the synthetic tree afterwards."});
+    parser.process(app);
+
+    TreeShape shape;
+    shape.projects = qMax(1, parser.value("projects").toInt());
+    shape.fanout = qMax(1, parser.value("fanout").toInt());
+    shape.depth = qMax(0, parser.value("depth").toInt());
+    shape.files = qMax<qint64>(0, parser.value("files").toLongLong());
+    shape.seed = parser.value("seed").toULongLong();
+
+    const QString root = QDir(parser.value("root")).absolutePath();
+    const bool buildUsageTree = !parser.isSet("no-tree");
+
+    out() << "Tree: " << shape.key() << "\n";
+    out().flush();
+    if (!buildTree(root, shape)) return 1;
+
+    QList<DirectoryLister::Backend> backends;
+    const QString backendOption = parser.value("backend");
+    if (backendOption != "io_uring") backends.append(DirectoryLister::Sync);
+    if (backendOption != "sync") {
+        if (DirectoryLister::isIoUringSupported()) {
+            backends.append(DirectoryLister::IoUring);
+        } else {
+            out() << "io_uring is not available here, skipping its runs\n";
+        }
+    }
+    if (backends.isEmpty()) return 1;
+
+    QList<RunResult> results;
+    for (DirectoryLister::Backend backend : std::as_const(backends)) {
+        const QString suffix = "/" + DirectoryLister::backendName(backend);
+        if (dropCaches()) {
+            results.append(runScan("cold" + suffix, root, buildUsageTree, false, backend));
+        } else {
+            RunResult skipped;
+            skipped.name = "cold" + suffix;
+            skipped.skipped = true;
+            skipped.note = "skipped (dropping the page cache needs root)";
+            results.append(skipped);
+        }
+        results.append(runScan("warm" + suffix, root, buildUsageTree, false, backend));
+    }
+    // The last warm run left the index this one reuses
+    results.append(runScan("warm+index", root, buildUsageTree, true, backends.last()));
+    QFile::remove(ScanIndex::indexPathFor(root));
+
+    printResults(results);
+
+    if (parser.isSet("cleanup")) {
+        if (QFile::exists(root + "/" + kTreeMarker)) {
+            QDir(root).removeRecursively();
+        } else {
+            qWarning() << "Not removing" << root << "- it has no" << kTreeMarker;
+        }
+    }
+    return 0;
+}
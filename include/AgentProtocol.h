@@ -0,0 +1,111 @@
+#ifndef AGENTPROTOCOL_H
+#define AGENTPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Wire format of ac-agent, the remote collector. Plain C++ so the agent
+// can be linked statically without Qt.
+//
+// The agent writes kAgentMagic once, then one frame per sample request (a
+// newline on its stdin):
+//   varint(payload length)
+//   payload: varint(field mask), then varint(value) for each set bit in
+//            AgentField order
+// Values are raw counters and amounts; rates are computed by the reader.
+// Unknown mask bits from a newer agent are skipped by length.
+
+constexpr char kAgentMagic[] = "ACAGENT1\n";
+constexpr size_t kAgentMagicSize = sizeof(kAgentMagic) - 1;
+constexpr size_t kAgentMaxFrame = 1024;
+
+enum AgentField {
+    AgentUptimeMs,       // CLOCK_MONOTONIC on the host
+    AgentCpuTotal,       // jiffies over all states
+    AgentCpuIdle,        // idle + iowait
+    AgentMemTotalKb,
+    AgentMemAvailableKb,
+    AgentNetRxBytes,     // all interfaces but loopback
+    AgentNetTxBytes,
+    AgentDiskReadSectors, // whole disks, 512-byte sectors
+    AgentDiskWrittenSectors,
+    AgentFsUsedBytes,    // statvfs of /
+    AgentFsAvailableBytes,
+    AgentFieldCount
+};
+
+struct AgentSample {
+    uint32_t mask = 0;
+    uint64_t values[AgentFieldCount] = {};
+
+    void set(AgentField field, uint64_t value)
+    {
+        mask |= 1u << field;
+        values[field] = value;
+    }
+    bool has(AgentField field) const { return mask & (1u << field); }
+};
+
+inline void agentPutVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(char(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+// Bytes consumed, or 0 when the buffer ends inside the varint or it is
+// longer than 64 bits
+inline size_t agentGetVarint(const unsigned char *data, size_t size, uint64_t &value)
+{
+    value = 0;
+    for (size_t i = 0; i < size && i < 10; ++i) {
+        value |= uint64_t(data[i] & 0x7f) << (7 * i);
+        if (!(data[i] & 0x80)) return i + 1;
+    }
+    return 0;
+}
+
+inline void agentEncode(const AgentSample &sample, std::string &out)
+{
+    std::string payload;
+    agentPutVarint(payload, sample.mask);
+    for (int field = 0; field < AgentFieldCount; ++field) {
+        if (sample.has(AgentField(field))) agentPutVarint(payload, sample.values[field]);
+    }
+    agentPutVarint(out, payload.size());
+    out += payload;
+}
+
+// Bytes consumed by one frame; 0 if more data is needed, -1 if the stream
+// is corrupt
+inline long agentDecode(const unsigned char *data, size_t size, AgentSample &sample)
+{
+    uint64_t length = 0;
+    const size_t header = agentGetVarint(data, size, length);
+    if (header == 0) return size >= 10 ? -1 : 0;
+    if (length > kAgentMaxFrame) return -1;
+    if (size - header < length) return 0;
+
+    const unsigned char *p = data + header;
+    const unsigned char *end = p + length;
+    uint64_t mask = 0;
+    size_t n = agentGetVarint(p, end - p, mask);
+    if (n == 0) return -1;
+    p += n;
+
+    sample = AgentSample();
+    for (int field = 0; field < 32 && p < end; ++field) {
+        if (!(mask & (uint64_t(1) << field))) continue;
+        uint64_t value = 0;
+        n = agentGetVarint(p, end - p, value);
+        if (n == 0) return -1;
+        p += n;
+        if (field < AgentFieldCount) sample.set(AgentField(field), value);
+    }
+    return long(header + length);
+}
+
+#endif // AGENTPROTOCOL_H
@@ -0,0 +1,62 @@
+#ifndef CLEANUPRULES_H
+#define CLEANUPRULES_H
+
+#include <QHash>
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+struct CleanupRule {
+    QString type;
+    QString reason;
+    QStringList names;        // glob patterns matched against the directory name
+    QStringList markers;      // any must exist, relative to the directory ("../Cargo.toml")
+    qint64 minSize = 1024 * 1024;
+    int minAgeDays = 0;
+};
+
+// Compiled set of cleanup rules.
+//
+// Rules come from cleanup-rules.json in the app config directory and are
+// checked before the built-in ones. Name patterns are split by shape so a
+// directory name costs a few hash lookups regardless of the number of rules:
+// literal names go into one hash, "prefix*" and "*suffix" patterns into
+// hashes keyed by their fixed part, and the remaining globs into a single
+// combined regular expression that is only used as a prefilter.
+class CleanupRules
+{
+public:
+    CleanupRules();
+
+    static CleanupRules load();
+    static QString configPath();
+    static QList<CleanupRule> defaultRules();
+
+    bool loadFromFile(const QString &path, QString *error = nullptr);
+    void setRules(const QList<CleanupRule> &rules);
+
+    int ruleCount() const { return m_rules.size(); }
+    const CleanupRule &rule(int index) const { return m_rules.at(index); }
+
+    // Index of the first rule accepting the directory, or -1. Markers and
+    // age are only checked for rules whose name pattern matched.
+    int match(const QString &dirName, const QString &dirPath) const;
+
+private:
+    QList<CleanupRule> m_rules;
+
+    QHash<QString, QList<int>> m_exact;
+    QHash<QString, QList<int>> m_prefixes;
+    QHash<QString, QList<int>> m_suffixes;
+    QList<int> m_prefixLengths;
+    QList<int> m_suffixLengths;
+
+    QRegularExpression m_combinedGlobs;
+    QList<QPair<QRegularExpression, int>> m_globs;
+
+    void compile();
+    bool accepts(const CleanupRule &rule, const QString &dirPath) const;
+};
+
+#endif // CLEANUPRULES_H
@@ -0,0 +1,190 @@
+#ifndef CLEANUPTARGETMODEL_H
+#define CLEANUPTARGETMODEL_H
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QSortFilterProxyModel>
+#include <QStringList>
+
+struct CleanupTarget {
+    QString path;
+    QString type;
+    qint64 size = 0;
+    QDateTime lastModified;
+    bool isSafe = false;
+    QString reason;
+};
+
+Q_DECLARE_METATYPE(CleanupTarget)
+
+// List model fed incrementally by ScanWorker batches while a scan runs.
+//
+// Rows keep native fields (size, epoch milliseconds, interned type id) and
+// stay in arrival order; sorting and filtering happen in
+// CleanupTargetProxyModel. A path -> row hash makes lookups O(1), and a
+// removed row is replaced by the last one so nothing has to shift.
+class CleanupTargetModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(qint64 totalSize READ totalSize NOTIFY totalSizeChanged)
+    Q_PROPERTY(int selectedCount READ selectedCount NOTIFY selectionChanged)
+    Q_PROPERTY(qint64 selectedSize READ selectedSize NOTIFY selectionChanged)
+    Q_PROPERTY(QStringList types READ types NOTIFY typesChanged)
+
+public:
+    enum Roles {
+        PathRole = Qt::UserRole + 1,
+        TypeRole,
+        SizeRole,
+        SizeFormattedRole,
+        LastModifiedRole,
+        IsSafeRole,
+        ReasonRole,
+        SelectedRole,
+        IsDeletingRole
+    };
+    Q_ENUM(Roles)
+
+    explicit CleanupTargetModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_rows.size(); }
+    qint64 totalSize() const { return m_totalSize; }
+    QStringList types() const { return m_typeNames; }
+    CleanupTarget target(int row) const;
+    int rowOf(const QString &path) const { return m_rowOfPath.value(path, -1); }
+
+    // Native field access for the proxy; no QVariant round trips
+    const QString &pathAt(int row) const { return m_rows.at(row).path; }
+    qint64 sizeAt(int row) const { return m_rows.at(row).size; }
+    qint64 lastModifiedAt(int row) const { return m_rows.at(row).lastModifiedMs; }
+    int typeIdAt(int row) const { return m_rows.at(row).typeId; }
+    int typeRankAt(int row) const { return m_typeRanks.at(m_rows.at(row).typeId); }
+    bool isSafeAt(int row) const { return m_rows.at(row).isSafe; }
+    int typeId(const QString &type) const { return m_typeIds.value(type, -1); }
+
+    int selectedCount() const { return m_selectedCount; }
+    qint64 selectedSize() const { return m_selectedSize; }
+    // Largest first, so the biggest wins are freed first
+    QStringList selectedPaths() const;
+    void setSelected(int row, bool selected);
+    Q_INVOKABLE void clearSelection();
+
+    // Rows stay visible while their deletion is queued or running
+    bool isDeleting(const QString &path) const;
+    void setDeleting(const QString &path, bool deleting);
+
+    void appendTargets(const QList<CleanupTarget> &targets);
+    void setTargets(const QList<CleanupTarget> &targets);
+    void updateTargetSizes(const QHash<QString, qint64> &sizes);
+    void removeTarget(int row);
+    void clear();
+
+    static QString formatSize(qint64 bytes);
+
+signals:
+    void countChanged();
+    void totalSizeChanged();
+    void selectionChanged();
+    void typesChanged();
+    // After updateTargetSizes() changed at least one row
+    void sizesUpdated();
+
+private:
+    struct Row {
+        QString path;
+        QString reason;
+        qint64 size = 0;
+        qint64 lastModifiedMs = 0;
+        int typeId = 0;
+        bool isSafe = false;
+        bool selected = false;
+        bool deleting = false;
+    };
+
+    QList<Row> m_rows;
+    QHash<QString, int> m_rowOfPath;
+    qint64 m_totalSize = 0;
+    int m_selectedCount = 0;
+    qint64 m_selectedSize = 0;
+
+    QStringList m_typeNames;
+    QHash<QString, int> m_typeIds;
+    QList<int> m_typeRanks; // collation order of each type id
+
+    Row makeRow(const CleanupTarget &target);
+    int internType(const QString &type);
+};
+
+// Sorted and filtered view of a CleanupTargetModel for QML.
+//
+// Comparisons and filters read the source rows' native fields directly.
+// Live size updates deliberately do not re-sort, so rows do not jump under
+// the cursor; removals and new rows are placed correctly. With a minimum
+// size set, size updates do re-run the filter, so targets appear and
+// disappear as they cross it.
+class CleanupTargetProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(QString sortKey READ sortKey WRITE setSortKey NOTIFY sortChanged)
+    Q_PROPERTY(bool sortAscending READ sortAscending WRITE setSortAscending NOTIFY sortChanged)
+    Q_PROPERTY(QString typeFilter READ typeFilter WRITE setTypeFilter NOTIFY filterChanged)
+    Q_PROPERTY(qint64 minSize READ minSize WRITE setMinSize NOTIFY filterChanged)
+    Q_PROPERTY(bool safeOnly READ safeOnly WRITE setSafeOnly NOTIFY filterChanged)
+    Q_PROPERTY(QString pathFilter READ pathFilter WRITE setPathFilter NOTIFY filterChanged)
+
+public:
+    explicit CleanupTargetProxyModel(CleanupTargetModel *source, QObject *parent = nullptr);
+
+    int count() const { return rowCount(); }
+
+    // key: "size", "date" or "type"
+    QString sortKey() const;
+    void setSortKey(const QString &key);
+    bool sortAscending() const { return m_sortAscending; }
+    void setSortAscending(bool ascending);
+
+    QString typeFilter() const { return m_typeFilter; }
+    void setTypeFilter(const QString &type);
+    qint64 minSize() const { return m_minSize; }
+    void setMinSize(qint64 bytes);
+    bool safeOnly() const { return m_safeOnly; }
+    void setSafeOnly(bool safeOnly);
+    QString pathFilter() const { return m_pathFilter; }
+    void setPathFilter(const QString &text);
+
+signals:
+    void countChanged();
+    void sortChanged();
+    void filterChanged();
+
+protected:
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    enum SortKey { SortBySize, SortByDate, SortByType };
+
+    CleanupTargetModel *m_source;
+    SortKey m_sortKey = SortBySize;
+    bool m_sortAscending = false;
+    QString m_typeFilter;
+    int m_typeFilterId = -1;
+    qint64 m_minSize = 0;
+    bool m_safeOnly = false;
+    QString m_pathFilter;
+
+    void applySort();
+};
+
+#endif // CLEANUPTARGETMODEL_H
@@ -0,0 +1,48 @@
+#ifndef DDSKETCH_H
+#define DDSKETCH_H
+
+#include <QtGlobal>
+#include <vector>
+
+// Quantile sketch with a relative accuracy guarantee (DDSketch): a value x
+// is counted in bucket ceil(log_gamma(x)), gamma = (1 + a) / (1 - a), so
+// every quantile is returned within a relative error of a. Buckets are plain
+// counters, which makes the sketch mergeable and, unlike a t-digest, lets a
+// value be removed again when a server reports a new one.
+//
+// Values at or below kMinValue (idle CPU, an empty link) share one zero
+// bucket. Buckets are kept dense between the lowest and highest index in
+// use: a few hundred counters for percentages at 1 %.
+class DDSketch
+{
+public:
+    static constexpr double kMinValue = 1e-3;
+
+    explicit DDSketch(double relativeAccuracy = 0.01);
+
+    void add(double value);
+    // value must have been added before
+    void remove(double value);
+    void merge(const DDSketch &other);
+    void clear();
+
+    qint64 count() const { return m_count; }
+    // q in [0, 1]; 0 for an empty sketch
+    double quantile(double q) const;
+    double relativeAccuracy() const { return m_accuracy; }
+
+private:
+    double m_accuracy;
+    double m_gamma;
+    double m_logGamma;
+    qint64 m_count = 0;
+    qint64 m_zeroCount = 0;
+    int m_offset = 0;              // bucket index of m_buckets[0]
+    std::vector<qint64> m_buckets;
+
+    int indexOf(double value) const;
+    double valueOf(int index) const;
+    qint64 &bucket(int index);
+};
+
+#endif // DDSKETCH_H
@@ -0,0 +1,72 @@
+#ifndef DELETIONENGINE_H
+#define DELETIONENGINE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+
+// Deletes cleanup targets off the GUI thread.
+//
+// Targets are queued and removed one after another; inside a target,
+// directories are unlinked relative to their parent's descriptor
+// (openat/unlinkat), and subtrees are handed to a small thread pool while it
+// has idle threads. A directory removes itself once its last child is gone,
+// so no second pass over the tree is needed.
+//
+// In trash mode a target is first renamed to a hidden sibling, which is a
+// single rename on the same filesystem, so it disappears from the list at
+// once; the actual unlinking then happens in the background.
+class DeletionEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeletionEngine(QObject *parent = nullptr);
+    ~DeletionEngine();
+
+    // Thread-safe
+    void enqueue(const QStringList &paths, bool useTrash);
+    void cancel();
+
+    static QString trashMarker() { return QStringLiteral(".ac-deleting-"); }
+
+signals:
+    // The target is gone from its original location
+    void targetRemoved(const QString &path);
+    void deletionFailed(const QString &path, const QString &error);
+    void progress(qint64 bytesFreed, qint64 filesRemoved, int queued);
+    void idle(qint64 bytesFreed, qint64 filesRemoved, bool cancelled);
+
+private slots:
+    void processQueue();
+
+private:
+    struct Job {
+        QString path;         // what is actually deleted
+        QString originalPath; // what the user picked
+        bool trashed = false;
+    };
+    struct DirNode;
+
+    QMutex m_mutex;
+    QList<Job> m_queue;
+    bool m_running = false;
+
+    QThreadPool m_pool;
+    std::atomic<bool> m_cancelRequested{false};
+    bool m_sessionCancelled = false;
+    std::atomic<qint64> m_bytesFreed{0};
+    std::atomic<qint64> m_filesRemoved{0};
+    std::atomic<int> m_errors{0};
+    std::atomic<int> m_firstError{0};
+
+    bool removeTree(const QString &path);
+    void processDirectory(DirNode *node);
+    void finishDirectory(DirNode *node);
+    void recordError(int error);
+    void reportProgress();
+};
+
+#endif // DELETIONENGINE_H
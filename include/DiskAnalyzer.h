@@ -5,59 +5,197 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QStorageInfo>
-#include <QVariantList>
-#include <QVariantMap>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QThread>
-#include <QMutex>
+#include <QVariantList>
+#include <atomic>
+#include "CleanupRules.h"
+#include "CleanupTargetModel.h"
+#include "DirectoryLister.h"
+#include "DiskUsageModel.h"
+#include "DuplicateGroupModel.h"
+#include "LargestEntryModel.h"
+#include "DiskUsageTree.h"
+#include "ProcessPathIndex.h"
+#include "ScanThrottle.h"
+#include "ScanIndex.h"
+#include "ScanSnapshot.h"
 
 class ScanWorker;
+class TargetWatcher;
+class DuplicateFinder;
+class DeletionEngine;
 
 class DiskAnalyzer : public QObject
 {
     Q_OBJECT
-    Q_PROPERTY(QVariantList cleanupTargets READ cleanupTargets NOTIFY targetsUpdated)
+    Q_PROPERTY(CleanupTargetModel *cleanupTargets READ cleanupTargets CONSTANT)
+    Q_PROPERTY(CleanupTargetProxyModel *visibleTargets READ visibleTargets CONSTANT)
+    Q_PROPERTY(DiskUsageModel *usageTree READ usageTree CONSTANT)
     Q_PROPERTY(bool isScanning READ isScanning NOTIFY scanningChanged)
     Q_PROPERTY(QString scanProgress READ scanProgress NOTIFY scanProgressChanged)
+    Q_PROPERTY(qint64 scannedDirs READ scannedDirs NOTIFY scanStatsChanged)
+    Q_PROPERTY(qint64 scannedFiles READ scannedFiles NOTIFY scanStatsChanged)
+    Q_PROPERTY(qint64 scannedBytes READ scannedBytes NOTIFY scanStatsChanged)
+    Q_PROPERTY(double bytesPerSecond READ bytesPerSecond NOTIFY scanStatsChanged)
+    Q_PROPERTY(QString cachedScanTime READ cachedScanTime NOTIFY cachedResultsChanged)
+    Q_PROPERTY(bool isRevalidating READ isRevalidating NOTIFY scanningChanged)
+    Q_PROPERTY(bool liveUpdates READ liveUpdates WRITE setLiveUpdates NOTIFY liveUpdatesChanged)
+    Q_PROPERTY(QString liveMode READ liveMode NOTIFY liveUpdatesChanged)
+    Q_PROPERTY(bool politeScan READ politeScan WRITE setPoliteScan NOTIFY politeScanChanged)
+    Q_PROPERTY(bool useTrash READ useTrash WRITE setUseTrash NOTIFY useTrashChanged)
+    Q_PROPERTY(bool isDeleting READ isDeleting NOTIFY deletionProgressChanged)
+    Q_PROPERTY(qint64 deletedBytes READ deletedBytes NOTIFY deletionProgressChanged)
+    Q_PROPERTY(qint64 deletedFiles READ deletedFiles NOTIFY deletionProgressChanged)
+    Q_PROPERTY(int deleteQueueLength READ deleteQueueLength NOTIFY deletionProgressChanged)
+    Q_PROPERTY(DuplicateGroupModel *duplicateGroups READ duplicateGroups CONSTANT)
+    Q_PROPERTY(bool isFindingDuplicates READ isFindingDuplicates NOTIFY duplicateSearchChanged)
+    Q_PROPERTY(QString duplicateProgress READ duplicateProgress NOTIFY duplicateProgressChanged)
+    Q_PROPERTY(LargestEntryModel *largestFiles READ largestFiles CONSTANT)
+    Q_PROPERTY(LargestEntryModel *largestDirectories READ largestDirectories CONSTANT)
+    Q_PROPERTY(QVariantList snapshots READ snapshots NOTIFY snapshotsChanged)
+    Q_PROPERTY(bool isComparing READ isComparing NOTIFY growthChanged)
+    Q_PROPERTY(QVariantList growers READ growers NOTIFY growthChanged)
+    Q_PROPERTY(QVariantList shrinkers READ shrinkers NOTIFY growthChanged)
+    Q_PROPERTY(QString growthSummary READ growthSummary NOTIFY growthChanged)
 
 public:
     explicit DiskAnalyzer(QObject *parent = nullptr);
+    ~DiskAnalyzer();
 
-    QVariantList cleanupTargets() const { return m_cleanupTargets; }
+    CleanupTargetModel *cleanupTargets() const { return m_targetModel; }
+    CleanupTargetProxyModel *visibleTargets() const { return m_visibleTargets; }
+    DiskUsageModel *usageTree() const { return m_usageModel; }
     bool isScanning() const { return m_isScanning; }
     QString scanProgress() const { return m_scanProgress; }
+    qint64 scannedDirs() const { return m_scannedDirs; }
+    qint64 scannedFiles() const { return m_scannedFiles; }
+    qint64 scannedBytes() const { return m_scannedBytes; }
+    double bytesPerSecond() const { return m_bytesPerSecond; }
+    QString cachedScanTime() const { return m_cachedScanTime; }
+    bool isRevalidating() const { return m_isScanning && m_isRevalidating; }
+    bool liveUpdates() const { return m_liveUpdates; }
+    void setLiveUpdates(bool enabled);
+    QString liveMode() const { return m_liveMode; }
+    bool politeScan() const { return m_politeScan; }
+    void setPoliteScan(bool enabled);
+    bool useTrash() const { return m_useTrash; }
+    void setUseTrash(bool enabled);
+    bool isDeleting() const { return m_isDeleting; }
+    qint64 deletedBytes() const { return m_deletedBytes; }
+    qint64 deletedFiles() const { return m_deletedFiles; }
+    int deleteQueueLength() const { return m_deleteQueueLength; }
+    DuplicateGroupModel *duplicateGroups() const { return m_duplicateModel; }
+    bool isFindingDuplicates() const { return m_isFindingDuplicates; }
+    QString duplicateProgress() const { return m_duplicateProgress; }
+    LargestEntryModel *largestFiles() const { return m_largestFilesModel; }
+    LargestEntryModel *largestDirectories() const { return m_largestDirsModel; }
+    QVariantList snapshots() const { return m_snapshots; }
+    bool isComparing() const { return m_isComparing; }
+    QVariantList growers() const { return m_growers; }
+    QVariantList shrinkers() const { return m_shrinkers; }
+    QString growthSummary() const { return m_growthSummary; }
 
     Q_INVOKABLE void startScan(const QString &rootPath = "");
-    Q_INVOKABLE void deleteTarget(int index);
+    // Shows the indexed results of the last scan, then revalidates them
+    Q_INVOKABLE void loadCachedResults(const QString &rootPath = "");
+    Q_INVOKABLE void cancelScan();
+    Q_INVOKABLE void findDuplicates(const QString &rootPath = "");
+    Q_INVOKABLE void cancelDuplicates();
+    // Deletion runs in the background; rows leave the list as they are removed
+    Q_INVOKABLE void deleteTarget(const QString &path);
+    Q_INVOKABLE void deleteSelected();
+    Q_INVOKABLE void cancelDeletion();
+    // Every complete scan leaves a snapshot; compares an older one with the
+    // latest (or newerFile) in the background
+    Q_INVOKABLE void compareSnapshots(const QString &olderFile, const QString &newerFile = "");
     Q_INVOKABLE QString formatSize(qint64 bytes);
 
 signals:
     void targetsUpdated();
     void scanningChanged();
     void scanProgressChanged();
+    void scanStatsChanged();
+    void cachedResultsChanged();
+    void liveUpdatesChanged();
     void scanComplete(qint64 totalSavings);
+    void politeScanChanged();
+    void useTrashChanged();
+    void deletionProgressChanged();
+    void deletionFailed(const QString &path, const QString &error);
+    void deletionComplete(qint64 bytesFreed, qint64 filesRemoved);
+    void duplicateSearchChanged();
+    void duplicateProgressChanged();
+    void duplicatesComplete(qint64 totalReclaimable);
+    void snapshotsChanged();
+    void growthChanged();
 
 private slots:
-    void onScanFinished(QVariantList targets, qint64 totalSavings);
+    void onTargetsFound(const QList<CleanupTarget> &targets);
+    void onCachedResultsLoaded(const QList<CleanupTarget> &targets, qint64 scanTimeMs, bool found);
+    void onScanStats(qint64 dirs, qint64 files, qint64 bytes, qint64 elapsedMs);
+    void onScanFinished(qint64 totalSavings, bool cancelled);
     void onProgressUpdate(const QString &progress);
+    void onUsageTreeReady(const QSharedPointer<DiskUsageTree> &tree);
+    void onLargestEntriesReady(const QList<LargeEntry> &files, const QList<LargeEntry> &directories);
+    void onTargetSizesChanged(const QHash<QString, qint64> &sizes);
+    void onWatchStateChanged(const QString &mode, int watchedTargets);
+    void onTargetRemoved(const QString &path);
+    void onDeletionFailed(const QString &path, const QString &error);
+    void onDeletionProgress(qint64 bytesFreed, qint64 filesRemoved, int queued);
+    void onDeletionIdle(qint64 bytesFreed, qint64 filesRemoved, bool cancelled);
+    void onDuplicateGroupsFound(const QList<DuplicateGroup> &groups);
+    void onDuplicateProgress(const QString &progress);
+    void onDuplicatesFinished(qint64 totalReclaimable, bool cancelled);
+    void onGrowthReady(const SnapshotDiff &diff);
 
 private:
-    struct CleanupTarget {
-        QString path;
-        QString type;
-        qint64 size;
-        QDateTime lastModified;
-        bool isSafe;
-        QString reason;
-    };
-
-    QVariantList m_cleanupTargets;
+    CleanupTargetModel *m_targetModel = nullptr;
+    CleanupTargetProxyModel *m_visibleTargets = nullptr;
+    DiskUsageModel *m_usageModel = nullptr;
     bool m_isScanning = false;
     QString m_scanProgress;
+    qint64 m_scannedDirs = 0;
+    qint64 m_scannedFiles = 0;
+    qint64 m_scannedBytes = 0;
+    double m_bytesPerSecond = 0.0;
+    QString m_cachedScanTime;
+    QString m_scanRoot;
+    bool m_isRevalidating = false;
+    QList<CleanupTarget> m_revalidatedTargets;
     QThread *m_workerThread = nullptr;
     ScanWorker *m_worker = nullptr;
+    QThread *m_watcherThread = nullptr;
+    TargetWatcher *m_watcher = nullptr;
+    bool m_liveUpdates = true;
+    QString m_liveMode = "off";
+    bool m_politeScan = false;
+    QThread *m_deleteThread = nullptr;
+    DeletionEngine *m_deleter = nullptr;
+    bool m_useTrash = false;
+    bool m_isDeleting = false;
+    qint64 m_deletedBytes = 0;
+    qint64 m_deletedFiles = 0;
+    int m_deleteQueueLength = 0;
+    DuplicateGroupModel *m_duplicateModel = nullptr;
+    LargestEntryModel *m_largestFilesModel = nullptr;
+    LargestEntryModel *m_largestDirsModel = nullptr;
+    QThread *m_duplicateThread = nullptr;
+    DuplicateFinder *m_duplicateFinder = nullptr;
+    bool m_isFindingDuplicates = false;
+    QString m_duplicateProgress;
+    QVariantList m_snapshots;
+    bool m_isComparing = false;
+    QVariantList m_growers;
+    QVariantList m_shrinkers;
+    QString m_growthSummary;
 
-    QVariantMap targetToVariant(const CleanupTarget &target);
+    void beginScan(const QString &rootPath, bool revalidate);
+    void startLiveUpdates();
+    void stopLiveUpdates();
+    void queueDeletion(const QStringList &paths);
+    void refreshSnapshots();
 };
 
 // Worker class for background scanning
@@ -68,31 +206,115 @@ class ScanWorker : public QObject
 public:
     explicit ScanWorker(QObject *parent = nullptr);
     void setScanPath(const QString &path);
+    // Building the full usage tree costs ~24 bytes per entry; callers that
+    // only want cleanup targets can turn it off. Set before doScan().
+    void setBuildUsageTree(bool enabled) { m_buildUsageTree = enabled; }
+    // How directory entries are stat'ed; Auto uses io_uring when available.
+    // Set before doScan().
+    void setIoBackend(DirectoryLister::Backend backend) { m_ioBackend = backend; }
+    // Polite mode: idle I/O and CPU priority, a cap on metadata operations
+    // per second, no atime updates and pauses while /proc/pressure/io shows
+    // contention. Set before doScan().
+    void setPolite(bool enabled) { m_polite = enabled; }
+    void setPoliteOpsPerSecond(int ops) { m_throttle.setOpsPerSecond(ops); }
+    // The scan index makes rescans fast but holds a record per directory
+    // until the scan ends; without it memory stays bounded by tree depth.
+    // A directory is reused when its inode, mtime and ctime are unchanged,
+    // which only catches added, removed or renamed entries: a file that
+    // grows or shrinks in place (a log, a database) keeps its indexed size
+    // until its directory changes or a scan runs without the index.
+    // Set before doScan().
+    void setUseIndex(bool enabled) { m_useIndex = enabled; }
+    // Targets per targetsFound() batch; 1 streams each target as found
+    void setBatchSize(int size) { m_batchSize = qMax(1, size); }
+    // Writes a growth snapshot of a complete scan there; empty for none.
+    // Set before doScan().
+    void setSnapshotPath(const QString &fileName) { m_snapshotPath = fileName; }
+    // Size of the largest-files and largest-directories lists kept during
+    // the walk; 0 turns both off. Set before doScan().
+    void setLargestCount(int count) { m_largestCount = qMax(0, count); }
+    DirectoryLister::Backend ioBackend() const { return m_lister.activeBackend(); }
+
+    // Thread-safe: may be called from any thread while doScan() runs
+    void cancel();
 
 public slots:
     void doScan();
+    void loadCachedResults();
 
 signals:
-    void scanFinished(QVariantList targets, qint64 totalSavings);
+    void cachedResultsLoaded(const QList<CleanupTarget> &targets, qint64 scanTimeMs, bool found);
+    void targetsFound(const QList<CleanupTarget> &targets);
+    void scanStats(qint64 dirs, qint64 files, qint64 bytes, qint64 elapsedMs);
+    void scanFinished(qint64 totalSavings, bool cancelled);
     void progressUpdate(const QString &progress);
+    void usageTreeReady(const QSharedPointer<DiskUsageTree> &tree);
+    void largestEntriesReady(const QList<LargeEntry> &files, const QList<LargeEntry> &directories);
 
 private:
-    QString m_scanPath;
+    struct PendingDir {
+        QString path;
+        int prevIndex = -1; // record in the previous scan index, if known
+        quint32 treeNode = DiskUsageTree::NoNode;
+    };
 
-    struct CleanupTarget {
+    // One directory on the DFS stack. Its size is complete once every
+    // subdirectory in pendingDirs has been visited and popped.
+    struct ScanFrame {
         QString path;
-        QString type;
-        qint64 size;
-        QDateTime lastModified;
-        bool isSafe;
-        QString reason;
+        QList<PendingDir> pendingDirs;
+        qint64 size = 0;
+        qint64 ownBytes = 0;
+        quint32 ownFiles = 0;
+        int prevIndex = -1;
+        int indexSlot = -1;
+        quint32 treeNode = DiskUsageTree::NoNode;
+        CleanupTarget target;
+        int rule = -1;
     };
 
-    void scanDirectory(const QString &path, QList<CleanupTarget> &targets);
-    qint64 calculateDirectorySize(const QString &path);
+    QString m_scanPath;
+    std::atomic<bool> m_cancelRequested{false};
+    CleanupRules m_rules;
+    ProcessPathIndex m_openPaths;
+
+    ScanIndex m_prevIndex;
+    ScanIndexWriter m_indexWriter;
+    bool m_useIndex = true;
+    QString m_snapshotPath;
+    ScanSnapshotWriter m_snapshotWriter;
+    bool m_indexActive = false;
+    qint64 m_reusedDirs = 0;
+
+    DirectoryLister m_lister;
+    DirectoryLister::Backend m_ioBackend = DirectoryLister::Auto;
+    bool m_polite = false;
+    ScanThrottle m_throttle;
+    QList<DirectoryLister::Entry> m_entries; // reused between directories
+
+    bool m_buildUsageTree = true;
+    QSharedPointer<DiskUsageTree> m_usageTree;
+
+    int m_largestCount;
+    LargestEntries m_largestFiles;
+    LargestEntries m_largestDirs;
+
+    QList<CleanupTarget> m_pendingBatch;
+    int m_batchSize;
+    QElapsedTimer m_scanTimer;
+    qint64 m_lastFlushMs = 0;
+    qint64 m_lastStatsMs = 0;
+    qint64 m_dirCount = 0;
+    qint64 m_fileCount = 0;
+    qint64 m_byteCount = 0;
+    qint64 m_totalSavings = 0;
+
+    void scanDirectory(const QString &path);
+    bool enterDirectory(ScanFrame &frame, const QString &name);
+    void listDirectory(ScanFrame &frame);
     bool isSafeToDelete(const QString &path, const QFileInfo &info);
-    QVariantMap targetToVariant(const CleanupTarget &target);
-    QString formatSize(qint64 bytes);
+    void reportProgress(const QString &currentPath, bool force);
+    void flushBatch();
 };
 
 #endif // DISKANALYZER_H
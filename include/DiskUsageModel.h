@@ -0,0 +1,88 @@
+#ifndef DISKUSAGEMODEL_H
+#define DISKUSAGEMODEL_H
+
+#include <QAbstractListModel>
+#include <QRectF>
+#include <QSharedPointer>
+#include "DiskUsageTree.h"
+
+// Drill-down treemap over a DiskUsageTree.
+//
+// Only the children of the current directory are materialised as rows, and
+// only those large enough to be visible at the current view size; the rest
+// are folded into a single "other" tile. Tiles are laid out with the
+// squarified treemap algorithm, so QML just positions rectangles.
+class DiskUsageModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(bool hasTree READ hasTree NOTIFY treeChanged)
+    Q_PROPERTY(qint64 entryCount READ entryCount NOTIFY treeChanged)
+    Q_PROPERTY(QString currentPath READ currentPath NOTIFY currentChanged)
+    Q_PROPERTY(qint64 currentSize READ currentSize NOTIFY currentChanged)
+    Q_PROPERTY(bool canGoUp READ canGoUp NOTIFY currentChanged)
+    Q_PROPERTY(qreal viewWidth READ viewWidth WRITE setViewWidth NOTIFY viewSizeChanged)
+    Q_PROPERTY(qreal viewHeight READ viewHeight WRITE setViewHeight NOTIFY viewSizeChanged)
+
+public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        PathRole,
+        SizeRole,
+        SizeFormattedRole,
+        IsDirRole,
+        IsOtherRole,
+        CanDrillDownRole,
+        TileXRole,
+        TileYRole,
+        TileWidthRole,
+        TileHeightRole
+    };
+
+    explicit DiskUsageModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setTree(const QSharedPointer<DiskUsageTree> &tree);
+    void clear();
+
+    bool hasTree() const { return !m_tree.isNull(); }
+    qint64 entryCount() const { return m_tree ? m_tree->nodeCount() : 0; }
+    QString currentPath() const;
+    qint64 currentSize() const;
+    bool canGoUp() const;
+    qreal viewWidth() const { return m_viewWidth; }
+    void setViewWidth(qreal width);
+    qreal viewHeight() const { return m_viewHeight; }
+    void setViewHeight(qreal height);
+
+    Q_INVOKABLE void drillDown(int row);
+    Q_INVOKABLE void goUp();
+    Q_INVOKABLE void goToRoot();
+
+signals:
+    void treeChanged();
+    void currentChanged();
+    void viewSizeChanged();
+
+private:
+    struct Tile {
+        quint32 node = DiskUsageTree::NoNode; // NoNode for the "other" tile
+        quint64 size = 0;
+        int otherCount = 0;
+        QRectF rect;
+    };
+
+    QSharedPointer<DiskUsageTree> m_tree;
+    quint32 m_current = DiskUsageTree::NoNode;
+    qreal m_viewWidth = 0;
+    qreal m_viewHeight = 0;
+    QList<Tile> m_tiles;
+
+    void rebuild();
+    void setCurrent(quint32 node);
+    static void squarify(QList<Tile> &tiles, const QRectF &bounds);
+};
+
+#endif // DISKUSAGEMODEL_H
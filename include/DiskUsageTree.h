@@ -0,0 +1,63 @@
+#ifndef DISKUSAGETREE_H
+#define DISKUSAGETREE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QString>
+
+// Full usage tree of a scan, stored as parallel arrays (24 bytes per entry
+// plus interned names) so ten million files fit in a few hundred MB.
+//
+// A directory's children are appended while it is listed, so they always
+// occupy one contiguous index range [firstChild, firstChild + childCount).
+// Names are deduplicated into a single NUL-separated UTF-8 pool; common
+// names such as "index.js" or "package.json" are stored once.
+class DiskUsageTree
+{
+public:
+    static constexpr quint32 NoNode = 0xFFFFFFFFu;
+
+    DiskUsageTree();
+
+    quint32 addNode(quint32 parent, const QString &name, quint64 size, bool isDir);
+    void setChildren(quint32 node, quint32 first, quint32 count);
+    void setSize(quint32 node, quint64 size) { m_size[node] = size; }
+
+    // Drops the interning table and spare capacity once the scan is done
+    void squeeze();
+
+    quint32 nodeCount() const { return quint32(m_parent.size()); }
+    quint32 parent(quint32 node) const { return m_parent[node]; }
+    quint64 size(quint32 node) const { return m_size[node]; }
+    bool isDir(quint32 node) const { return m_nameOffset[node] & kDirFlag; }
+    quint32 firstChild(quint32 node) const { return m_firstChild[node]; }
+    quint32 childCount(quint32 node) const { return m_childCount[node]; }
+    QString name(quint32 node) const;
+    QString path(quint32 node) const;
+
+    qint64 memoryUsage() const;
+
+private:
+    static constexpr quint32 kDirFlag = 0x80000000u;
+    static constexpr quint32 kEmptySlot = 0xFFFFFFFFu;
+
+    QList<quint32> m_parent;
+    QList<quint32> m_nameOffset; // high bit marks directories
+    QList<quint64> m_size;
+    QList<quint32> m_firstChild;
+    QList<quint32> m_childCount;
+    QByteArray m_names;
+
+    // Open-addressing set of pool offsets, only needed while building
+    QList<quint32> m_internSlots;
+    quint32 m_internCount = 0;
+
+    quint32 intern(const QByteArray &name);
+    void growInternTable();
+};
+
+Q_DECLARE_METATYPE(QSharedPointer<DiskUsageTree>)
+
+#endif // DISKUSAGETREE_H
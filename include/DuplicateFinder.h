@@ -0,0 +1,78 @@
+#ifndef DUPLICATEFINDER_H
+#define DUPLICATEFINDER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMetaType>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+
+struct DuplicateGroup {
+    qint64 fileSize = 0;
+    QStringList paths;
+
+    qint64 reclaimable() const { return fileSize * (paths.size() - 1); }
+};
+
+Q_DECLARE_METATYPE(DuplicateGroup)
+
+// Finds identical files under a root in stages, each stage only looking at
+// what the previous one could not tell apart:
+//   1. group by size (metadata only)
+//   2. hash the first and last 4 KB of every same-size file
+//   3. fully hash files whose sizes and partial hashes still collide
+// Hashing is XXH64 on a private thread pool with a bounded number of files
+// in flight. Only same-size candidates are kept in memory, and when there
+// are too many of them they are processed in size ranges, one walk each.
+class DuplicateFinder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DuplicateFinder(QObject *parent = nullptr);
+    ~DuplicateFinder();
+
+    void setRootPath(const QString &path);
+    void setMinFileSize(qint64 bytes) { m_minFileSize = bytes; }
+
+    // Thread-safe: may be called from any thread while findDuplicates() runs
+    void cancel();
+
+public slots:
+    void findDuplicates();
+
+signals:
+    void groupsFound(const QList<DuplicateGroup> &groups);
+    void progressUpdate(const QString &progress);
+    void finished(qint64 totalReclaimable, bool cancelled);
+
+private:
+    struct Candidate {
+        QString path;
+        qint64 size = 0;
+        quint64 hash = 0;
+        quint64 dev = 0;
+        quint64 ino = 0;
+        bool readable = true;
+    };
+
+    QString m_rootPath;
+    qint64 m_minFileSize = 4096;
+    std::atomic<bool> m_cancelRequested{false};
+    QThreadPool m_pool;
+    QElapsedTimer m_progressTimer;
+    qint64 m_lastProgressMs = 0;
+    qint64 m_totalReclaimable = 0;
+
+    template <typename Fn>
+    void walkFiles(Fn visit);
+    void processCandidates(QList<Candidate> &candidates);
+    void hashCandidates(QList<Candidate> &candidates, bool partial, const QString &stage);
+    void reportProgress(const QString &progress);
+
+    static bool hashFile(Candidate &candidate, bool partial, const std::atomic<bool> &cancel);
+};
+
+#endif // DUPLICATEFINDER_H
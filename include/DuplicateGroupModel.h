@@ -0,0 +1,45 @@
+#ifndef DUPLICATEGROUPMODEL_H
+#define DUPLICATEGROUPMODEL_H
+
+#include <QAbstractListModel>
+#include "DuplicateFinder.h"
+
+// Duplicate groups ordered by reclaimable bytes, filled while the finder runs
+class DuplicateGroupModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(qint64 totalReclaimable READ totalReclaimable NOTIFY totalReclaimableChanged)
+
+public:
+    enum Roles {
+        FileSizeRole = Qt::UserRole + 1,
+        FileSizeFormattedRole,
+        FileCountRole,
+        ReclaimableRole,
+        ReclaimableFormattedRole,
+        PathsRole
+    };
+
+    explicit DuplicateGroupModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_groups.size(); }
+    qint64 totalReclaimable() const { return m_totalReclaimable; }
+
+    void appendGroups(const QList<DuplicateGroup> &groups);
+    void clear();
+
+signals:
+    void countChanged();
+    void totalReclaimableChanged();
+
+private:
+    QList<DuplicateGroup> m_groups;
+    qint64 m_totalReclaimable = 0;
+};
+
+#endif // DUPLICATEGROUPMODEL_H
@@ -0,0 +1,35 @@
+#ifndef EVENTLOOPPOOL_H
+#define EVENTLOOPPOOL_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QThread>
+
+// A small, fixed set of threads each running an event loop. Objects that
+// only react to events (timers, QProcess signals, sockets) are spread
+// across them, so the thread count stays the same however many objects
+// there are. Nothing adopted here may block.
+class EventLoopPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 0 picks a count from the number of cores
+    explicit EventLoopPool(int threadCount = 0, QObject *parent = nullptr);
+    ~EventLoopPool();
+
+    int threadCount() const { return m_threads.size(); }
+
+    // Moves a parentless object to the least loaded thread
+    void adopt(QObject *object);
+    // Deletes the object on its thread once pending events are handled
+    void release(QObject *object);
+
+private:
+    QList<QThread *> m_threads;
+    QList<int> m_load;
+    QHash<QObject *, int> m_assigned;
+};
+
+#endif // EVENTLOOPPOOL_H
@@ -0,0 +1,95 @@
+#ifndef FLEETSUMMARYMODEL_H
+#define FLEETSUMMARYMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+#include "DDSketch.h"
+
+struct ServerInfo;
+
+// Live fleet statistics per group: row 0 covers every reporting server,
+// then one row per tag. Each stats update moves one server's contribution
+// in the CPU and RAM sketches and the network sums of its groups, so the
+// cost does not depend on the fleet size. Quantiles are read from the
+// sketches at most once a second, for the groups that changed.
+class FleetSummaryModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        GroupRole = Qt::UserRole + 1,
+        ServersRole,
+        CpuP50Role,
+        CpuP95Role,
+        CpuP99Role,
+        RamP99Role,
+        HotHostsRole,     // names above the RAM p99
+        NetUpRole,        // formatted totals
+        NetDownRole
+    };
+
+    explicit FleetSummaryModel(QObject *parent = nullptr);
+    ~FleetSummaryModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return int(m_groups.size()); }
+
+    // Latest stats of a connected server; replaces what it reported before
+    void setSample(const ServerInfo &server);
+    // Disconnected or removed: no longer counted anywhere
+    void removeServer(const QString &id);
+
+signals:
+    void countChanged();
+
+private:
+    struct Member {
+        QString name;
+        QStringList groups;
+        double cpu = 0.0;
+        double ram = 0.0;
+        double netUp = 0.0;
+        double netDown = 0.0;
+    };
+
+    struct Group {
+        QString name;
+        int servers = 0;
+        DDSketch cpu;
+        DDSketch ram;
+        double netUp = 0.0;
+        double netDown = 0.0;
+        // (ram, id), to list the hosts above the p99 without a scan
+        std::set<std::pair<double, QString>> ramRanking;
+        bool dirty = false;
+
+        // Read from the sketches by refresh()
+        double cpuP50 = 0.0;
+        double cpuP95 = 0.0;
+        double cpuP99 = 0.0;
+        double ramP99 = 0.0;
+        QStringList hotHosts;
+    };
+
+    QHash<QString, Member> m_members;
+    std::vector<std::unique_ptr<Group>> m_groups;
+    QHash<QString, int> m_rows; // group name -> row; "" is the whole fleet
+    QTimer m_refreshTimer;
+
+    Group *group(const QString &name);
+    void apply(const QString &id, const Member &member, int sign);
+    void refresh();
+};
+
+#endif // FLEETSUMMARYMODEL_H
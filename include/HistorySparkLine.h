@@ -0,0 +1,75 @@
+#ifndef HISTORYSPARKLINE_H
+#define HISTORYSPARKLINE_H
+
+#include <QColor>
+#include <QPointer>
+#include <QQuickPaintedItem>
+#include "MetricHistory.h"
+
+class ServerListModel;
+
+// Sparkline of one metric of one server, painted straight from the
+// model's MetricHistory ring: nothing is copied into QML. Bind revision to
+// the delegate's historyRevision role so that it repaints on new samples.
+class HistorySparkLine : public QQuickPaintedItem
+{
+    Q_OBJECT
+    Q_PROPERTY(ServerListModel *source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QString serverId READ serverId WRITE setServerId NOTIFY serverIdChanged)
+    Q_PROPERTY(Metric metric READ metric WRITE setMetric NOTIFY metricChanged)
+    Q_PROPERTY(Tier tier READ tier WRITE setTier NOTIFY tierChanged)
+    Q_PROPERTY(quint32 revision READ revision WRITE setRevision NOTIFY revisionChanged)
+    Q_PROPERTY(QColor lineColor READ lineColor WRITE setLineColor NOTIFY lineColorChanged)
+
+public:
+    enum Metric {
+        Cpu = MetricHistory::Cpu,
+        Ram = MetricHistory::Ram,
+        Disk = MetricHistory::Disk,
+        NetUp = MetricHistory::NetUp,
+        NetDown = MetricHistory::NetDown
+    };
+    Q_ENUM(Metric)
+
+    enum Tier {
+        Raw = MetricHistory::Raw,
+        Minute = MetricHistory::Minute,
+        QuarterHour = MetricHistory::QuarterHour
+    };
+    Q_ENUM(Tier)
+
+    explicit HistorySparkLine(QQuickItem *parent = nullptr);
+
+    ServerListModel *source() const { return m_source; }
+    void setSource(ServerListModel *source);
+    QString serverId() const { return m_serverId; }
+    void setServerId(const QString &id);
+    Metric metric() const { return m_metric; }
+    void setMetric(Metric metric);
+    Tier tier() const { return m_tier; }
+    void setTier(Tier tier);
+    quint32 revision() const { return m_revision; }
+    void setRevision(quint32 revision);
+    QColor lineColor() const { return m_lineColor; }
+    void setLineColor(const QColor &color);
+
+    void paint(QPainter *painter) override;
+
+signals:
+    void sourceChanged();
+    void serverIdChanged();
+    void metricChanged();
+    void tierChanged();
+    void revisionChanged();
+    void lineColorChanged();
+
+private:
+    QPointer<ServerListModel> m_source;
+    QString m_serverId;
+    Metric m_metric = Cpu;
+    Tier m_tier = Raw;
+    quint32 m_revision = 0;
+    QColor m_lineColor = QColor("#FF3333");
+};
+
+#endif // HISTORYSPARKLINE_H
@@ -0,0 +1,44 @@
+#ifndef LARGESTENTRIES_H
+#define LARGESTENTRIES_H
+
+#include <QList>
+#include <QMetaType>
+#include <QString>
+
+struct LargeEntry {
+    QString path;
+    qint64 size = 0;
+};
+
+Q_DECLARE_METATYPE(LargeEntry)
+
+// The K largest entries seen so far, as a bounded min-heap on size: the
+// smallest kept entry sits at the top, so a candidate is rejected with one
+// comparison and memory never exceeds K entries.
+class LargestEntries
+{
+public:
+    explicit LargestEntries(int capacity = 0);
+
+    // Drops what was collected; 0 turns collecting off
+    void setCapacity(int capacity);
+    int capacity() const { return m_capacity; }
+
+    // Checked before add() so callers only build a path for entries that
+    // make it in. Empty entries never do.
+    bool accepts(qint64 size) const
+    {
+        return size > 0 && m_capacity > 0 && (m_heap.size() < m_capacity || size > m_heap.first().size);
+    }
+    void add(const QString &path, qint64 size);
+
+    // Largest first
+    QList<LargeEntry> sorted() const;
+    void clear() { m_heap.clear(); }
+
+private:
+    int m_capacity;
+    QList<LargeEntry> m_heap;
+};
+
+#endif // LARGESTENTRIES_H
@@ -0,0 +1,38 @@
+#ifndef LARGESTENTRYMODEL_H
+#define LARGESTENTRYMODEL_H
+
+#include <QAbstractListModel>
+#include "LargestEntries.h"
+
+// Largest files or directories of the last scan, largest first
+class LargestEntryModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        PathRole = Qt::UserRole + 1,
+        SizeRole,
+        SizeFormattedRole
+    };
+
+    explicit LargestEntryModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_entries.size(); }
+
+    void setEntries(const QList<LargeEntry> &entries);
+    void clear();
+
+signals:
+    void countChanged();
+
+private:
+    QList<LargeEntry> m_entries;
+};
+
+#endif // LARGESTENTRYMODEL_H
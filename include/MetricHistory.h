@@ -0,0 +1,82 @@
+#ifndef METRICHISTORY_H
+#define METRICHISTORY_H
+
+#include <QtGlobal>
+
+// Recent history of one server's stats in fixed-size rings, one byte per
+// value:
+//
+//   Raw          the last 120 samples (10 min at the 5 s tick)
+//   Minute       1-minute averages, 6 h
+//   QuarterHour  15-minute averages, 24 h
+//
+// Percentages are stored in steps of 0.4 %, rates on a log scale with
+// about 10 % steps from 1 B/s to beyond 10 GB/s; 255 marks a gap where a
+// rollup period had no sample. That is under 3 KB per server for all
+// tiers, so 5,000 servers stay around 15 MB. Nothing is allocated after
+// construction; readers index the rings in place.
+class MetricHistory
+{
+public:
+    enum Metric {
+        Cpu,
+        Ram,
+        Disk,
+        NetUp,   // bytes per second
+        NetDown,
+        MetricCount
+    };
+
+    enum Tier {
+        Raw,
+        Minute,
+        QuarterHour,
+        TierCount
+    };
+
+    static constexpr int kCapacity[TierCount] = {120, 360, 96};
+    static constexpr quint8 kGap = 255;
+
+    MetricHistory();
+
+    // Rollups are aligned to wall-clock minutes; a sample older than the
+    // current rollup period is only kept in the raw tier
+    void add(qint64 timeMs, const double values[MetricCount]);
+
+    int count(Tier tier) const { return m_tiers[tier].count; }
+    // index 0 is the oldest value; NaN for a gap
+    double value(Tier tier, Metric metric, int index) const;
+    // Changes with every add()
+    quint32 revision() const { return m_revision; }
+
+    static bool isPercent(Metric metric) { return metric <= Disk; }
+    static quint8 encode(Metric metric, double value);
+    static double decode(Metric metric, quint8 code);
+
+private:
+    struct Ring {
+        int offset; // into m_data, per metric: offset + metric * capacity
+        int head = 0;
+        int count = 0;
+    };
+
+    // Sums of the rollup period in progress
+    struct Rollup {
+        qint64 period = -1;
+        int samples = 0;
+        double sums[MetricCount] = {};
+    };
+
+    static constexpr int kTotalSlots = kCapacity[Raw] + kCapacity[Minute] + kCapacity[QuarterHour];
+
+    quint8 m_data[MetricCount * kTotalSlots];
+    Ring m_tiers[TierCount];
+    Rollup m_rollups[TierCount]; // Raw is unused
+    quint32 m_revision = 0;
+
+    void push(Tier tier, const double values[MetricCount]);
+    void pushGap(Tier tier);
+    void accumulate(Tier tier, qint64 period, const double values[MetricCount]);
+};
+
+#endif // METRICHISTORY_H
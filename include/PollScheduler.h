@@ -0,0 +1,87 @@
+#ifndef POLLSCHEDULER_H
+#define POLLSCHEDULER_H
+
+#include "DDSketch.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <deque>
+#include <map>
+
+// Decides when each connected server is polled, for all of them at once.
+//
+// A server keeps a fixed phase within its interval; phases follow the
+// golden-ratio sequence, so however many servers join, polls stay spread
+// evenly over the interval instead of firing in lock-step. At most
+// maxInFlight polls run at a time; the rest wait in order. A failed poll
+// is retried after an exponential backoff with jitter, capped at five
+// minutes, so unreachable hosts cost almost nothing. The timer wakes at
+// most every kSliceMs and dispatches whatever is due by then.
+class PollScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PollScheduler(QObject *parent = nullptr);
+
+    void setMaxInFlight(int count);
+    int maxInFlight() const { return m_maxInFlight; }
+
+    void addServer(const QString &id, int intervalMs);
+    void removeServer(const QString &id);
+    // Takes effect from the next poll
+    void setInterval(const QString &id, int intervalMs);
+
+    // Polls due while paused are shifted by the pause, keeping the spread
+    void pause();
+    void resume();
+
+    // Milliseconds from pollDue to pollFinished of successful polls, so
+    // including the queued delivery of the sample to this thread
+    const DDSketch &latency() const { return m_latency; }
+    void resetLatency() { m_latency.clear(); }
+
+public slots:
+    // Reported by the worker; unknown or idle ids are ignored
+    void pollFinished(const QString &id, bool ok);
+
+signals:
+    void pollDue(const QString &id);
+
+private:
+    enum State { Queued, Waiting, InFlight };
+
+    struct Entry {
+        int intervalMs = 0;
+        State state = Queued;
+        qint64 scheduledMs = 0;   // when the current poll was meant to run
+        qint64 dispatchedMs = 0;
+        int failures = 0;
+        std::multimap<qint64, QString>::iterator queued;
+    };
+
+    QHash<QString, Entry> m_entries;
+    // Due times of queued polls, and timeouts of the ones in flight
+    std::multimap<qint64, QString> m_queue;
+    std::deque<QString> m_waiting;
+    int m_inFlight = 0;
+    int m_maxInFlight;
+    quint64 m_added = 0;
+
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    bool m_paused = false;
+    qint64 m_pausedAt = 0;
+    DDSketch m_latency;
+
+    void enqueue(const QString &id, Entry &entry, qint64 atMs);
+    void dispatch(const QString &id, Entry &entry);
+    void dispatchWaiting();
+    void finish(const QString &id, Entry &entry, bool ok);
+    void onTimer();
+    void arm();
+};
+
+#endif // POLLSCHEDULER_H
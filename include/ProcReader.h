@@ -0,0 +1,30 @@
+#ifndef PROCREADER_H
+#define PROCREADER_H
+
+#include "AgentProtocol.h"
+#include <cstdint>
+
+// Reads Linux /proc counters with plain read(2) into a stack buffer, line
+// by line across reads, so files of any length are read whole: no Qt, no
+// allocation. Shared by the local SystemWorker and ac-agent; each call
+// returns false where the file is missing (not Linux).
+class ProcReader
+{
+public:
+    // First "cpu" line of /proc/stat; idle includes iowait
+    static bool readCpu(uint64_t &total, uint64_t &idle);
+    static bool readMemory(uint64_t &totalKb, uint64_t &availableKb);
+    // Summed over all interfaces but loopback
+    static bool readNetwork(uint64_t &rxBytes, uint64_t &txBytes);
+    // Summed over whole disks; partitions and dm/md devices are skipped
+    static bool readDiskStats(uint64_t &readSectors, uint64_t &writtenSectors);
+    static bool readFileSystem(const char *path, uint64_t &usedBytes, uint64_t &availableBytes);
+    static uint64_t monotonicMs();
+
+    // Everything above for one agent frame
+    static void sample(AgentSample &sample);
+
+    static bool isWholeDisk(const char *name);
+};
+
+#endif // PROCREADER_H
@@ -0,0 +1,69 @@
+#ifndef PROCSTATS_H
+#define PROCSTATS_H
+
+#include "AgentProtocol.h"
+#include <QString>
+#include <QStringList>
+
+// Raw counters from one read of a Linux host's /proc, as sent by the
+// remote sampler. Everything is a cumulative counter or a plain amount;
+// rates are only computed locally from two samples.
+struct ProcSample {
+    double uptimeSeconds = -1.0; // /proc/uptime: the host's monotonic clock
+
+    bool hasCpu = false;
+    quint64 cpuTotal = 0; // jiffies over all states
+    quint64 cpuIdle = 0;  // idle + iowait
+
+    quint64 memTotalKb = 0;
+    quint64 memAvailableKb = 0;
+
+    bool hasNet = false;
+    quint64 netRxBytes = 0; // all interfaces but loopback
+    quint64 netTxBytes = 0;
+
+    bool hasDiskIo = false;
+    quint64 diskReadSectors = 0; // whole disks only, 512-byte sectors
+    quint64 diskWrittenSectors = 0;
+
+    bool hasFs = false; // statfs of / is only sent now and then
+    quint64 fsUsedBytes = 0;
+    quint64 fsAvailableBytes = 0;
+};
+
+struct ProcRates {
+    double cpuPercent = 0.0;
+    double ramPercent = 0.0;
+    double diskPercent = 0.0;
+    double netUpBytesPerSec = 0.0;
+    double netDownBytesPerSec = 0.0;
+    double diskReadBytesPerSec = 0.0;
+    double diskWriteBytesPerSec = 0.0;
+};
+
+class ProcStats
+{
+public:
+    // Shell for one sample frame: "@@sample", sections tagged "@uptime",
+    // "@stat", "@meminfo", "@netdev", "@diskstats" and optionally
+    // "@statfs", then "@@end". Only builtins run, except stat -f.
+    static QString sampleScript(bool withStatFs);
+    // Same frame on every line read from stdin, statfs every statFsEvery
+    // samples; meant to run for the whole session
+    static QString streamScript(int statFsEvery);
+
+    // Lines between "@@sample" and "@@end"; false without a cpu line
+    static bool parseFrame(const QStringList &lines, ProcSample &sample);
+    // A decoded ac-agent frame; false without cpu counters
+    static bool fromAgent(const AgentSample &agent, ProcSample &sample);
+
+    // Deltas over the host's own elapsed time between the two samples,
+    // or fallbackSeconds when the uptime is missing or went backwards.
+    // Counter resets give 0 rather than a negative rate.
+    static ProcRates rates(const ProcSample &previous, const ProcSample &current, double fallbackSeconds);
+
+    // "12.3 KB/s" / "1.25 MB/s"
+    static QString formatRate(double bytesPerSecond);
+};
+
+#endif // PROCSTATS_H
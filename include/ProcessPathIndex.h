@@ -0,0 +1,47 @@
+#ifndef PROCESSPATHINDEX_H
+#define PROCESSPATHINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+// Snapshot of the paths running processes are using, taken once per scan.
+//
+// Collected from /proc/<pid>/cwd, exe, fd and maps, plus the VIRTUAL_ENV and
+// CONDA_PREFIX of each process, so a build directory whose binary is running
+// or an activated virtualenv shows up. The paths are stored as a trie of
+// path components: asking whether anything below a directory is in use
+// walks one node per component of that directory, independent of how many
+// paths were collected.
+class ProcessPathIndex
+{
+public:
+    ProcessPathIndex();
+
+    static bool isSupported();
+
+    // Replaces the snapshot; the calling process itself is left out
+    void build();
+    void clear();
+
+    // Name and pid of a process using the directory or anything below it,
+    // or an empty string if none does
+    QString processUsing(const QString &dirPath) const;
+    bool isInUse(const QString &dirPath) const { return !processUsing(dirPath).isEmpty(); }
+
+    int pathCount() const { return m_pathCount; }
+
+private:
+    struct Node {
+        QHash<QString, int> children;
+        int pid = 0; // first process seen at or below this node
+    };
+
+    QList<Node> m_nodes; // m_nodes[0] is "/"
+    QHash<int, QString> m_processNames;
+    int m_pathCount = 0;
+
+    void insert(QStringView path, int pid);
+};
+
+#endif // PROCESSPATHINDEX_H
@@ -0,0 +1,125 @@
+#ifndef SCANINDEX_H
+#define SCANINDEX_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QString>
+#include "CleanupTargetModel.h"
+
+// On-disk index of the previous scan of a root path.
+//
+// Layout (native endianness, every section 8-byte aligned so the file can be
+// used straight from a read-only mmap):
+//   Header
+//   DirRecord[dirCount]       directories in DFS pre-order
+//   TargetRecord[targetCount] cleanup targets found by that scan
+//   names blob                UTF-8 strings referenced by offset/length
+//
+// Pre-order means the children of record i start at i + 1 and each child's
+// subtree ends at its subtreeEnd, so a subtree can be walked without parent
+// links or a separate child table.
+class ScanIndex
+{
+public:
+    struct Header;
+
+    struct DirStat {
+        quint64 dev = 0;
+        quint64 ino = 0;
+        qint64 mtimeNs = 0;
+        qint64 ctimeNs = 0;
+    };
+
+    struct DirRecord {
+        quint64 dev;
+        quint64 ino;
+        qint64 mtimeNs;
+        qint64 ctimeNs;
+        quint64 ownBytes;    // regular files directly in this directory
+        quint64 totalBytes;  // whole subtree
+        quint32 ownFiles;
+        quint32 subtreeEnd;  // one past the last descendant record
+        quint32 nameOffset;
+        quint32 nameLength;
+    };
+
+    struct TargetRecord {
+        quint64 size;
+        qint64 lastModifiedMs;
+        quint32 pathOffset;
+        quint32 pathLength;
+        quint32 typeOffset;
+        quint32 typeLength;
+        quint32 reasonOffset;
+        quint32 reasonLength;
+        quint32 isSafe;
+        quint32 reserved;
+    };
+
+    ScanIndex() = default;
+    ~ScanIndex();
+    ScanIndex(const ScanIndex &) = delete;
+    ScanIndex &operator=(const ScanIndex &) = delete;
+
+    bool open(const QString &fileName, const QString &rootPath);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    int dirCount() const;
+    const DirRecord &dir(int index) const;
+    QString name(int index) const;
+    qint64 scanTimeMs() const;
+    QList<CleanupTarget> targets() const;
+
+    // True when the directory has not been touched since it was indexed, so
+    // its file list (and therefore ownBytes/ownFiles and child names) holds
+    bool isUnchanged(int index, const DirStat &st) const;
+
+    template <typename Fn>
+    void forEachChild(int index, Fn fn) const
+    {
+        const int end = qMin<int>(dir(index).subtreeEnd, dirCount());
+        int child = index + 1;
+        while (child < end) {
+            fn(child);
+            int next = int(dir(child).subtreeEnd);
+            if (next <= child) break; // corrupt record, stop rather than loop
+            child = next;
+        }
+    }
+
+    static bool isSupported();
+    static bool statDirectory(const QString &path, DirStat &st);
+    static QString indexPathFor(const QString &rootPath);
+
+private:
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+
+    const Header *header() const;
+    QString string(quint32 offset, quint32 length) const;
+};
+
+// Collects the records of a running scan and writes them as a ScanIndex file
+class ScanIndexWriter
+{
+public:
+    void clear();
+
+    int beginDirectory(const ScanIndex::DirStat &st, const QString &name);
+    void endDirectory(int slot, quint64 ownBytes, quint32 ownFiles, quint64 totalBytes);
+    void addTarget(const CleanupTarget &target);
+
+    bool save(const QString &fileName, const QString &rootPath, qint64 scanTimeMs) const;
+
+private:
+    QList<ScanIndex::DirRecord> m_dirs;
+    QList<ScanIndex::TargetRecord> m_targets;
+    QByteArray m_names;
+
+    void appendString(const QString &str, quint32 &offset, quint32 &length);
+};
+
+#endif // SCANINDEX_H
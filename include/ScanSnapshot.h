@@ -0,0 +1,119 @@
+#ifndef SCANSNAPSHOT_H
+#define SCANSNAPSHOT_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+
+// Compact record of every directory's subtree size at the end of a scan,
+// kept to answer "what grew since last week".
+//
+// Layout (native endianness):
+//   Header
+//   root path                 UTF-8
+//   size section              per directory, sorted by path hash:
+//                             varint(hash - previous hash), varint(bytes)
+//   path section              per directory, in the order they finished:
+//                             varint(bytes shared with the previous path),
+//                             varint(suffix length), suffix
+//
+// Paths are relative to the root and hashed with 64-bit FNV-1a. Sorted
+// hash deltas average 2^64 / N for N directories, so they barely shrink
+// as the tree grows: about 7 bytes each at a million directories, 8 at a
+// thousand. Sizes take 2 to 6 bytes. Two snapshots are compared by merging
+// their size sections in one pass. Only the handful of directories that
+// make the top lists are then named, by hashing the path sections once
+// more.
+struct SnapshotChange {
+    QString path;
+    qint64 oldSize = 0;
+    qint64 newSize = 0;
+
+    qint64 delta() const { return newSize - oldSize; }
+};
+
+struct SnapshotDiff {
+    bool ok = false;
+    QString error;
+    QString rootPath;
+    qint64 oldScanTimeMs = 0;
+    qint64 newScanTimeMs = 0;
+    quint64 oldTotal = 0;
+    quint64 newTotal = 0;
+    quint32 oldDirCount = 0;
+    quint32 newDirCount = 0;
+    QList<SnapshotChange> growers;   // largest growth first
+    QList<SnapshotChange> shrinkers; // largest shrink first
+};
+
+Q_DECLARE_METATYPE(SnapshotDiff)
+
+class ScanSnapshot
+{
+public:
+    struct Header;
+
+    struct Info {
+        QString fileName;
+        QString rootPath;
+        qint64 scanTimeMs = 0;
+        quint32 dirCount = 0;
+        quint64 totalBytes = 0;
+    };
+
+    static quint64 hashPath(const QByteArray &relativePath);
+
+    // Where the application keeps snapshots of a root
+    static QString snapshotDirFor(const QString &rootPath);
+    static QString newSnapshotPathFor(const QString &rootPath, qint64 scanTimeMs);
+    // Newest first
+    static QList<Info> list(const QString &rootPath);
+    // Keeps the newest keepRecent snapshots and the newest snapshot of each
+    // of the last keepDays days that have one, so repeated scans in a day
+    // cannot push out the history a growth comparison needs
+    static void prune(const QString &rootPath, int keepRecent, int keepDays);
+
+    static bool readInfo(const QString &fileName, Info &info);
+
+    // Streams both files; memory is bounded by topCount, not snapshot size
+    static SnapshotDiff diff(const QString &olderFile, const QString &newerFile, int topCount);
+};
+
+// Collects a snapshot while a scan runs: sizes are kept as 16 bytes per
+// directory for the final sort, paths are front-coded straight to a
+// temporary file.
+class ScanSnapshotWriter
+{
+public:
+    ~ScanSnapshotWriter();
+
+    bool begin(const QString &fileName, const QString &rootPath);
+    bool isOpen() const { return m_pathFile.isOpen(); }
+
+    // Directories may come in any order; path is absolute
+    void addDirectory(const QString &path, quint64 subtreeBytes);
+
+    bool finish(qint64 scanTimeMs);
+    void abort();
+
+private:
+    struct Record {
+        quint64 hash;
+        quint64 bytes;
+    };
+
+    QString m_fileName;
+    QString m_rootPath;
+    QList<Record> m_records;
+    quint64 m_totalBytes = 0;
+
+    QFile m_pathFile;
+    QByteArray m_pathBuffer;
+    QByteArray m_previousPath;
+
+    void flushPaths();
+};
+
+#endif // SCANSNAPSHOT_H
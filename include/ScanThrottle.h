@@ -0,0 +1,60 @@
+#ifndef SCANTHROTTLE_H
+#define SCANTHROTTLE_H
+
+#include <QElapsedTimer>
+#include <atomic>
+#include <functional>
+
+// Keeps a scan out of the way of other workloads ("polite" mode).
+//
+// start() moves the calling thread to the idle I/O priority class and the
+// SCHED_IDLE CPU policy, so the kernel serves it only when nothing else
+// wants the disk or CPU. stop() tries to put back whatever start() changed,
+// but without CAP_SYS_NICE the kernel does not let a thread leave
+// SCHED_IDLE, so the thread usually keeps that policy. consume() is a token
+// bucket on metadata operations per second, and while /proc/pressure/io
+// reports contention it pauses the scan until the pressure drops again, for
+// at most 30 s at a time.
+class ScanThrottle
+{
+public:
+    ScanThrottle();
+
+    void setOpsPerSecond(int ops);
+    int opsPerSecond() const { return m_opsPerSecond; }
+
+    // Waits give up early once the flag is set
+    void setCancelFlag(const std::atomic<bool> *flag) { m_cancel = flag; }
+    // Called on the scanning thread when a pressure pause starts and ends
+    void setPauseHandler(std::function<void(bool paused)> handler) { m_pauseHandler = std::move(handler); }
+
+    // Both act on the calling thread
+    void start();
+    void stop();
+
+    // Blocks until the bucket covers ops metadata operations
+    void consume(int ops);
+
+    // "some avg10" of /proc/pressure/io in percent, or -1 without PSI
+    static double ioPressure();
+
+private:
+    int m_opsPerSecond;
+    double m_tokens = 0.0;
+    QElapsedTimer m_clock;
+    qint64 m_lastRefillNs = 0;
+    qint64 m_lastPressureCheckMs = 0;
+
+    const std::atomic<bool> *m_cancel = nullptr;
+    std::function<void(bool)> m_pauseHandler;
+
+    bool m_active = false;
+    int m_savedIoPriority = -1;
+    int m_savedPolicy = -1;
+    int m_savedSchedPriority = 0;
+
+    bool isCancelled() const { return m_cancel && m_cancel->load(std::memory_order_relaxed); }
+    void waitForLowPressure();
+};
+
+#endif // SCANTHROTTLE_H
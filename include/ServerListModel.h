@@ -0,0 +1,93 @@
+#ifndef SERVERLISTMODEL_H
+#define SERVERLISTMODEL_H
+
+#include "MetricHistory.h"
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+struct ServerInfo {
+    QString id;
+    QString name;
+    QString host;
+    int port = 22;
+    QString username;
+    QString password; // In production, use key-based auth
+    QStringList tags; // groups for the fleet summary
+    int pollInterval = 0; // seconds; 0 uses the tags' or the default interval
+    bool connected = false;
+    double cpuUsage = 0.0;
+    double ramUsage = 0.0;
+    double diskUsage = 0.0;
+    double networkUp = 0.0; // bytes per second
+    double networkDown = 0.0;
+    double diskRead = 0.0;
+    double diskWrite = 0.0;
+    QString lastError;
+};
+
+// Configured servers with their latest stats, in the order they were added.
+// update() compares against the stored row and signals only the roles that
+// changed, so a stats tick re-evaluates a few bindings of one delegate
+// instead of rebuilding the list. The password is kept but not exposed.
+// Each row also owns a MetricHistory; views draw from it in place and use
+// the historyRevision role only as a repaint trigger.
+class ServerListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        IdRole = Qt::UserRole + 1,
+        NameRole,
+        HostRole,
+        PortRole,
+        UsernameRole,
+        TagsRole,
+        PollIntervalRole,
+        ConnectedRole,
+        CpuUsageRole,
+        RamUsageRole,
+        DiskUsageRole,
+        NetworkUpRole,
+        NetworkDownRole,
+        DiskReadRole,
+        DiskWriteRole,
+        LastErrorRole,
+        HistoryRevisionRole
+    };
+
+    explicit ServerListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_servers.size(); }
+    const QList<ServerInfo> &servers() const { return m_servers; }
+    // nullptr for an unknown id; valid until the next append or remove
+    const ServerInfo *find(const QString &id) const;
+
+    void append(const ServerInfo &server);
+    void remove(const QString &id);
+    // Replaces the row with the same id
+    void update(const ServerInfo &server);
+
+    const MetricHistory *history(const QString &id) const;
+    void addSample(const QString &id, qint64 timeMs, const double values[MetricHistory::MetricCount]);
+
+signals:
+    void countChanged();
+
+private:
+    QList<ServerInfo> m_servers;
+    std::vector<std::unique_ptr<MetricHistory>> m_histories; // same rows
+    QHash<QString, int> m_rows; // id -> row
+};
+
+#endif // SERVERLISTMODEL_H
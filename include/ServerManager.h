@@ -2,82 +2,139 @@
 #define SERVERMANAGER_H
 
 #include <QObject>
+#include <QMap>
 #include <QProcess>
-#include <QVariantList>
-#include <QVariantMap>
 #include <QTimer>
-#include <QThread>
 #include <QClipboard>
+#include <QElapsedTimer>
+#include <QSet>
+#include "ProcStats.h"
+#include "ServerListModel.h"
+#include "FleetSummaryModel.h"
 #include <QGuiApplication>
-#include <QTimer>
-
-struct ServerInfo {
-    QString id;
-    QString name;
-    QString host;
-    int port;
-    QString username;
-    QString password; // In production, use key-based auth
-    bool connected;
-    double cpuUsage;
-    double ramUsage;
-    double diskUsage;
-    QString networkUp;
-    QString networkDown;
-    QString lastError;
-};
+#include <functional>
 
 class RemoteWorker;
+class EventLoopPool;
+class PollScheduler;
 
 class ServerManager : public QObject
 {
     Q_OBJECT
-    Q_PROPERTY(QVariantList servers READ servers NOTIFY serversChanged)
+    Q_PROPERTY(ServerListModel *servers READ servers CONSTANT)
+    // Percentiles and totals over the connected servers, per tag
+    Q_PROPERTY(FleetSummaryModel *fleet READ fleet CONSTANT)
+    // One long-lived ssh session per server instead of a process per poll;
+    // applies to servers connected afterwards
+    Q_PROPERTY(bool streamingMode READ streamingMode WRITE setStreamingMode NOTIFY streamingModeChanged)
+    // Streams from the uploaded ac-agent binary where the host allows it;
+    // off unless the user turns it on, since it runs a binary on the host
+    Q_PROPERTY(bool agentMode READ agentMode WRITE setAgentMode NOTIFY agentModeChanged)
+    // Runs connectAll() when the application starts
+    Q_PROPERTY(bool connectOnStartup READ connectOnStartup WRITE setConnectOnStartup NOTIFY connectOnStartupChanged)
+    Q_PROPERTY(bool connectingAll READ connectingAll NOTIFY connectAllChanged)
+    // Time from connectAll() until every server connected or failed, -1
+    // before the first run
+    Q_PROPERTY(qint64 connectAllMs READ connectAllMs NOTIFY connectAllChanged)
+    Q_PROPERTY(int connectAllFailures READ connectAllFailures NOTIFY connectAllChanged)
 
 public:
     explicit ServerManager(QObject *parent = nullptr);
     ~ServerManager();
 
-    QVariantList servers() const { return m_servers; }
-
+    ServerListModel *servers() const { return m_model; }
+    FleetSummaryModel *fleet() const { return m_fleet; }
+    bool streamingMode() const { return m_streamingMode; }
+    void setStreamingMode(bool enabled);
+    bool agentMode() const { return m_agentMode; }
+    void setAgentMode(bool enabled);
+    bool connectOnStartup() const { return m_connectOnStartup; }
+    void setConnectOnStartup(bool enabled);
+    bool connectingAll() const { return m_connectingAll; }
+    qint64 connectAllMs() const { return m_connectAllMs; }
+    int connectAllFailures() const { return m_connectAllFailures; }
+
+    // tags: comma-separated group names; pollInterval in seconds, 0 for
+    // the tags' interval or the default
     Q_INVOKABLE void addServer(const QString &name, const QString &host, int port,
-                                const QString &username, const QString &password, bool autoConnect = false);
+                                const QString &username, const QString &password, const QString &tags,
+                                int pollInterval, bool autoConnect = false);
+    // An empty password keeps the current one
     Q_INVOKABLE void updateServer(const QString &id, const QString &name, const QString &host, int port,
-                                   const QString &username, const QString &password);
+                                   const QString &username, const QString &password, const QString &tags,
+                                   int pollInterval);
     Q_INVOKABLE void removeServer(const QString &id);
     Q_INVOKABLE void connectToServer(const QString &id);
+    // Connects every disconnected server, a bounded number at a time;
+    // servers that failed before are retried
+    Q_INVOKABLE void connectAll();
     Q_INVOKABLE void disconnectFromServer(const QString &id);
     Q_INVOKABLE void refreshServer(const QString &id);
     Q_INVOKABLE void refreshAll();
     Q_INVOKABLE void pauseAll();
     Q_INVOKABLE void resumeAll();
     Q_INVOKABLE void copyToClipboard(const QString &text);
+    // Seconds between polls of the servers tagged so, 0 when not set; a
+    // server with several tags uses the shortest
+    Q_INVOKABLE int groupInterval(const QString &tag) const { return m_groupIntervals.value(tag, 0); }
+    Q_INVOKABLE void setGroupInterval(const QString &tag, int seconds);
+
+    // Workers connected afterwards run their commands through ac-fakehost
+    // with these options instead of ssh; for the fleet benchmark
+    void setFakeHosts(const QStringList &options);
+    PollScheduler *pollScheduler() const { return m_scheduler; }
 
 signals:
-    void serversChanged();
     void serverConnected(const QString &id);
     void serverDisconnected(const QString &id);
     void serverError(const QString &id, const QString &error);
     void serverStatsUpdated(const QString &id);
+    void streamingModeChanged();
+    void agentModeChanged();
+    void connectOnStartupChanged();
+    void connectAllChanged();
 
 private slots:
-    void onRemoteStatsReady(const QString &id, double cpu, double ram, double disk, 
-                           QString netUp, QString netDown);
+    void onRemoteStatsReady(const QString &id, double cpu, double ram, double disk,
+                           double netUp, double netDown, double diskRead, double diskWrite);
     void onConnectionError(const QString &id, const QString &error);
 
 private:
-    QVariantList m_servers;
-    QMap<QString, ServerInfo> m_serverMap;
+    ServerListModel *m_model = nullptr;
+    FleetSummaryModel *m_fleet = nullptr;
     QMap<QString, RemoteWorker*> m_workers;
-    QMap<QString, QThread*> m_threads;
+    // Workers share a few event-loop threads instead of one thread each
+    EventLoopPool *m_loops = nullptr;
+    // Spreads, caps and backs off the polls of all workers
+    PollScheduler *m_scheduler = nullptr;
+    QHash<QString, int> m_groupIntervals;
+    bool m_streamingMode = true;
+    bool m_agentMode = false;
+    bool m_fakeHosts = false;
+    QStringList m_fakeHostOptions;
+
+    // connectAll() pipeline: servers still to connect, and the ones
+    // connecting now
+    QStringList m_connectQueue;
+    QSet<QString> m_connecting;
+    int m_maxConcurrentConnects = 0;
+    bool m_connectOnStartup = false;
+    bool m_connectingAll = false;
+    QElapsedTimer m_connectAllClock;
+    qint64 m_connectAllMs = -1;
+    int m_connectAllFailures = 0;
 
     QString generateId() const;
-    QVariantMap serverToVariant(const ServerInfo &server) const;
+    static QStringList parseTags(const QString &tags);
+    int pollIntervalMs(const ServerInfo &server) const;
+    void startQueuedConnects();
+    void connectFinished(const QString &id, bool ok);
     void saveServers();
     void loadServers();
 };
 
-// Worker class for remote SSH operations
+// Worker class for remote SSH operations. Commands run as non-blocking
+// QProcess instances with a deadline, so many workers can share one thread.
 class RemoteWorker : public QObject
 {
     Q_OBJECT
@@ -86,21 +143,36 @@ public:
     explicit RemoteWorker(const QString &id, const QString &host, int port,
                          const QString &username, const QString &password,
                          QObject *parent = nullptr);
+    ~RemoteWorker();
+
+    // How commands reach the host: ssh, or a local ac-fakehost process
+    // that simulates one. Set before connect().
+    enum Transport { Ssh, FakeHost };
+    void setTransport(Transport transport, const QStringList &fakeHostOptions = QStringList());
 
     void setCredentials(const QString &host, int port, const QString &username, const QString &password);
+    // Streaming: one session stays open and answers a sample request on
+    // every tick, falling back to polling if the host cannot do it. Set
+    // before connect().
+    void setStreaming(bool enabled) { m_streaming = enabled; }
+    // Stream from ac-agent, uploaded once and cached on the host, instead
+    // of the shell sampler; needs streaming
+    void setAgent(bool enabled) { m_agentState = enabled ? AgentUnknown : AgentUnavailable; }
 
 public slots:
     void connect();
     void disconnect();
+    // One poll, as scheduled by PollScheduler; ends in pollFinished()
     void fetchStats();
-    void pauseStats();
-    void resumeStats();
 
 signals:
     void connected();
     void disconnected();
-    void statsReady(QString id, double cpu, double ram, double disk, QString netUp, QString netDown);
+    // Rates in bytes per second
+    void statsReady(QString id, double cpu, double ram, double disk, double netUp, double netDown,
+                    double diskRead, double diskWrite);
     void error(QString id, QString errorMsg);
+    void pollFinished(QString id, bool ok);
 
 private:
     QString m_id;
@@ -108,18 +180,66 @@ private:
     int m_port;
     QString m_username;
     QString m_password;
+    Transport m_transport;
+    QStringList m_fakeHostOptions;
     bool m_connected;
     quint64 m_prevBytesSent;
     quint64 m_prevBytesReceived;
-    QTimer *m_statsTimer;
+    bool m_pollPending;
+    QProcess *m_process; // command in flight, at most one
+
+    bool m_streaming;
+    QProcess *m_stream;
+    QStringList m_frame;
+    bool m_sampleRequested;
+    QElapsedTimer m_sampleClock;
+    int m_streamFailures;
+    bool m_streamDelivered;
+
+    // Raw /proc counters of the previous sample; rates are computed here
+    // over the host's own elapsed time
+    bool m_procSampling;
+    bool m_hasPrevSample;
+    ProcSample m_prevSample;
+    QElapsedTimer m_prevSampleClock;
+    QElapsedTimer m_prevLegacyClock;
+
+    enum AgentState { AgentUnknown, AgentDeploying, AgentReady, AgentUnavailable };
+    AgentState m_agentState;
+    QString m_agentPath;       // on the host, relative to the login directory
+    bool m_streamIsAgent;
+    bool m_agentGreeted;       // protocol magic seen on the current stream
+    QByteArray m_agentBuffer;
     
     bool isLocalhost() const;
 
-    QString executeRemoteCommand(const QString &command);
+    // done gets the command's output, or a message starting with "Error:"
+    using CommandCallback = std::function<void(const QString &output)>;
+    // input, if any, is written to the command's stdin
+    void runRemoteCommand(const QString &command, int timeoutMs, CommandCallback done,
+                          const QByteArray &input = QByteArray());
+    void abortRemoteCommand();
+    void closeControlMaster();
+    QString controlPath() const;
+    void hostCommand(const QString &command, QString &program, QStringList &args) const;
+    void onStatsOutput(const QString &output);
+    void finishPoll(bool ok);
+    bool onSampleFrame(const QStringList &lines);
+    void onSample(ProcSample sample);
+
+    void deployAgent();
+    void uploadAgent();
+    void onAgentFailed(const QString &reason);
+    void onAgentOutput();
+
+    void startStream();
+    void stopStream();
+    void onStreamReadyRead();
+    void onStreamFinished();
     double parseCpuUsage(const QString &output);
     double parseMemoryUsage(const QString &output);
     double parseDiskUsage(const QString &output);
-    void parseNetworkUsage(const QString &output, QString &up, QString &down);
+    void parseNetworkUsage(const QString &output, double &up, double &down);
 };
 
 #endif // SERVERMANAGER_H
@@ -0,0 +1,92 @@
+#ifndef TARGETWATCHER_H
+#define TARGETWATCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include "CleanupTargetModel.h"
+
+class QSocketNotifier;
+
+// Keeps cleanup target sizes current after a scan without rescanning.
+//
+// Every directory inside a target is tracked with the bytes of its own
+// files, seeded from the scan index written by the scan. Filesystem events
+// only mark directories dirty; a coalescing timer then re-measures just those
+// directories and reports the resulting target size deltas in one batch.
+//
+// fanotify filesystem marks are used when the process is allowed to set them
+// (CAP_SYS_ADMIN, kernel 5.9+); otherwise one inotify watch per directory is
+// added, capped at an eighth of fs.inotify.max_user_watches and at most 8192
+// watches; directories past the budget are not watched.
+class TargetWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TargetWatcher(QObject *parent = nullptr);
+    ~TargetWatcher();
+
+public slots:
+    void watchTargets(const QString &rootPath, const QList<CleanupTarget> &targets);
+    void unwatchTarget(const QString &path);
+    void stopWatching();
+
+signals:
+    void targetSizesChanged(const QHash<QString, qint64> &sizes);
+    void watchStateChanged(const QString &mode, int watchedTargets);
+
+private slots:
+    void onEventsReady();
+    void processPendingChanges();
+
+private:
+    enum Mode { ModeOff, ModeFanotify, ModeInotify };
+
+    struct WatchedDir {
+        QString target;
+        qint64 ownBytes = 0;
+        int wd = -1;
+        QByteArray handle; // fanotify file handle key
+    };
+
+    Mode m_mode = ModeOff;
+    int m_fd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QTimer *m_coalesceTimer = nullptr;
+
+    QMap<QString, WatchedDir> m_dirs; // sorted, so a subtree is a key range
+    QHash<QString, qint64> m_targetSizes;
+    QHash<int, QString> m_wdToDir;
+    QHash<QByteArray, QString> m_handleToDir;
+    QSet<qulonglong> m_markedFilesystems;
+    int m_watchBudget = 0;
+    bool m_budgetWarned = false;
+
+    QSet<QString> m_dirtyDirs;
+    QStringList m_createdDirs;
+    QStringList m_removedDirs;
+    QSet<QString> m_changedTargets;
+
+    bool openFanotify();
+    bool openInotify();
+    void closeNotifier();
+    bool registerDirectory(const QString &path, WatchedDir &dir);
+    void unregisterDirectory(const WatchedDir &dir);
+    void readFanotifyEvents();
+    void readInotifyEvents();
+    void queueEvent(const QString &dirPath, const QString &name, bool isDir, bool created, bool removed);
+    void markAllDirty();
+
+    void addDirectoryTree(const QString &path, const QString &target);
+    void removeDirectoryTree(const QString &path);
+    QString targetFor(const QString &path) const;
+
+    static qint64 measureOwnFiles(const QString &path, bool *exists = nullptr);
+    static int inotifyWatchBudget();
+};
+
+#endif // TARGETWATCHER_H
@@ -0,0 +1,66 @@
+// ac-agent: remote stats collector uploaded by RemoteWorker.
+//
+// Reads /proc with plain read(2) calls and answers every newline on stdin
+// with one binary sample frame on stdout (see AgentProtocol.h). It exits
+// when stdin closes, i.e. when the SSH session goes away. No Qt and no
+// allocation per sample, so it links statically and stays at a few
+// hundred KB of RSS.
+//
+//   ac-agent            serve sample requests on stdin
+//   ac-agent --once     print one frame and exit
+//   ac-agent --version  print the protocol magic
+
+#include "AgentProtocol.h"
+#include "ProcReader.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+namespace {
+bool writeAll(const char *data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t n = ::write(STDOUT_FILENO, data, size);
+        if (n <= 0) return false;
+        data += n;
+        size -= size_t(n);
+    }
+    return true;
+}
+
+bool writeSample(std::string &frame)
+{
+    AgentSample sample;
+    ProcReader::sample(sample);
+    frame.clear();
+    agentEncode(sample, frame);
+    return writeAll(frame.data(), frame.size());
+}
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && std::strcmp(argv[1], "--version") == 0) {
+        std::fputs(kAgentMagic, stdout);
+        return 0;
+    }
+
+    std::string frame;
+    frame.reserve(128);
+
+    if (!writeAll(kAgentMagic, kAgentMagicSize)) return 1;
+    if (argc > 1 && std::strcmp(argv[1], "--once") == 0) {
+        return writeSample(frame) ? 0 : 1;
+    }
+
+    char requests[64];
+    for (;;) {
+        const ssize_t n = ::read(STDIN_FILENO, requests, sizeof(requests));
+        if (n <= 0) break;
+        for (ssize_t i = 0; i < n; ++i) {
+            if (requests[i] == '\n' && !writeSample(frame)) return 1;
+        }
+    }
+    return 0;
+}
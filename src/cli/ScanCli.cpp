@@ -0,0 +1,224 @@
+// acscan: headless cleanup scan for scripts and fleets.
+//
+// Runs ScanWorker on one root and writes newline-delimited JSON to stdout:
+// one "target" record per cleanup target as soon as the scan finds it, then
+// a single "summary" record. Every record carries the host name, so output
+// from many hosts can be concatenated and aggregated as is.
+//
+// Memory stays bounded by the depth of the tree: no usage tree is built and
+// targets are written and dropped immediately. Only --index (the scan
+// index) and --snapshot (a 16-byte record per directory, sorted at the end)
+// hold something per directory, so with them memory grows with the tree.
+//
+// --largest N adds "largestFile" and "largestDir" records, the N largest of
+// each, before the summary. --snapshot FILE also writes a growth snapshot
+// of the scan; --diff OLD NEW compares two of them without scanning, as
+// "grower" and "shrinker" records followed by a "diffSummary".
+
+#include "DiskAnalyzer.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QSysInfo>
+#include <csignal>
+#include <cstdio>
+
+namespace {
+ScanWorker *g_worker = nullptr;
+
+void handleInterrupt(int)
+{
+    // cancel() only stores an atomic flag, which is async-signal-safe
+    if (g_worker) g_worker->cancel();
+}
+
+class RecordWriter
+{
+public:
+    RecordWriter()
+    {
+        m_out.open(stdout, QIODevice::WriteOnly | QIODevice::Unbuffered);
+    }
+
+    void write(QJsonObject record)
+    {
+        record.insert("host", m_host);
+        QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact);
+        line.append('\n');
+        m_out.write(line);
+    }
+
+private:
+    QFile m_out;
+    const QString m_host = QSysInfo::machineHostName();
+};
+
+int printDiff(const QString &olderFile, const QString &newerFile, int topCount)
+{
+    const SnapshotDiff diff = ScanSnapshot::diff(olderFile, newerFile, qMax(1, topCount));
+    if (!diff.ok) {
+        fprintf(stderr, "acscan: %s\n", qPrintable(diff.error));
+        return 1;
+    }
+
+    RecordWriter writer;
+    auto writeChanges = [&](const char *record, const QList<SnapshotChange> &changes) {
+        for (const SnapshotChange &change : changes) {
+            writer.write({
+                {"record", record},
+                {"path", QDir(diff.rootPath).filePath(change.path)},
+                {"oldSize", change.oldSize},
+                {"newSize", change.newSize},
+                {"delta", change.delta()}
+            });
+        }
+    };
+    writeChanges("grower", diff.growers);
+    writeChanges("shrinker", diff.shrinkers);
+
+    writer.write({
+        {"record", "diffSummary"},
+        {"root", diff.rootPath},
+        {"oldScanTime", QDateTime::fromMSecsSinceEpoch(diff.oldScanTimeMs).toString(Qt::ISODate)},
+        {"newScanTime", QDateTime::fromMSecsSinceEpoch(diff.newScanTimeMs).toString(Qt::ISODate)},
+        {"oldTotal", qint64(diff.oldTotal)},
+        {"newTotal", qint64(diff.newTotal)},
+        {"oldDirs", qint64(diff.oldDirCount)},
+        {"newDirs", qint64(diff.newDirCount)}
+    });
+    return 0;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("acscan");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Scan a directory tree for cleanup targets and print them as NDJSON.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("root", "Directory to scan (default: home directory).");
+    parser.addOption({"polite", "Idle I/O and CPU priority, rate cap, pause under I/O pressure."});
+    parser.addOption({"ops-per-second", "Metadata operation cap in polite mode.", "n", "2000"});
+    parser.addOption({"backend", "Stat backend: auto, sync or io_uring.", "name", "auto"});
+    parser.addOption({"index", "Use and update the scan index (faster rescans, memory grows with the tree)."});
+    parser.addOption({"largest", "Also list the N largest files and directories.", "n", "0"});
+    parser.addOption({"snapshot", "Write a growth snapshot of the scan to FILE.", "file"});
+    parser.addOption({"diff", "Compare snapshot OLD with the snapshot given as root, instead of scanning.", "old"});
+    parser.addOption({"top", "Directories listed per direction with --diff.", "n", "25"});
+    parser.addOption({{"v", "verbose"}, "Log progress to stderr."});
+    parser.process(app);
+
+    if (!parser.isSet("verbose")) {
+        QLoggingCategory::setFilterRules("*.debug=false");
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (parser.isSet("diff")) {
+        if (args.isEmpty()) {
+            fprintf(stderr, "acscan: --diff needs the newer snapshot as argument\n");
+            return 2;
+        }
+        return printDiff(parser.value("diff"), args.first(), parser.value("top").toInt());
+    }
+
+    const QString root = QDir(args.value(0, QDir::homePath())).absolutePath();
+    if (!QFileInfo(root).isDir()) {
+        fprintf(stderr, "acscan: %s is not a directory\n", qPrintable(root));
+        return 2;
+    }
+
+    DirectoryLister::Backend backend = DirectoryLister::Auto;
+    if (parser.value("backend") == "sync") {
+        backend = DirectoryLister::Sync;
+    } else if (parser.value("backend") == "io_uring") {
+        backend = DirectoryLister::IoUring;
+    }
+
+    ScanWorker worker;
+    worker.setScanPath(root);
+    worker.setBuildUsageTree(false);
+    worker.setUseIndex(parser.isSet("index"));
+    worker.setBatchSize(1);
+    worker.setIoBackend(backend);
+    worker.setPolite(parser.isSet("polite"));
+    worker.setPoliteOpsPerSecond(parser.value("ops-per-second").toInt());
+    worker.setSnapshotPath(parser.value("snapshot"));
+    worker.setLargestCount(parser.value("largest").toInt());
+
+    g_worker = &worker;
+    std::signal(SIGINT, handleInterrupt);
+    std::signal(SIGTERM, handleInterrupt);
+
+    RecordWriter writer;
+    qint64 targetCount = 0;
+    qint64 dirs = 0;
+    qint64 files = 0;
+    qint64 bytes = 0;
+    qint64 totalSavings = 0;
+    bool cancelled = false;
+
+    // Handled inline on the scanning thread (a separate one in polite mode,
+    // while this one waits), so a target is written before the walk moves on
+    QObject::connect(&worker, &ScanWorker::targetsFound, &worker, [&](const QList<CleanupTarget> &targets) {
+        for (const CleanupTarget &target : targets) {
+            writer.write({
+                {"record", "target"},
+                {"path", target.path},
+                {"type", target.type},
+                {"reason", target.reason},
+                {"size", target.size},
+                {"lastModified", target.lastModified.toString(Qt::ISODate)},
+                {"safe", target.isSafe}
+            });
+            ++targetCount;
+        }
+    }, Qt::DirectConnection);
+    QObject::connect(&worker, &ScanWorker::scanStats, &worker, [&](qint64 d, qint64 f, qint64 b, qint64) {
+        dirs = d;
+        files = f;
+        bytes = b;
+    }, Qt::DirectConnection);
+    QObject::connect(&worker, &ScanWorker::largestEntriesReady, &worker,
+                     [&](const QList<LargeEntry> &largestFiles, const QList<LargeEntry> &largestDirs) {
+        for (const LargeEntry &entry : largestFiles) {
+            writer.write({{"record", "largestFile"}, {"path", entry.path}, {"size", entry.size}});
+        }
+        for (const LargeEntry &entry : largestDirs) {
+            writer.write({{"record", "largestDir"}, {"path", entry.path}, {"size", entry.size}});
+        }
+    }, Qt::DirectConnection);
+    QObject::connect(&worker, &ScanWorker::scanFinished, &worker, [&](qint64 savings, bool wasCancelled) {
+        totalSavings = savings;
+        cancelled = wasCancelled;
+    }, Qt::DirectConnection);
+
+    QElapsedTimer timer;
+    timer.start();
+    worker.doScan();
+
+    writer.write({
+        {"record", "summary"},
+        {"root", root},
+        {"targets", targetCount},
+        {"totalSavings", totalSavings},
+        {"dirs", dirs},
+        {"files", files},
+        {"bytes", bytes},
+        {"elapsedMs", timer.elapsed()},
+        {"backend", DirectoryLister::backendName(worker.ioBackend())},
+        {"polite", parser.isSet("polite")},
+        {"cancelled", cancelled}
+    });
+
+    g_worker = nullptr;
+    return cancelled ? 130 : 0;
+}
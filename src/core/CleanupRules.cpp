@@ -0,0 +1,263 @@
+#include "CleanupRules.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QStandardPaths>
+#include <QVarLengthArray>
+#include <algorithm>
+
+namespace {
+bool hasWildcard(QStringView pattern)
+{
+    for (QChar c : pattern) {
+        if (c == '*' || c == '?' || c == '[') return true;
+    }
+    return false;
+}
+
+// Accepts plain byte counts or strings such as "512KB", "10 MB", "2GB"
+qint64 parseSize(const QJsonValue &value, qint64 fallback)
+{
+    if (value.isDouble()) return qint64(value.toDouble());
+    if (!value.isString()) return fallback;
+
+    QString text = value.toString().trimmed().toUpper();
+    qint64 unit = 1;
+    if (text.endsWith("GB")) {
+        unit = 1024LL * 1024 * 1024;
+    } else if (text.endsWith("MB")) {
+        unit = 1024LL * 1024;
+    } else if (text.endsWith("KB")) {
+        unit = 1024;
+    }
+    if (unit > 1) text.chop(2);
+    if (text.endsWith('B')) text.chop(1);
+
+    bool ok = false;
+    double number = text.trimmed().toDouble(&ok);
+    return ok ? qint64(number * unit) : fallback;
+}
+
+void addIndexed(QHash<QString, QList<int>> &hash, QList<int> &lengths, const QString &key, int rule)
+{
+    hash[key].append(rule);
+    if (!lengths.contains(key.size())) {
+        lengths.append(key.size());
+        std::sort(lengths.begin(), lengths.end());
+    }
+}
+}
+
+CleanupRules::CleanupRules()
+{
+    setRules(defaultRules());
+}
+
+CleanupRules CleanupRules::load()
+{
+    CleanupRules rules;
+    const QString path = configPath();
+    if (QFileInfo::exists(path)) {
+        QString error;
+        if (!rules.loadFromFile(path, &error)) {
+            qWarning() << "Ignoring cleanup rules in" << path << ":" << error;
+        }
+    }
+    return rules;
+}
+
+QString CleanupRules::configPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/cleanup-rules.json";
+}
+
+QList<CleanupRule> CleanupRules::defaultRules()
+{
+    CleanupRule node;
+    node.type = "Node.js Dependencies";
+    node.reason = "Can be regenerated with npm/yarn install";
+    node.names = {"node_modules"};
+
+    CleanupRule build;
+    build.type = "Build Artifacts";
+    build.reason = "Regenerable from source code";
+    build.names = {"build", "dist", "out", "target", ".next"};
+
+    CleanupRule cache;
+    cache.type = "Cache Files";
+    cache.reason = "Temporary cache data";
+    cache.names = {"cache", ".cache", "__pycache__"};
+
+    // Left behind when a trash-mode deletion was cancelled or interrupted
+    CleanupRule pending;
+    pending.type = "Pending Deletion";
+    pending.reason = "Moved aside by an unfinished delete";
+    pending.names = {".*.ac-deleting-*"};
+    pending.minSize = 0;
+
+    return {node, build, cache, pending};
+}
+
+bool CleanupRules::loadFromFile(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (error) *error = parseError.errorString();
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    QList<CleanupRule> rules;
+    for (const QJsonValue &value : root.value("rules").toArray()) {
+        const QJsonObject obj = value.toObject();
+
+        CleanupRule rule;
+        rule.type = obj.value("type").toString();
+        rule.reason = obj.value("reason").toString();
+        for (const QJsonValue &name : obj.value("names").toArray()) {
+            rule.names.append(name.toString());
+        }
+        for (const QJsonValue &marker : obj.value("markers").toArray()) {
+            rule.markers.append(marker.toString());
+        }
+        rule.minSize = parseSize(obj.value("minSize"), rule.minSize);
+        rule.minAgeDays = obj.value("minAgeDays").toInt(0);
+
+        if (rule.type.isEmpty() || rule.names.isEmpty()) {
+            if (error) *error = QString("rule %1 needs a type and at least one name").arg(rules.size());
+            return false;
+        }
+        rules.append(rule);
+    }
+
+    // Configured rules come first, and a name they list is dropped from the
+    // built-ins, so they can narrow a built-in name (e.g. "target" only
+    // beside Cargo.toml) instead of the built-in matching it anyway
+    if (!root.value("replaceDefaults").toBool(false)) {
+        QSet<QString> claimed;
+        for (const CleanupRule &rule : std::as_const(rules)) {
+            for (const QString &name : rule.names) claimed.insert(name);
+        }
+        for (CleanupRule rule : defaultRules()) {
+            rule.names.removeIf([&claimed](const QString &name) { return claimed.contains(name); });
+            if (!rule.names.isEmpty()) rules.append(rule);
+        }
+    }
+
+    setRules(rules);
+    return true;
+}
+
+void CleanupRules::setRules(const QList<CleanupRule> &rules)
+{
+    m_rules = rules;
+    compile();
+}
+
+void CleanupRules::compile()
+{
+    m_exact.clear();
+    m_prefixes.clear();
+    m_suffixes.clear();
+    m_prefixLengths.clear();
+    m_suffixLengths.clear();
+    m_globs.clear();
+
+    QStringList alternatives;
+    for (int i = 0; i < m_rules.size(); ++i) {
+        for (const QString &pattern : m_rules.at(i).names) {
+            if (pattern.isEmpty()) continue;
+
+            if (!hasWildcard(pattern)) {
+                m_exact[pattern].append(i);
+            } else if (pattern.endsWith('*') && !hasWildcard(QStringView(pattern).chopped(1))) {
+                addIndexed(m_prefixes, m_prefixLengths, pattern.chopped(1), i);
+            } else if (pattern.startsWith('*') && !hasWildcard(QStringView(pattern).sliced(1))) {
+                addIndexed(m_suffixes, m_suffixLengths, pattern.sliced(1), i);
+            } else {
+                const QString regex = QRegularExpression::wildcardToRegularExpression(
+                    pattern, QRegularExpression::UnanchoredWildcardConversion);
+                m_globs.append({QRegularExpression(QRegularExpression::anchoredPattern(regex)), i});
+                alternatives.append("(?:" + regex + ")");
+            }
+        }
+    }
+
+    m_combinedGlobs = QRegularExpression();
+    if (!alternatives.isEmpty()) {
+        m_combinedGlobs.setPattern(QRegularExpression::anchoredPattern(alternatives.join('|')));
+        m_combinedGlobs.optimize();
+    }
+}
+
+int CleanupRules::match(const QString &dirName, const QString &dirPath) const
+{
+    QVarLengthArray<int, 8> candidates;
+    auto collect = [&](const QHash<QString, QList<int>> &hash, const QString &key) {
+        auto it = hash.constFind(key);
+        if (it == hash.constEnd()) return;
+        for (int rule : it.value()) candidates.append(rule);
+    };
+
+    collect(m_exact, dirName);
+    for (int length : m_prefixLengths) {
+        if (length > dirName.size()) break;
+        collect(m_prefixes, dirName.left(length));
+    }
+    for (int length : m_suffixLengths) {
+        if (length > dirName.size()) break;
+        collect(m_suffixes, dirName.right(length));
+    }
+
+    // The combined expression says whether any glob matches; only then are
+    // the individual globs tried to find out which rules they belong to
+    if (!m_globs.isEmpty() && m_combinedGlobs.match(dirName).hasMatch()) {
+        for (const auto &glob : m_globs) {
+            if (glob.first.match(dirName).hasMatch()) candidates.append(glob.second);
+        }
+    }
+
+    if (candidates.isEmpty()) return -1;
+
+    // Config order decides between overlapping rules
+    std::sort(candidates.begin(), candidates.end());
+    for (int rule : candidates) {
+        if (accepts(m_rules.at(rule), dirPath)) return rule;
+    }
+    return -1;
+}
+
+bool CleanupRules::accepts(const CleanupRule &rule, const QString &dirPath) const
+{
+    if (!rule.markers.isEmpty()) {
+        const QDir dir(dirPath);
+        bool found = false;
+        for (const QString &marker : rule.markers) {
+            if (QFileInfo::exists(dir.filePath(marker))) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) return false;
+    }
+
+    if (rule.minAgeDays > 0) {
+        QDateTime cutoff = QDateTime::currentDateTime().addDays(-rule.minAgeDays);
+        if (QFileInfo(dirPath).lastModified() > cutoff) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,467 @@
+#include "CleanupTargetModel.h"
+#include <algorithm>
+#include <numeric>
+
+CleanupTargetModel::CleanupTargetModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int CleanupTargetModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return m_rows.size();
+}
+
+QVariant CleanupTargetModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+
+    const Row &row = m_rows.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case PathRole:
+        return row.path;
+    case TypeRole:
+        return m_typeNames.at(row.typeId);
+    case SizeRole:
+        return row.size;
+    case SizeFormattedRole:
+        return formatSize(row.size);
+    case LastModifiedRole:
+        return QDateTime::fromMSecsSinceEpoch(row.lastModifiedMs).toString("yyyy-MM-dd");
+    case IsSafeRole:
+        return row.isSafe;
+    case ReasonRole:
+        return row.reason;
+    case SelectedRole:
+        return row.selected;
+    case IsDeletingRole:
+        return row.deleting;
+    }
+    return QVariant();
+}
+
+bool CleanupTargetModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != SelectedRole || !index.isValid() || index.row() >= m_rows.size()) return false;
+
+    setSelected(index.row(), value.toBool());
+    return true;
+}
+
+Qt::ItemFlags CleanupTargetModel::flags(const QModelIndex &index) const
+{
+    return QAbstractListModel::flags(index) | Qt::ItemIsEditable;
+}
+
+QHash<int, QByteArray> CleanupTargetModel::roleNames() const
+{
+    return {
+        {PathRole, "path"},
+        {TypeRole, "type"},
+        {SizeRole, "size"},
+        {SizeFormattedRole, "sizeFormatted"},
+        {LastModifiedRole, "lastModified"},
+        {IsSafeRole, "isSafe"},
+        {ReasonRole, "reason"},
+        {SelectedRole, "selected"},
+        {IsDeletingRole, "isDeleting"}
+    };
+}
+
+CleanupTarget CleanupTargetModel::target(int row) const
+{
+    const Row &r = m_rows.at(row);
+
+    CleanupTarget target;
+    target.path = r.path;
+    target.type = m_typeNames.at(r.typeId);
+    target.size = r.size;
+    target.lastModified = QDateTime::fromMSecsSinceEpoch(r.lastModifiedMs);
+    target.isSafe = r.isSafe;
+    target.reason = r.reason;
+    return target;
+}
+
+void CleanupTargetModel::appendTargets(const QList<CleanupTarget> &targets)
+{
+    if (targets.isEmpty()) return;
+
+    // Arrival order is kept; the proxy places new rows in sort order
+    QList<Row> rows;
+    rows.reserve(targets.size());
+    for (const CleanupTarget &target : targets) {
+        rows.append(makeRow(target));
+    }
+
+    const int first = m_rows.size();
+    beginInsertRows(QModelIndex(), first, first + rows.size() - 1);
+    for (Row &row : rows) {
+        m_rowOfPath.insert(row.path, m_rows.size());
+        m_totalSize += row.size;
+        m_rows.append(std::move(row));
+    }
+    endInsertRows();
+
+    emit countChanged();
+    emit totalSizeChanged();
+}
+
+void CleanupTargetModel::setTargets(const QList<CleanupTarget> &targets)
+{
+    beginResetModel();
+    m_rows.clear();
+    m_rowOfPath.clear();
+    m_totalSize = 0;
+    m_selectedCount = 0;
+    m_selectedSize = 0;
+    m_typeNames.clear();
+    m_typeIds.clear();
+    m_typeRanks.clear();
+
+    m_rows.reserve(targets.size());
+    for (const CleanupTarget &target : targets) {
+        Row row = makeRow(target);
+        m_rowOfPath.insert(row.path, m_rows.size());
+        m_totalSize += row.size;
+        m_rows.append(std::move(row));
+    }
+    endResetModel();
+
+    emit countChanged();
+    emit totalSizeChanged();
+    emit selectionChanged();
+    emit typesChanged();
+}
+
+void CleanupTargetModel::updateTargetSizes(const QHash<QString, qint64> &sizes)
+{
+    if (sizes.isEmpty()) return;
+
+    const QList<int> roles = {SizeRole, SizeFormattedRole};
+    bool selectionTouched = false;
+    bool changed = false;
+    for (auto it = sizes.constBegin(); it != sizes.constEnd(); ++it) {
+        int row = rowOf(it.key());
+        if (row < 0 || m_rows[row].size == it.value()) continue;
+
+        Row &r = m_rows[row];
+        m_totalSize += it.value() - r.size;
+        if (r.selected) {
+            m_selectedSize += it.value() - r.size;
+            selectionTouched = true;
+        }
+        r.size = it.value();
+        changed = true;
+        emit dataChanged(index(row), index(row), roles);
+    }
+    if (!changed) return;
+
+    emit totalSizeChanged();
+    if (selectionTouched) emit selectionChanged();
+    emit sizesUpdated();
+}
+
+void CleanupTargetModel::removeTarget(int row)
+{
+    if (row < 0 || row >= m_rows.size()) return;
+
+    const Row &removed = m_rows.at(row);
+    m_totalSize -= removed.size;
+    const bool wasSelected = removed.selected;
+    if (wasSelected) {
+        --m_selectedCount;
+        m_selectedSize -= removed.size;
+    }
+    m_rowOfPath.remove(removed.path);
+
+    // Fill the hole with the last row instead of shifting everything after
+    // it; the proxy only has to re-place that one row
+    const int last = m_rows.size() - 1;
+    if (row != last) {
+        m_rows[row] = m_rows.at(last);
+        m_rowOfPath.insert(m_rows.at(row).path, row);
+        emit dataChanged(index(row), index(row));
+    }
+
+    beginRemoveRows(QModelIndex(), last, last);
+    m_rows.removeLast();
+    endRemoveRows();
+
+    emit countChanged();
+    emit totalSizeChanged();
+    if (wasSelected) emit selectionChanged();
+}
+
+void CleanupTargetModel::clear()
+{
+    if (m_rows.isEmpty()) return;
+
+    beginResetModel();
+    m_rows.clear();
+    m_rowOfPath.clear();
+    m_totalSize = 0;
+    m_selectedCount = 0;
+    m_selectedSize = 0;
+    endResetModel();
+
+    emit countChanged();
+    emit totalSizeChanged();
+    emit selectionChanged();
+}
+
+QStringList CleanupTargetModel::selectedPaths() const
+{
+    QList<const Row *> selected;
+    for (const Row &row : m_rows) {
+        if (row.selected) selected.append(&row);
+    }
+    std::sort(selected.begin(), selected.end(), [](const Row *a, const Row *b) { return a->size > b->size; });
+
+    QStringList paths;
+    for (const Row *row : std::as_const(selected)) {
+        paths.append(row->path);
+    }
+    return paths;
+}
+
+void CleanupTargetModel::setSelected(int row, bool selected)
+{
+    if (row < 0 || row >= m_rows.size()) return;
+
+    Row &r = m_rows[row];
+    if (r.selected == selected) return;
+
+    r.selected = selected;
+    m_selectedCount += selected ? 1 : -1;
+    m_selectedSize += selected ? r.size : -r.size;
+    emit dataChanged(index(row), index(row), {SelectedRole});
+    emit selectionChanged();
+}
+
+void CleanupTargetModel::clearSelection()
+{
+    if (m_selectedCount == 0) return;
+
+    for (Row &row : m_rows) {
+        row.selected = false;
+    }
+    m_selectedCount = 0;
+    m_selectedSize = 0;
+    emit dataChanged(index(0), index(m_rows.size() - 1), {SelectedRole});
+    emit selectionChanged();
+}
+
+bool CleanupTargetModel::isDeleting(const QString &path) const
+{
+    int row = rowOf(path);
+    return row >= 0 && m_rows.at(row).deleting;
+}
+
+void CleanupTargetModel::setDeleting(const QString &path, bool deleting)
+{
+    int row = rowOf(path);
+    if (row < 0 || m_rows.at(row).deleting == deleting) return;
+
+    m_rows[row].deleting = deleting;
+    emit dataChanged(index(row), index(row), {IsDeletingRole});
+}
+
+CleanupTargetModel::Row CleanupTargetModel::makeRow(const CleanupTarget &target)
+{
+    Row row;
+    row.path = target.path;
+    row.reason = target.reason;
+    row.size = target.size;
+    row.lastModifiedMs = target.lastModified.isValid() ? target.lastModified.toMSecsSinceEpoch() : 0;
+    row.typeId = internType(target.type);
+    row.isSafe = target.isSafe;
+    return row;
+}
+
+int CleanupTargetModel::internType(const QString &type)
+{
+    auto it = m_typeIds.constFind(type);
+    if (it != m_typeIds.constEnd()) return it.value();
+
+    const int id = m_typeNames.size();
+    m_typeNames.append(type);
+    m_typeIds.insert(type, id);
+
+    // Only a handful of types exist, so ranks are simply recomputed. Adding
+    // a type never changes the relative order of the existing ones.
+    QList<int> order(m_typeNames.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_typeNames.at(a).localeAwareCompare(m_typeNames.at(b)) < 0;
+    });
+    m_typeRanks.resize(order.size());
+    for (int rank = 0; rank < order.size(); ++rank) {
+        m_typeRanks[order.at(rank)] = rank;
+    }
+
+    emit typesChanged();
+    return id;
+}
+
+QString CleanupTargetModel::formatSize(qint64 bytes)
+{
+    if (bytes < 1024) {
+        return QString::number(bytes) + " B";
+    } else if (bytes < 1024 * 1024) {
+        return QString::number(bytes / 1024.0, 'f', 1) + " KB";
+    } else if (bytes < 1024 * 1024 * 1024) {
+        return QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + " MB";
+    } else {
+        return QString::number(bytes / (1024.0 * 1024.0 * 1024.0), 'f', 2) + " GB";
+    }
+}
+
+// ============ CleanupTargetProxyModel Implementation ============
+
+CleanupTargetProxyModel::CleanupTargetProxyModel(CleanupTargetModel *source, QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_source(source)
+{
+    setSourceModel(source);
+
+    // lessThan() and filterAcceptsRow() ignore these roles; they only decide
+    // which dataChanged() signals re-place a row. Size and selection updates
+    // leave rows where they are, a swapped-in row (all roles) is re-placed.
+    setSortRole(CleanupTargetModel::PathRole);
+    setFilterRole(CleanupTargetModel::PathRole);
+    setDynamicSortFilter(true);
+    applySort();
+
+    connect(this, &QAbstractItemModel::rowsInserted, this, &CleanupTargetProxyModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &CleanupTargetProxyModel::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &CleanupTargetProxyModel::countChanged);
+    connect(this, &QAbstractItemModel::layoutChanged, this, &CleanupTargetProxyModel::countChanged);
+
+    // Size updates do not re-place rows, but the size filter must see them
+    connect(source, &CleanupTargetModel::sizesUpdated, this, [this]() {
+        if (m_minSize > 0) invalidateFilter();
+    });
+
+    // Type ids are assigned as types first appear
+    connect(source, &CleanupTargetModel::typesChanged, this, [this]() {
+        if (m_typeFilter.isEmpty()) return;
+        int id = m_source->typeId(m_typeFilter);
+        if (id != m_typeFilterId) {
+            m_typeFilterId = id;
+            invalidateFilter();
+        }
+    });
+}
+
+QString CleanupTargetProxyModel::sortKey() const
+{
+    switch (m_sortKey) {
+    case SortByDate:
+        return "date";
+    case SortByType:
+        return "type";
+    case SortBySize:
+        break;
+    }
+    return "size";
+}
+
+void CleanupTargetProxyModel::setSortKey(const QString &key)
+{
+    SortKey sortKey = SortBySize;
+    if (key == "date") {
+        sortKey = SortByDate;
+    } else if (key == "type") {
+        sortKey = SortByType;
+    }
+    if (sortKey == m_sortKey) return;
+
+    m_sortKey = sortKey;
+    // Same column and order, so sort() alone would be a no-op
+    invalidate();
+    emit sortChanged();
+}
+
+void CleanupTargetProxyModel::setSortAscending(bool ascending)
+{
+    if (ascending == m_sortAscending) return;
+
+    m_sortAscending = ascending;
+    applySort();
+    emit sortChanged();
+}
+
+void CleanupTargetProxyModel::setTypeFilter(const QString &type)
+{
+    if (type == m_typeFilter) return;
+
+    m_typeFilter = type;
+    m_typeFilterId = type.isEmpty() ? -1 : m_source->typeId(type);
+    invalidateFilter();
+    emit filterChanged();
+}
+
+void CleanupTargetProxyModel::setMinSize(qint64 bytes)
+{
+    if (bytes == m_minSize) return;
+
+    m_minSize = bytes;
+    invalidateFilter();
+    emit filterChanged();
+}
+
+void CleanupTargetProxyModel::setSafeOnly(bool safeOnly)
+{
+    if (safeOnly == m_safeOnly) return;
+
+    m_safeOnly = safeOnly;
+    invalidateFilter();
+    emit filterChanged();
+}
+
+void CleanupTargetProxyModel::setPathFilter(const QString &text)
+{
+    if (text == m_pathFilter) return;
+
+    m_pathFilter = text;
+    invalidateFilter();
+    emit filterChanged();
+}
+
+bool CleanupTargetProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    const int l = left.row();
+    const int r = right.row();
+
+    switch (m_sortKey) {
+    case SortBySize:
+        return m_source->sizeAt(l) < m_source->sizeAt(r);
+    case SortByDate:
+        return m_source->lastModifiedAt(l) < m_source->lastModifiedAt(r);
+    case SortByType:
+        return m_source->typeRankAt(l) < m_source->typeRankAt(r);
+    }
+    return false;
+}
+
+bool CleanupTargetProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+
+    if (!m_typeFilter.isEmpty() && m_source->typeIdAt(sourceRow) != m_typeFilterId) return false;
+    if (m_minSize > 0 && m_source->sizeAt(sourceRow) < m_minSize) return false;
+    if (m_safeOnly && !m_source->isSafeAt(sourceRow)) return false;
+    if (!m_pathFilter.isEmpty() && !m_source->pathAt(sourceRow).contains(m_pathFilter, Qt::CaseInsensitive)) {
+        return false;
+    }
+    return true;
+}
+
+void CleanupTargetProxyModel::applySort()
+{
+    sort(0, m_sortAscending ? Qt::AscendingOrder : Qt::DescendingOrder);
+}
@@ -0,0 +1,88 @@
+#include "DDSketch.h"
+#include <cmath>
+
+DDSketch::DDSketch(double relativeAccuracy)
+    : m_accuracy(relativeAccuracy)
+    , m_gamma((1.0 + relativeAccuracy) / (1.0 - relativeAccuracy))
+    , m_logGamma(std::log(m_gamma))
+{
+}
+
+void DDSketch::add(double value)
+{
+    ++m_count;
+    if (value <= kMinValue) {
+        ++m_zeroCount;
+        return;
+    }
+    ++bucket(indexOf(value));
+}
+
+void DDSketch::remove(double value)
+{
+    if (m_count == 0) return;
+    --m_count;
+    if (value <= kMinValue) {
+        --m_zeroCount;
+        return;
+    }
+    --bucket(indexOf(value));
+}
+
+void DDSketch::merge(const DDSketch &other)
+{
+    m_count += other.m_count;
+    m_zeroCount += other.m_zeroCount;
+    for (size_t i = 0; i < other.m_buckets.size(); ++i) {
+        if (other.m_buckets[i] != 0) bucket(other.m_offset + int(i)) += other.m_buckets[i];
+    }
+}
+
+void DDSketch::clear()
+{
+    m_count = 0;
+    m_zeroCount = 0;
+    m_offset = 0;
+    m_buckets.clear();
+}
+
+double DDSketch::quantile(double q) const
+{
+    if (m_count == 0) return 0.0;
+
+    // Rank of the wanted value, counting from 0
+    const qint64 rank = qint64(qBound(0.0, q, 1.0) * (m_count - 1));
+    qint64 seen = m_zeroCount;
+    if (rank < seen) return 0.0;
+
+    for (size_t i = 0; i < m_buckets.size(); ++i) {
+        seen += m_buckets[i];
+        if (rank < seen) return valueOf(m_offset + int(i));
+    }
+    return valueOf(m_offset + int(m_buckets.size()) - 1);
+}
+
+int DDSketch::indexOf(double value) const
+{
+    return int(std::ceil(std::log(value) / m_logGamma));
+}
+
+double DDSketch::valueOf(int index) const
+{
+    // Middle of the bucket (gamma^(i-1), gamma^i] in relative terms
+    return 2.0 * std::pow(m_gamma, index) / (m_gamma + 1.0);
+}
+
+qint64 &DDSketch::bucket(int index)
+{
+    if (m_buckets.empty()) {
+        m_offset = index;
+        m_buckets.resize(1, 0);
+    } else if (index < m_offset) {
+        m_buckets.insert(m_buckets.begin(), size_t(m_offset - index), 0);
+        m_offset = index;
+    } else if (index >= m_offset + int(m_buckets.size())) {
+        m_buckets.resize(size_t(index - m_offset + 1), 0);
+    }
+    return m_buckets[size_t(index - m_offset)];
+}
@@ -0,0 +1,271 @@
+#include "DeletionEngine.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+
+#ifdef Q_OS_UNIX
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr int kProgressIntervalMs = 100;
+constexpr int kMaxWorkers = 8;
+}
+
+// A directory being emptied. It is removed from its parent once its own
+// listing and every child directory are done.
+struct DeletionEngine::DirNode {
+    int fd = -1;
+    QByteArray name;             // entry name inside the parent
+    DirNode *parent = nullptr;
+    std::atomic<int> pending{1}; // own listing + one per open child
+};
+
+DeletionEngine::DeletionEngine(QObject *parent)
+    : QObject(parent)
+{
+    // Unlinking is metadata bound; a few threads keep the journal busy
+    // without starving the rest of the system
+    m_pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), kMaxWorkers));
+}
+
+DeletionEngine::~DeletionEngine()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void DeletionEngine::enqueue(const QStringList &paths, bool useTrash)
+{
+    QList<Job> jobs;
+    for (const QString &path : paths) {
+        Job job;
+        job.path = path;
+        job.originalPath = path;
+
+        if (useTrash) {
+            // Renaming within the parent keeps it on the same filesystem
+            QFileInfo info(path);
+            const QString trashed = info.dir().filePath("." + info.fileName() + trashMarker()
+                                                        + QString::number(QDateTime::currentMSecsSinceEpoch()));
+            if (QDir().rename(path, trashed)) {
+                job.path = trashed;
+                job.trashed = true;
+                emit targetRemoved(path);
+            } else {
+                qWarning() << "Could not move" << path << "aside, deleting in place";
+            }
+        }
+        jobs.append(job);
+    }
+    if (jobs.isEmpty()) return;
+
+    QMutexLocker locker(&m_mutex);
+    m_queue.append(jobs);
+    if (!m_running) {
+        m_running = true;
+        QMetaObject::invokeMethod(this, "processQueue", Qt::QueuedConnection);
+    }
+}
+
+void DeletionEngine::cancel()
+{
+    // Targets already moved aside stay hidden; the built-in cleanup rule
+    // for pending deletions finds them on the next scan
+    QMutexLocker locker(&m_mutex);
+    m_queue.clear();
+    if (m_running) {
+        m_cancelRequested = true;
+    }
+}
+
+void DeletionEngine::processQueue()
+{
+    m_bytesFreed = 0;
+    m_filesRemoved = 0;
+    m_sessionCancelled = false;
+
+    forever {
+        Job job;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_cancelRequested) {
+                m_sessionCancelled = true;
+                m_cancelRequested = false;
+            }
+            if (m_queue.isEmpty()) {
+                m_running = false;
+                break;
+            }
+            job = m_queue.takeFirst();
+        }
+
+        m_errors = 0;
+        m_firstError = 0;
+        qDebug() << "Deleting:" << job.path;
+
+        if (removeTree(job.path)) {
+            if (!job.trashed) emit targetRemoved(job.originalPath);
+        } else if (!m_cancelRequested) {
+            emit deletionFailed(job.originalPath, m_firstError ? qt_error_string(m_firstError)
+                                                               : QString("Could not remove all files"));
+        }
+        reportProgress();
+    }
+
+    emit idle(m_bytesFreed, m_filesRemoved, m_sessionCancelled);
+}
+
+bool DeletionEngine::removeTree(const QString &path)
+{
+#ifdef Q_OS_UNIX
+    QFileInfo info(path);
+    const QByteArray parentPath = QFile::encodeName(info.absolutePath());
+    const QByteArray name = QFile::encodeName(info.fileName());
+
+    int parentFd = ::open(parentPath.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (parentFd < 0) {
+        recordError(errno);
+        return false;
+    }
+
+    int fd = ::openat(parentFd, name.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        // Not a directory (or a symlink to one): unlink just the entry
+        bool ok = (errno == ENOTDIR || errno == ELOOP) && ::unlinkat(parentFd, name.constData(), 0) == 0;
+        if (!ok) recordError(errno);
+        ::close(parentFd);
+        return ok;
+    }
+
+    // The anchor keeps the parent descriptor open until the target itself
+    // has been removed from it
+    DirNode *anchor = new DirNode;
+    anchor->fd = parentFd;
+    DirNode *root = new DirNode;
+    root->fd = fd;
+    root->name = name;
+    root->parent = anchor;
+
+    m_pool.start([this, root]() { processDirectory(root); });
+    while (!m_pool.waitForDone(kProgressIntervalMs)) {
+        reportProgress();
+    }
+
+    return m_errors == 0 && !m_cancelRequested;
+#else
+    QDir dir(path);
+    bool ok = dir.removeRecursively();
+    if (!ok) recordError(0);
+    return ok;
+#endif
+}
+
+void DeletionEngine::processDirectory(DirNode *node)
+{
+#ifdef Q_OS_UNIX
+    // The stream gets its own descriptor; node->fd stays valid for the
+    // *at() calls and for children until the node is finished
+    int streamFd = ::dup(node->fd);
+    DIR *dir = streamFd >= 0 ? ::fdopendir(streamFd) : nullptr;
+    if (!dir) {
+        recordError(errno);
+        if (streamFd >= 0) ::close(streamFd);
+        finishDirectory(node);
+        return;
+    }
+
+    while (!m_cancelRequested) {
+        struct dirent *entry = ::readdir(dir);
+        if (!entry) break;
+
+        const char *name = entry->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+        struct stat sb;
+        bool haveStat = false;
+        bool isDir = entry->d_type == DT_DIR;
+        if (entry->d_type == DT_UNKNOWN && ::fstatat(node->fd, name, &sb, AT_SYMLINK_NOFOLLOW) == 0) {
+            haveStat = true;
+            isDir = S_ISDIR(sb.st_mode);
+        }
+
+        if (isDir) {
+            int childFd = ::openat(node->fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (childFd < 0) {
+                recordError(errno);
+                continue;
+            }
+
+            DirNode *child = new DirNode;
+            child->fd = childFd;
+            child->name = name;
+            child->parent = node;
+            ++node->pending;
+
+            // Hand the subtree to an idle thread, otherwise descend here
+            if (m_pool.activeThreadCount() < m_pool.maxThreadCount()) {
+                m_pool.start([this, child]() { processDirectory(child); });
+            } else {
+                processDirectory(child);
+            }
+            continue;
+        }
+
+        if (!haveStat) {
+            haveStat = ::fstatat(node->fd, name, &sb, AT_SYMLINK_NOFOLLOW) == 0;
+        }
+        if (::unlinkat(node->fd, name, 0) == 0) {
+            ++m_filesRemoved;
+            if (haveStat && S_ISREG(sb.st_mode)) m_bytesFreed += sb.st_size;
+        } else {
+            recordError(errno);
+        }
+    }
+
+    ::closedir(dir);
+#endif
+    finishDirectory(node);
+}
+
+void DeletionEngine::finishDirectory(DirNode *node)
+{
+    // Children finish in any order; whoever drops the count to zero removes
+    // the directory and passes the completion up to its parent
+    while (node && --node->pending == 0) {
+        DirNode *parent = node->parent;
+#ifdef Q_OS_UNIX
+        ::close(node->fd);
+        if (parent && ::unlinkat(parent->fd, node->name.constData(), AT_REMOVEDIR) != 0) {
+            // A cancelled or failed subtree leaves its parents non-empty
+            if (!m_cancelRequested) recordError(errno);
+        }
+#endif
+        delete node;
+        node = parent;
+    }
+}
+
+void DeletionEngine::recordError(int error)
+{
+    int expected = 0;
+    m_firstError.compare_exchange_strong(expected, error);
+    ++m_errors;
+}
+
+void DeletionEngine::reportProgress()
+{
+    int queued;
+    {
+        QMutexLocker locker(&m_mutex);
+        queued = m_queue.size();
+    }
+    emit progress(m_bytesFreed, m_filesRemoved, queued);
+}
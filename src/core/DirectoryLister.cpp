@@ -0,0 +1,308 @@
+#include "DirectoryLister.h"
+#include <QDebug>
+#include <QDirIterator>
+#include <QFile>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef AC_HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+namespace {
+constexpr int kCancelCheckInterval = 4096;
+#ifdef AC_HAVE_LIBURING
+// Submission queue depth; enough to keep NVMe and NFS busy without pinning
+// much memory
+constexpr unsigned kRingEntries = 256;
+#endif
+}
+
+DirectoryLister::DirectoryLister()
+{
+}
+
+DirectoryLister::~DirectoryLister()
+{
+#ifdef AC_HAVE_LIBURING
+    tearDownRing();
+#endif
+}
+
+bool DirectoryLister::isIoUringSupported()
+{
+#ifdef AC_HAVE_LIBURING
+    // Seccomp filters and older kernels refuse rings or statx on them, so
+    // this is probed once rather than assumed from the build
+    static const bool supported = []() {
+        DirectoryLister lister;
+        return lister.setUpRing();
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+QString DirectoryLister::backendName(Backend backend)
+{
+    switch (backend) {
+    case Sync:
+        return "sync";
+    case IoUring:
+        return "io_uring";
+    case Auto:
+        break;
+    }
+    return "auto";
+}
+
+void DirectoryLister::setBackend(Backend backend)
+{
+    if (backend == m_requested && m_configured) return;
+    m_requested = backend;
+    m_configured = false;
+}
+
+DirectoryLister::Backend DirectoryLister::activeBackend() const
+{
+#ifdef AC_HAVE_LIBURING
+    if (!m_configured) return m_requested;
+    return m_ring ? IoUring : Sync;
+#else
+    return Sync;
+#endif
+}
+
+void DirectoryLister::configure()
+{
+    m_configured = true;
+#ifdef AC_HAVE_LIBURING
+    tearDownRing();
+    if (m_requested == Sync) return;
+    if (!setUpRing() && m_requested == IoUring) {
+        qWarning() << "io_uring is not available, scanning with synchronous stat";
+    }
+#else
+    if (m_requested == IoUring) {
+        qWarning() << "Built without liburing, scanning with synchronous stat";
+    }
+#endif
+}
+
+bool DirectoryLister::list(const QString &path, QList<Entry> &entries)
+{
+    entries.clear();
+    if (!m_configured) configure();
+
+#ifdef Q_OS_UNIX
+    const QByteArray encoded = QFile::encodeName(path);
+    int dirFd = -1;
+#ifdef O_NOATIME
+    // Only the owner (or CAP_FOWNER) may use O_NOATIME
+    if (m_noAtime) dirFd = ::open(encoded.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOATIME);
+#endif
+    if (dirFd < 0) dirFd = ::open(encoded.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) return false;
+
+    bool ok = readNames(dirFd);
+    if (ok) {
+#ifdef AC_HAVE_LIBURING
+        if (!m_ring || !statWithRing(dirFd, entries))
+#endif
+            statSync(dirFd, entries);
+    }
+    ::close(dirFd);
+    return ok;
+#else
+    QDirIterator it(path, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    int count = 0;
+    while (it.hasNext()) {
+        const QFileInfo info = it.nextFileInfo();
+        // Never follow links: they would double count or loop
+        if (info.isSymLink()) continue;
+
+        Entry entry;
+        entry.name = info.fileName();
+        entry.isDir = info.isDir();
+        entry.size = entry.isDir ? 0 : info.size();
+        entries.append(entry);
+        if (++count % kCancelCheckInterval == 0 && isCancelled()) break;
+    }
+    return true;
+#endif
+}
+
+bool DirectoryLister::readNames(int dirFd)
+{
+    m_names.clear();
+#ifdef Q_OS_UNIX
+    // The stream gets its own descriptor; dirFd stays open for the *at() calls
+    int streamFd = ::dup(dirFd);
+    DIR *dir = streamFd >= 0 ? ::fdopendir(streamFd) : nullptr;
+    if (!dir) {
+        if (streamFd >= 0) ::close(streamFd);
+        return false;
+    }
+
+    while (struct dirent *entry = ::readdir(dir)) {
+        const char *name = entry->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+        // Never follow links: they would double count or loop
+        if (entry->d_type == DT_LNK) continue;
+
+        Name item;
+        item.name = QByteArray(name);
+        item.isDir = entry->d_type == DT_DIR;
+        // Directories need no stat; DT_UNKNOWN is resolved by the stat
+        item.needsStat = !item.isDir;
+        m_names.append(std::move(item));
+
+        if (m_names.size() % kCancelCheckInterval == 0 && isCancelled()) break;
+    }
+    ::closedir(dir);
+#else
+    Q_UNUSED(dirFd);
+#endif
+    return true;
+}
+
+void DirectoryLister::statSync(int dirFd, QList<Entry> &entries)
+{
+#ifdef Q_OS_UNIX
+    entries.reserve(m_names.size());
+    int count = 0;
+    for (const Name &item : std::as_const(m_names)) {
+        Entry entry;
+        entry.name = QFile::decodeName(item.name);
+        entry.isDir = item.isDir;
+
+        if (item.needsStat) {
+            struct stat sb;
+            if (::fstatat(dirFd, item.name.constData(), &sb, AT_SYMLINK_NOFOLLOW) != 0) continue;
+            if (S_ISLNK(sb.st_mode)) continue;
+            entry.isDir = S_ISDIR(sb.st_mode);
+            entry.size = entry.isDir ? 0 : qint64(sb.st_size);
+        }
+        entries.append(std::move(entry));
+
+        if (++count % kCancelCheckInterval == 0 && isCancelled()) break;
+    }
+#else
+    Q_UNUSED(dirFd);
+    Q_UNUSED(entries);
+#endif
+}
+
+#ifdef AC_HAVE_LIBURING
+bool DirectoryLister::setUpRing()
+{
+    tearDownRing();
+
+    m_ring = new io_uring;
+    if (io_uring_queue_init(kRingEntries, m_ring, 0) < 0) {
+        delete m_ring;
+        m_ring = nullptr;
+        return false;
+    }
+
+    io_uring_probe *probe = io_uring_get_probe_ring(m_ring);
+    const bool hasStatx = probe && io_uring_opcode_supported(probe, IORING_OP_STATX);
+    if (probe) io_uring_free_probe(probe);
+    if (!hasStatx) {
+        tearDownRing();
+        return false;
+    }
+    return true;
+}
+
+void DirectoryLister::tearDownRing()
+{
+    if (!m_ring) return;
+    io_uring_queue_exit(m_ring);
+    delete m_ring;
+    m_ring = nullptr;
+}
+
+bool DirectoryLister::statWithRing(int dirFd, QList<Entry> &entries)
+{
+    entries.reserve(m_names.size());
+
+    // Directories are known from d_type; only the rest go through the ring
+    std::vector<int> pending;
+    pending.reserve(size_t(m_names.size()));
+    for (int i = 0; i < m_names.size(); ++i) {
+        const Name &item = m_names.at(i);
+        if (item.needsStat) {
+            pending.push_back(i);
+        } else {
+            Entry entry;
+            entry.name = QFile::decodeName(item.name);
+            entry.isDir = true;
+            entries.append(std::move(entry));
+        }
+    }
+    if (pending.empty()) return true;
+
+    // Names and result buffers are members so they stay valid for requests
+    // still in flight even if this returns early
+    m_statBuffer.resize(qsizetype(pending.size() * sizeof(struct statx)));
+    struct statx *results = reinterpret_cast<struct statx *>(m_statBuffer.data());
+    size_t submitted = 0;
+    size_t completed = 0;
+    bool stopSubmitting = false;
+
+    while (completed < submitted || (!stopSubmitting && submitted < pending.size())) {
+        while (!stopSubmitting && submitted < pending.size()) {
+            io_uring_sqe *sqe = io_uring_get_sqe(m_ring);
+            if (!sqe) break;
+            const Name &item = m_names.at(pending[submitted]);
+            io_uring_prep_statx(sqe, dirFd, item.name.constData(), AT_SYMLINK_NOFOLLOW,
+                                STATX_TYPE | STATX_SIZE, &results[submitted]);
+            io_uring_sqe_set_data64(sqe, submitted);
+            ++submitted;
+        }
+
+        int ret = io_uring_submit_and_wait(m_ring, 1);
+        if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+            // The ring is unusable; the caller redoes this directory
+            // synchronously and later directories skip the ring
+            qWarning() << "io_uring submit failed:" << qt_error_string(-ret) << "- falling back to sync stat";
+            tearDownRing();
+            entries.clear();
+            return false;
+        }
+
+        unsigned head;
+        unsigned reaped = 0;
+        io_uring_cqe *cqe;
+        io_uring_for_each_cqe(m_ring, head, cqe) {
+            ++reaped;
+            const size_t slot = size_t(io_uring_cqe_get_data64(cqe));
+            if (cqe->res < 0) continue; // vanished since readdir
+
+            const struct statx &st = results[slot];
+            if (S_ISLNK(st.stx_mode)) continue;
+
+            Entry entry;
+            entry.name = QFile::decodeName(m_names.at(pending[slot]).name);
+            entry.isDir = S_ISDIR(st.stx_mode);
+            entry.size = entry.isDir ? 0 : qint64(st.stx_size);
+            entries.append(std::move(entry));
+        }
+        io_uring_cq_advance(m_ring, reaped);
+        completed += reaped;
+
+        // In-flight requests still reference the buffers, so they are
+        // drained even when cancelled
+        if (isCancelled()) stopSubmitting = true;
+    }
+    return true;
+}
+#endif
@@ -1,219 +1,842 @@
 #include "DiskAnalyzer.h"
+#include "DeletionEngine.h"
+#include "DuplicateFinder.h"
+#include "TargetWatcher.h"
 #include <QDebug>
-#include <QDirIterator>
-#include <QProcess>
+#include <QHash>
+#include <QPointer>
 #include <QStandardPaths>
+#include <QThreadPool>
+
+namespace {
+// Streaming cadence: results are flushed to the model in small batches so the
+// first targets show up quickly without flooding the GUI thread with signals.
+constexpr int kBatchSize = 64;
+constexpr qint64 kFlushIntervalMs = 100;
+constexpr qint64 kStatsIntervalMs = 250;
+// Entries in the largest files and largest directories lists
+constexpr int kLargestCount = 100;
+// Snapshots kept per scan root for growth comparisons: the newest few,
+// plus the last of each day for a month
+constexpr int kRecentSnapshots = 5;
+constexpr int kDailySnapshots = 30;
+constexpr int kGrowthTopCount = 25;
+}
 
 DiskAnalyzer::DiskAnalyzer(QObject *parent)
     : QObject(parent)
 {
+    qRegisterMetaType<QList<CleanupTarget>>();
+    qRegisterMetaType<QHash<QString, qint64>>();
+    qRegisterMetaType<QSharedPointer<DiskUsageTree>>();
+    qRegisterMetaType<QList<DuplicateGroup>>();
+    qRegisterMetaType<SnapshotDiff>();
+    qRegisterMetaType<QList<LargeEntry>>();
+
+    m_targetModel = new CleanupTargetModel(this);
+    m_visibleTargets = new CleanupTargetProxyModel(m_targetModel, this);
+    m_usageModel = new DiskUsageModel(this);
+    m_duplicateModel = new DuplicateGroupModel(this);
+    m_largestFilesModel = new LargestEntryModel(this);
+    m_largestDirsModel = new LargestEntryModel(this);
+
     // Create worker thread
     m_workerThread = new QThread(this);
     m_worker = new ScanWorker();
     m_worker->moveToThread(m_workerThread);
-    
+
     // Connect signals
     connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &ScanWorker::targetsFound, this, &DiskAnalyzer::onTargetsFound);
+    connect(m_worker, &ScanWorker::cachedResultsLoaded, this, &DiskAnalyzer::onCachedResultsLoaded);
+    connect(m_worker, &ScanWorker::scanStats, this, &DiskAnalyzer::onScanStats);
     connect(m_worker, &ScanWorker::scanFinished, this, &DiskAnalyzer::onScanFinished);
     connect(m_worker, &ScanWorker::progressUpdate, this, &DiskAnalyzer::onProgressUpdate);
-    
+    connect(m_worker, &ScanWorker::usageTreeReady, this, &DiskAnalyzer::onUsageTreeReady);
+    connect(m_worker, &ScanWorker::largestEntriesReady, this, &DiskAnalyzer::onLargestEntriesReady);
+
     m_workerThread->start();
+
+    // Live updates get their own thread so event bursts never stall a scan
+    m_watcherThread = new QThread(this);
+    m_watcher = new TargetWatcher();
+    m_watcher->moveToThread(m_watcherThread);
+    connect(m_watcherThread, &QThread::finished, m_watcher, &QObject::deleteLater);
+    connect(m_watcher, &TargetWatcher::targetSizesChanged, this, &DiskAnalyzer::onTargetSizesChanged);
+    connect(m_watcher, &TargetWatcher::watchStateChanged, this, &DiskAnalyzer::onWatchStateChanged);
+    m_watcherThread->start();
+
+    m_deleteThread = new QThread(this);
+    m_deleter = new DeletionEngine();
+    m_deleter->moveToThread(m_deleteThread);
+    connect(m_deleteThread, &QThread::finished, m_deleter, &QObject::deleteLater);
+    connect(m_deleter, &DeletionEngine::targetRemoved, this, &DiskAnalyzer::onTargetRemoved);
+    connect(m_deleter, &DeletionEngine::deletionFailed, this, &DiskAnalyzer::onDeletionFailed);
+    connect(m_deleter, &DeletionEngine::progress, this, &DiskAnalyzer::onDeletionProgress);
+    connect(m_deleter, &DeletionEngine::idle, this, &DiskAnalyzer::onDeletionIdle);
+    m_deleteThread->start();
+
+    // Duplicate search hashes on its own pool; this thread only drives it
+    m_duplicateThread = new QThread(this);
+    m_duplicateFinder = new DuplicateFinder();
+    m_duplicateFinder->moveToThread(m_duplicateThread);
+    connect(m_duplicateThread, &QThread::finished, m_duplicateFinder, &QObject::deleteLater);
+    connect(m_duplicateFinder, &DuplicateFinder::groupsFound, this, &DiskAnalyzer::onDuplicateGroupsFound);
+    connect(m_duplicateFinder, &DuplicateFinder::progressUpdate, this, &DiskAnalyzer::onDuplicateProgress);
+    connect(m_duplicateFinder, &DuplicateFinder::finished, this, &DiskAnalyzer::onDuplicatesFinished);
+    m_duplicateThread->start();
+}
+
+DiskAnalyzer::~DiskAnalyzer()
+{
+    // Stop a running scan so the worker thread can quit promptly
+    m_worker->cancel();
+    m_duplicateFinder->cancel();
+    m_workerThread->quit();
+    m_workerThread->wait();
+    m_duplicateThread->quit();
+    m_duplicateThread->wait();
+    m_deleter->cancel();
+    m_deleteThread->quit();
+    m_deleteThread->wait();
+    m_watcherThread->quit();
+    m_watcherThread->wait();
+}
+
+void DiskAnalyzer::setLiveUpdates(bool enabled)
+{
+    if (m_liveUpdates == enabled) return;
+
+    m_liveUpdates = enabled;
+    if (enabled && !m_isScanning) {
+        startLiveUpdates();
+    } else if (!enabled) {
+        stopLiveUpdates();
+    }
+    emit liveUpdatesChanged();
+}
+
+void DiskAnalyzer::startLiveUpdates()
+{
+    QList<CleanupTarget> targets;
+    targets.reserve(m_targetModel->count());
+    for (int i = 0; i < m_targetModel->count(); ++i) {
+        targets.append(m_targetModel->target(i));
+    }
+
+    QMetaObject::invokeMethod(m_watcher, "watchTargets", Qt::QueuedConnection,
+                              Q_ARG(QString, m_scanRoot), Q_ARG(QList<CleanupTarget>, targets));
+}
+
+void DiskAnalyzer::stopLiveUpdates()
+{
+    QMetaObject::invokeMethod(m_watcher, "stopWatching", Qt::QueuedConnection);
+    if (m_liveMode != "off") {
+        m_liveMode = "off";
+        emit liveUpdatesChanged();
+    }
 }
 
 void DiskAnalyzer::startScan(const QString &rootPath)
 {
     if (m_isScanning) return;
-    
+
+    m_targetModel->clear();
+    m_usageModel->clear();
+    emit targetsUpdated();
+
+    if (!m_cachedScanTime.isEmpty()) {
+        m_cachedScanTime.clear();
+        emit cachedResultsChanged();
+    }
+
+    beginScan(rootPath, false);
+}
+
+void DiskAnalyzer::loadCachedResults(const QString &rootPath)
+{
+    if (m_isScanning) return;
+
+    m_scanRoot = rootPath.isEmpty() ? QDir::homePath() : rootPath;
+    refreshSnapshots();
+    m_worker->setScanPath(m_scanRoot);
+    QMetaObject::invokeMethod(m_worker, "loadCachedResults", Qt::QueuedConnection);
+}
+
+void DiskAnalyzer::beginScan(const QString &rootPath, bool revalidate)
+{
+    stopLiveUpdates();
+
     m_isScanning = true;
+    m_isRevalidating = revalidate;
+    m_revalidatedTargets.clear();
     emit scanningChanged();
-    
-    m_cleanupTargets.clear();
-    emit targetsUpdated();
-    
-    QString scanPath = rootPath.isEmpty() ? QDir::homePath() : rootPath;
-    m_scanProgress = "Starting scan...";
+
+    m_scannedDirs = 0;
+    m_scannedFiles = 0;
+    m_scannedBytes = 0;
+    m_bytesPerSecond = 0.0;
+    emit scanStatsChanged();
+
+    m_scanRoot = rootPath.isEmpty() ? QDir::homePath() : rootPath;
+    m_scanProgress = revalidate ? "Revalidating cached results..." : "Starting scan...";
     emit scanProgressChanged();
-    
+
     // Start scan in background thread
-    m_worker->setScanPath(scanPath);
+    m_worker->setScanPath(m_scanRoot);
+    m_worker->setPolite(m_politeScan);
+    // Revalidation runs every time the cleanup view opens; only full scans
+    // are worth a snapshot
+    m_worker->setSnapshotPath(revalidate ? QString()
+                                         : ScanSnapshot::newSnapshotPathFor(m_scanRoot, QDateTime::currentMSecsSinceEpoch()));
     QMetaObject::invokeMethod(m_worker, "doScan", Qt::QueuedConnection);
 }
 
-void DiskAnalyzer::onScanFinished(QVariantList targets, qint64 totalSavings)
+void DiskAnalyzer::cancelScan()
 {
-    m_cleanupTargets = targets;
+    if (!m_isScanning) return;
+
+    m_worker->cancel();
+    m_scanProgress = "Cancelling...";
+    emit scanProgressChanged();
+}
+
+void DiskAnalyzer::findDuplicates(const QString &rootPath)
+{
+    if (m_isFindingDuplicates) return;
+
+    m_duplicateModel->clear();
+    m_isFindingDuplicates = true;
+    emit duplicateSearchChanged();
+
+    m_duplicateProgress = "Looking for duplicate files...";
+    emit duplicateProgressChanged();
+
+    m_duplicateFinder->setRootPath(rootPath.isEmpty() ? QDir::homePath() : rootPath);
+    QMetaObject::invokeMethod(m_duplicateFinder, "findDuplicates", Qt::QueuedConnection);
+}
+
+void DiskAnalyzer::cancelDuplicates()
+{
+    if (!m_isFindingDuplicates) return;
+
+    m_duplicateFinder->cancel();
+    m_duplicateProgress = "Cancelling...";
+    emit duplicateProgressChanged();
+}
+
+void DiskAnalyzer::onTargetsFound(const QList<CleanupTarget> &targets)
+{
+    // While revalidating, the cached rows stay on screen until the fresh
+    // results are complete
+    if (m_isRevalidating) {
+        m_revalidatedTargets.append(targets);
+        return;
+    }
+
+    m_targetModel->appendTargets(targets);
+    emit targetsUpdated();
+}
+
+void DiskAnalyzer::onCachedResultsLoaded(const QList<CleanupTarget> &targets, qint64 scanTimeMs, bool found)
+{
+    // Nothing cached yet, or the user already started a scan of their own
+    if (!found || m_isScanning) return;
+
+    m_targetModel->setTargets(targets);
+    m_cachedScanTime = QDateTime::fromMSecsSinceEpoch(scanTimeMs).toString("yyyy-MM-dd HH:mm");
+    emit cachedResultsChanged();
+    emit targetsUpdated();
+
+    beginScan(m_scanRoot, true);
+}
+
+void DiskAnalyzer::onScanStats(qint64 dirs, qint64 files, qint64 bytes, qint64 elapsedMs)
+{
+    m_scannedDirs = dirs;
+    m_scannedFiles = files;
+    m_scannedBytes = bytes;
+    m_bytesPerSecond = elapsedMs > 0 ? bytes * 1000.0 / elapsedMs : 0.0;
+    emit scanStatsChanged();
+}
+
+void DiskAnalyzer::onScanFinished(qint64 totalSavings, bool cancelled)
+{
+    if (m_isRevalidating && !cancelled) {
+        m_targetModel->setTargets(m_revalidatedTargets);
+        m_cachedScanTime.clear();
+        emit cachedResultsChanged();
+        emit targetsUpdated();
+    }
+    m_revalidatedTargets.clear();
+    m_isRevalidating = false;
+
     m_isScanning = false;
-    
+    m_scanProgress = cancelled ? "Scan cancelled" : "Scan complete";
+
     emit scanningChanged();
-    emit targetsUpdated();
+    emit scanProgressChanged();
     emit scanComplete(totalSavings);
+
+    if (!cancelled) {
+        ScanSnapshot::prune(m_scanRoot, kRecentSnapshots, kDailySnapshots);
+        refreshSnapshots();
+    }
+
+    // Watching needs the index of a complete scan
+    if (m_liveUpdates && !cancelled) {
+        startLiveUpdates();
+    }
+}
+
+void DiskAnalyzer::onTargetSizesChanged(const QHash<QString, qint64> &sizes)
+{
+    if (m_isScanning) return;
+
+    m_targetModel->updateTargetSizes(sizes);
+    emit targetsUpdated();
+}
+
+void DiskAnalyzer::onWatchStateChanged(const QString &mode, int watchedTargets)
+{
+    qDebug() << "Live updates" << mode << "for" << watchedTargets << "targets";
+    m_liveMode = mode;
+    emit liveUpdatesChanged();
+}
+
+void DiskAnalyzer::onDuplicateGroupsFound(const QList<DuplicateGroup> &groups)
+{
+    m_duplicateModel->appendGroups(groups);
+}
+
+void DiskAnalyzer::onDuplicateProgress(const QString &progress)
+{
+    if (!m_isFindingDuplicates) return;
+
+    m_duplicateProgress = progress;
+    emit duplicateProgressChanged();
+}
+
+void DiskAnalyzer::onDuplicatesFinished(qint64 totalReclaimable, bool cancelled)
+{
+    m_isFindingDuplicates = false;
+    m_duplicateProgress = cancelled ? "Duplicate search cancelled"
+                                    : QString("%1 duplicate groups, %2 reclaimable")
+                                          .arg(m_duplicateModel->count())
+                                          .arg(formatSize(totalReclaimable));
+    emit duplicateSearchChanged();
+    emit duplicateProgressChanged();
+    emit duplicatesComplete(totalReclaimable);
 }
 
 void DiskAnalyzer::onProgressUpdate(const QString &progress)
 {
+    // Late progress from a cancelled scan must not overwrite the status
+    if (!m_isScanning) return;
+
     m_scanProgress = progress;
     emit scanProgressChanged();
 }
 
+void DiskAnalyzer::onUsageTreeReady(const QSharedPointer<DiskUsageTree> &tree)
+{
+    qDebug() << "Usage tree:" << tree->nodeCount() << "entries in"
+             << CleanupTargetModel::formatSize(tree->memoryUsage());
+    m_usageModel->setTree(tree);
+}
 
-void DiskAnalyzer::deleteTarget(int index)
+void DiskAnalyzer::onLargestEntriesReady(const QList<LargeEntry> &files, const QList<LargeEntry> &directories)
 {
-    if (index < 0 || index >= m_cleanupTargets.size()) return;
-    
-    QVariantMap targetMap = m_cleanupTargets[index].toMap();
-    QString path = targetMap["path"].toString();
-    
-    qDebug() << "Deleting:" << path;
-    
-    // Move to recycle bin instead of permanent delete (safer)
-    QDir dir(path);
-    if (dir.exists()) {
-        // On Windows, use shell command to move to recycle bin
-#ifdef Q_OS_WIN
-        QProcess::execute("cmd", QStringList() << "/c" << "rmdir" << "/s" << "/q" << path);
-#else
-        dir.removeRecursively();
-#endif
-        
-        // Remove from list
-        m_cleanupTargets.removeAt(index);
-        emit targetsUpdated();
+    m_largestFilesModel->setEntries(files);
+    m_largestDirsModel->setEntries(directories);
+}
+
+void DiskAnalyzer::refreshSnapshots()
+{
+    m_snapshots.clear();
+    const QList<ScanSnapshot::Info> snapshots = ScanSnapshot::list(m_scanRoot);
+    for (const ScanSnapshot::Info &info : snapshots) {
+        QVariantMap entry;
+        entry["file"] = info.fileName;
+        entry["scanTime"] = info.scanTimeMs;
+        entry["label"] = QDateTime::fromMSecsSinceEpoch(info.scanTimeMs).toString("yyyy-MM-dd HH:mm")
+                         + " • " + formatSize(qint64(info.totalBytes));
+        m_snapshots.append(entry);
     }
+    emit snapshotsChanged();
 }
 
-QString DiskAnalyzer::formatSize(qint64 bytes)
+void DiskAnalyzer::compareSnapshots(const QString &olderFile, const QString &newerFile)
 {
-    if (bytes < 1024) {
-        return QString::number(bytes) + " B";
-    } else if (bytes < 1024 * 1024) {
-        return QString::number(bytes / 1024.0, 'f', 1) + " KB";
-    } else if (bytes < 1024 * 1024 * 1024) {
-        return QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + " MB";
-    } else {
-        return QString::number(bytes / (1024.0 * 1024.0 * 1024.0), 'f', 2) + " GB";
+    if (m_isComparing || olderFile.isEmpty()) return;
+
+    const QString newer = newerFile.isEmpty() && !m_snapshots.isEmpty()
+                              ? m_snapshots.first().toMap().value("file").toString()
+                              : newerFile;
+    if (newer.isEmpty() || newer == olderFile) return;
+
+    m_isComparing = true;
+    m_growthSummary = "Comparing snapshots...";
+    emit growthChanged();
+
+    // A linear merge of two files; short, but not for the GUI thread
+    QPointer<DiskAnalyzer> self(this);
+    QThreadPool::globalInstance()->start([self, olderFile, newer]() {
+        const SnapshotDiff diff = ScanSnapshot::diff(olderFile, newer, kGrowthTopCount);
+        if (self) QMetaObject::invokeMethod(self, "onGrowthReady", Qt::QueuedConnection, Q_ARG(SnapshotDiff, diff));
+    });
+}
+
+void DiskAnalyzer::onGrowthReady(const SnapshotDiff &diff)
+{
+    m_isComparing = false;
+    m_growers.clear();
+    m_shrinkers.clear();
+
+    if (!diff.ok) {
+        m_growthSummary = diff.error;
+        emit growthChanged();
+        return;
+    }
+
+    auto toVariant = [this](const QList<SnapshotChange> &changes, QVariantList &out) {
+        for (const SnapshotChange &change : changes) {
+            QVariantMap entry;
+            entry["path"] = change.path;
+            entry["oldSize"] = change.oldSize;
+            entry["newSize"] = change.newSize;
+            entry["delta"] = change.delta();
+            entry["deltaFormatted"] = (change.delta() >= 0 ? "+" : "-") + formatSize(qAbs(change.delta()));
+            out.append(entry);
+        }
+    };
+    toVariant(diff.growers, m_growers);
+    toVariant(diff.shrinkers, m_shrinkers);
+
+    const qint64 total = qint64(diff.newTotal) - qint64(diff.oldTotal);
+    m_growthSummary = QDateTime::fromMSecsSinceEpoch(diff.oldScanTimeMs).toString("yyyy-MM-dd HH:mm") + " → "
+                      + QDateTime::fromMSecsSinceEpoch(diff.newScanTimeMs).toString("yyyy-MM-dd HH:mm") + ": "
+                      + (total >= 0 ? "+" : "-") + formatSize(qAbs(total)) + " overall";
+    emit growthChanged();
+}
+
+void DiskAnalyzer::setPoliteScan(bool enabled)
+{
+    // Applies from the next scan on
+    if (m_politeScan == enabled) return;
+    m_politeScan = enabled;
+    emit politeScanChanged();
+}
+
+void DiskAnalyzer::setUseTrash(bool enabled)
+{
+    if (m_useTrash == enabled) return;
+    m_useTrash = enabled;
+    emit useTrashChanged();
+}
+
+void DiskAnalyzer::deleteTarget(const QString &path)
+{
+    if (m_targetModel->rowOf(path) < 0) return;
+
+    queueDeletion({path});
+}
+
+void DiskAnalyzer::deleteSelected()
+{
+    queueDeletion(m_targetModel->selectedPaths());
+    m_targetModel->clearSelection();
+}
+
+void DiskAnalyzer::cancelDeletion()
+{
+    m_deleter->cancel();
+}
+
+void DiskAnalyzer::queueDeletion(const QStringList &paths)
+{
+    QStringList queued;
+    for (const QString &path : paths) {
+        if (m_targetModel->isDeleting(path)) continue;
+
+        m_targetModel->setDeleting(path, true);
+        QMetaObject::invokeMethod(m_watcher, "unwatchTarget", Qt::QueuedConnection, Q_ARG(QString, path));
+        queued.append(path);
+    }
+    if (queued.isEmpty()) return;
+
+    if (!m_isDeleting) {
+        m_isDeleting = true;
+        m_deletedBytes = 0;
+        m_deletedFiles = 0;
+    }
+    m_deleteQueueLength += queued.size();
+    emit deletionProgressChanged();
+
+    m_deleter->enqueue(queued, m_useTrash);
+}
+
+void DiskAnalyzer::onTargetRemoved(const QString &path)
+{
+    m_targetModel->removeTarget(m_targetModel->rowOf(path));
+    for (int i = 0; i < m_revalidatedTargets.size(); ++i) {
+        if (m_revalidatedTargets[i].path == path) {
+            m_revalidatedTargets.removeAt(i);
+            break;
+        }
+    }
+    emit targetsUpdated();
+}
+
+void DiskAnalyzer::onDeletionFailed(const QString &path, const QString &error)
+{
+    qWarning() << "Failed to delete" << path << ":" << error;
+    m_targetModel->setDeleting(path, false);
+    emit deletionFailed(path, error);
+}
+
+void DiskAnalyzer::onDeletionProgress(qint64 bytesFreed, qint64 filesRemoved, int queued)
+{
+    m_deletedBytes = bytesFreed;
+    m_deletedFiles = filesRemoved;
+    m_deleteQueueLength = queued;
+    emit deletionProgressChanged();
+}
+
+void DiskAnalyzer::onDeletionIdle(qint64 bytesFreed, qint64 filesRemoved, bool cancelled)
+{
+    qDebug() << "Deletion" << (cancelled ? "cancelled" : "finished") << "-" << formatSize(bytesFreed)
+             << "in" << filesRemoved << "files";
+
+    // Cancelled targets that were not moved aside stay in the list. Rows
+    // still marked after a normal finish were queued after the engine went
+    // idle; another round is already on its way for them.
+    bool morePending = false;
+    for (int row = 0; row < m_targetModel->count(); ++row) {
+        const QString &path = m_targetModel->pathAt(row);
+        if (!m_targetModel->isDeleting(path)) continue;
+        if (cancelled) {
+            m_targetModel->setDeleting(path, false);
+        } else {
+            morePending = true;
+        }
     }
+    if (morePending) return;
+
+    m_isDeleting = false;
+    m_deletedBytes = bytesFreed;
+    m_deletedFiles = filesRemoved;
+    m_deleteQueueLength = 0;
+    emit deletionProgressChanged();
+    emit deletionComplete(bytesFreed, filesRemoved);
 }
 
-QVariantMap DiskAnalyzer::targetToVariant(const CleanupTarget &target)
+QString DiskAnalyzer::formatSize(qint64 bytes)
 {
-    QVariantMap map;
-    map["path"] = target.path;
-    map["type"] = target.type;
-    map["size"] = target.size;
-    map["sizeFormatted"] = formatSize(target.size);
-    map["lastModified"] = target.lastModified.toString("yyyy-MM-dd");
-    map["isSafe"] = target.isSafe;
-    map["reason"] = target.reason;
-    return map;
+    return CleanupTargetModel::formatSize(bytes);
 }
 
 // ============ ScanWorker Implementation ============
 
 ScanWorker::ScanWorker(QObject *parent)
     : QObject(parent)
+    , m_largestCount(kLargestCount)
+    , m_batchSize(kBatchSize)
 {
+    m_lister.setCancelFlag(&m_cancelRequested);
+    m_throttle.setCancelFlag(&m_cancelRequested);
+    m_throttle.setPauseHandler([this](bool paused) {
+        emit progressUpdate(paused ? "Paused: disk is busy (I/O pressure)" : "Scanning: " + m_scanPath);
+    });
 }
 
 void ScanWorker::setScanPath(const QString &path)
 {
     m_scanPath = path;
+    m_cancelRequested = false;
+}
+
+void ScanWorker::cancel()
+{
+    m_cancelRequested = true;
+}
+
+void ScanWorker::loadCachedResults()
+{
+    ScanIndex index;
+    bool found = index.open(ScanIndex::indexPathFor(m_scanPath), m_scanPath);
+    emit cachedResultsLoaded(found ? index.targets() : QList<CleanupTarget>(), index.scanTimeMs(), found);
 }
 
 void ScanWorker::doScan()
 {
-    QList<CleanupTarget> targets;
-    
+    m_pendingBatch.clear();
+    m_dirCount = 0;
+    m_fileCount = 0;
+    m_byteCount = 0;
+    m_reusedDirs = 0;
+    m_totalSavings = 0;
+    m_lastFlushMs = 0;
+    m_lastStatsMs = 0;
+    m_scanTimer.start();
+
+    // Picks up edits to cleanup-rules.json on every scan
+    m_rules = CleanupRules::load();
+
+    // Which directories running processes are using, checked per target
+    m_openPaths.build();
+
+    m_usageTree.reset(m_buildUsageTree ? new DiskUsageTree() : nullptr);
+    m_largestFiles.setCapacity(m_largestCount);
+    m_largestDirs.setCapacity(m_largestCount);
+
     emit progressUpdate("Scanning: " + m_scanPath);
-    
-    // Scan for cleanup targets
-    scanDirectory(m_scanPath, targets);
-    
-    // Convert to QVariantList
-    QVariantList variantTargets;
-    qint64 totalSavings = 0;
-    for (const CleanupTarget &target : targets) {
-        variantTargets.append(targetToVariant(target));
-        totalSavings += target.size;
+
+    // Directories unchanged since the previous scan are taken from its index
+    const QString indexPath = ScanIndex::indexPathFor(m_scanPath);
+    m_indexWriter.clear();
+    m_indexActive = m_useIndex && ScanIndex::isSupported();
+    if (m_indexActive) {
+        m_prevIndex.open(indexPath, m_scanPath);
+    }
+
+    if (!m_snapshotPath.isEmpty()) {
+        m_snapshotWriter.begin(m_snapshotPath, m_scanPath);
     }
-    
-    emit scanFinished(variantTargets, totalSavings);
+
+    // Deep io_uring queues are the opposite of polite
+    m_lister.setBackend(m_polite ? DirectoryLister::Sync : m_ioBackend);
+    m_lister.setNoAtime(m_polite);
+
+    // Scan for cleanup targets; results are streamed out in batches
+    if (m_polite) {
+        // Leaving SCHED_IDLE again needs privileges, so the polite walk gets
+        // a short-lived thread of its own instead of demoting this one
+        QThread *thread = QThread::create([this]() {
+            m_throttle.start();
+            scanDirectory(m_scanPath);
+            m_throttle.stop();
+        });
+        thread->start();
+        thread->wait();
+        delete thread;
+    } else {
+        scanDirectory(m_scanPath);
+    }
+    m_prevIndex.close();
+
+    bool cancelled = m_cancelRequested.load();
+    if (!cancelled && m_indexActive) {
+        m_indexWriter.save(indexPath, m_scanPath, QDateTime::currentMSecsSinceEpoch());
+    }
+    m_indexWriter.clear();
+
+    if (!cancelled && m_snapshotWriter.isOpen()) {
+        m_snapshotWriter.finish(QDateTime::currentMSecsSinceEpoch());
+    } else {
+        m_snapshotWriter.abort();
+    }
+
+    qDebug() << "Scan of" << m_scanPath << "visited" << m_dirCount << "directories,"
+             << m_reusedDirs << "reused from index";
+
+    reportProgress(m_scanPath, true);
+
+    // The tree is handed over read-only; the worker keeps no reference
+    if (m_usageTree && !cancelled) {
+        m_usageTree->squeeze();
+        emit usageTreeReady(m_usageTree);
+    }
+    m_usageTree.reset();
+    m_openPaths.clear();
+
+    // Also after a cancel: the lists then cover what was walked
+    if (m_largestCount > 0) {
+        emit largestEntriesReady(m_largestFiles.sorted(), m_largestDirs.sorted());
+    }
+    m_largestFiles.clear();
+    m_largestDirs.clear();
+
+    emit scanFinished(m_totalSavings, cancelled);
 }
 
-void ScanWorker::scanDirectory(const QString &path, QList<CleanupTarget> &targets)
+void ScanWorker::scanDirectory(const QString &path)
 {
     QDir dir(path);
     if (!dir.exists()) return;
-    
-    QDirIterator it(path, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
-    
-    int dirCount = 0;
-    while (it.hasNext()) {
-        QString dirPath = it.next();
-        QFileInfo info(dirPath);
-        QString dirName = info.fileName();
-        
-        // Update progress (throttled - only every 100 directories)
-        dirCount++;
-        if (dirCount % 100 == 0) {
-            emit progressUpdate("Scanning: " + dirPath);
-        }
-        
-        // Check for cleanup candidates
-        CleanupTarget target;
-        target.path = dirPath;
-        target.lastModified = info.lastModified();
-        target.isSafe = isSafeToDelete(dirPath, info);
-        
-        // Rule 1: node_modules
-        if (dirName == "node_modules") {
-            target.type = "Node.js Dependencies";
-            target.size = calculateDirectorySize(dirPath);
-            target.reason = "Can be regenerated with npm/yarn install";
-            if (target.size > 1024 * 1024) { // > 1MB
-                targets.append(target);
+
+    // Iterative post-order walk: a directory's size is known once all of
+    // its subdirectories have been popped, so every file is visited once and
+    // target sizes fall out of the same pass.
+    QList<ScanFrame> stack;
+    ScanFrame root;
+    root.path = path;
+    root.prevIndex = m_prevIndex.isOpen() ? 0 : -1;
+    if (m_usageTree) {
+        root.treeNode = m_usageTree->addNode(DiskUsageTree::NoNode, path, 0, true);
+    }
+    if (!enterDirectory(root, QString())) return;
+    stack.append(std::move(root));
+
+    int targetDepth = 0;
+    while (!stack.isEmpty()) {
+        if (m_cancelRequested) return;
+
+        if (!stack.last().pendingDirs.isEmpty()) {
+            PendingDir next = stack.last().pendingDirs.takeLast();
+            ScanFrame child;
+            child.path = next.path;
+            child.prevIndex = next.prevIndex;
+            child.treeNode = next.treeNode;
+
+            const QString name = QFileInfo(child.path).fileName();
+            if (!enterDirectory(child, name)) continue;
+
+            // Nested matches (e.g. cache inside node_modules) are already
+            // covered by the enclosing target
+            if (targetDepth == 0) {
+                child.rule = m_rules.match(name, child.path);
             }
-        }
-        // Rule 2: Build artifacts
-        else if (dirName == "build" || dirName == "dist" || dirName == "out" || 
-                 dirName == "target" || dirName == ".next") {
-            target.type = "Build Artifacts";
-            target.size = calculateDirectorySize(dirPath);
-            target.reason = "Regenerable from source code";
-            if (target.size > 1024 * 1024) {
-                targets.append(target);
+            if (child.rule >= 0) {
+                const CleanupRule &rule = m_rules.rule(child.rule);
+                QFileInfo info(child.path);
+                child.target.type = rule.type;
+                child.target.reason = rule.reason;
+                child.target.path = child.path;
+                child.target.lastModified = info.lastModified();
+                child.target.isSafe = isSafeToDelete(child.path, info);
+                ++targetDepth;
             }
+
+            reportProgress(child.path, false);
+            stack.append(std::move(child));
+            continue;
+        }
+
+        ScanFrame done = stack.takeLast();
+        m_indexWriter.endDirectory(done.indexSlot, quint64(done.ownBytes), done.ownFiles, quint64(done.size));
+        if (m_usageTree && done.treeNode != DiskUsageTree::NoNode) {
+            m_usageTree->setSize(done.treeNode, quint64(done.size));
         }
-        // Rule 3: Cache directories
-        else if (dirName == "cache" || dirName == ".cache" || dirName == "__pycache__") {
-            target.type = "Cache Files";
-            target.size = calculateDirectorySize(dirPath);
-            target.reason = "Temporary cache data";
-            if (target.size > 1024 * 1024) {
-                targets.append(target);
+        m_snapshotWriter.addDirectory(done.path, quint64(done.size));
+        if (m_largestDirs.accepts(done.size)) m_largestDirs.add(done.path, done.size);
+        if (!stack.isEmpty()) {
+            stack.last().size += done.size;
+        }
+
+        if (done.rule >= 0) {
+            --targetDepth;
+            done.target.size = done.size;
+            if (done.target.size > m_rules.rule(done.rule).minSize) {
+                m_totalSavings += done.target.size;
+                m_pendingBatch.append(done.target);
+                if (m_indexActive) m_indexWriter.addTarget(done.target);
+                if (m_pendingBatch.size() >= m_batchSize) flushBatch();
             }
         }
-        
-        // Limit scan depth to avoid hanging
-        if (targets.size() > 50) break; // Reduced from 100 for faster response
     }
 }
 
-qint64 ScanWorker::calculateDirectorySize(const QString &path)
+bool ScanWorker::enterDirectory(ScanFrame &frame, const QString &name)
 {
-    qint64 size = 0;
-    QDirIterator it(path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
-    
-    int fileCount = 0;
-    while (it.hasNext()) {
-        it.next();
-        size += it.fileInfo().size();
-        fileCount++;
-        
-        // Limit to prevent hanging on huge directories
-        if (fileCount > 5000) break; // Reduced from 10000
+    if (m_polite) m_throttle.consume(1);
+
+    if (!m_indexActive) {
+        listDirectory(frame);
+        frame.size = frame.ownBytes;
+        return true;
     }
-    
-    return size;
+
+    // The directory vanished or was replaced since its parent was listed
+    ScanIndex::DirStat st;
+    if (!ScanIndex::statDirectory(frame.path, st)) return false;
+
+    // A directory whose files total less than the smallest of the largest
+    // files so far cannot hold one of them; only others are listed again
+    if (m_prevIndex.isUnchanged(frame.prevIndex, st)
+        && !m_largestFiles.accepts(qint64(m_prevIndex.dir(frame.prevIndex).ownBytes))) {
+        // Same inode and mtime/ctime: no entry was added, removed or renamed,
+        // so the child names still hold and neither readdir nor a per-file
+        // stat is needed here. Files written in place do not touch the
+        // directory, so their indexed sizes may be stale.
+        const ScanIndex::DirRecord &record = m_prevIndex.dir(frame.prevIndex);
+        frame.ownBytes = qint64(record.ownBytes);
+        frame.ownFiles = record.ownFiles;
+
+        // Individual files are not listed, so the tree gets one aggregate
+        // entry for them
+        DiskUsageTree *tree = frame.treeNode != DiskUsageTree::NoNode ? m_usageTree.data() : nullptr;
+        const quint32 firstChild = tree ? tree->nodeCount() : 0;
+        if (tree && frame.ownBytes > 0) {
+            tree->addNode(frame.treeNode, QStringLiteral("[files]"), quint64(frame.ownBytes), false);
+        }
+
+        const QString prefix = frame.path.endsWith('/') ? frame.path : frame.path + '/';
+        m_prevIndex.forEachChild(frame.prevIndex, [&](int child) {
+            const QString childName = m_prevIndex.name(child);
+            quint32 node = tree ? tree->addNode(frame.treeNode, childName, 0, true) : DiskUsageTree::NoNode;
+            frame.pendingDirs.append({prefix + childName, child, node});
+        });
+        if (tree) {
+            tree->setChildren(frame.treeNode, firstChild, tree->nodeCount() - firstChild);
+        }
+
+        m_dirCount++;
+        m_reusedDirs++;
+        m_fileCount += frame.ownFiles;
+        m_byteCount += frame.ownBytes;
+    } else {
+        listDirectory(frame);
+    }
+
+    frame.size = frame.ownBytes;
+    frame.indexSlot = m_indexWriter.beginDirectory(st, name);
+    return true;
+}
+
+void ScanWorker::listDirectory(ScanFrame &frame)
+{
+    // Children that were indexed last time keep their record so they can
+    // still be reused even though this directory itself changed
+    QHash<QString, int> previousChildren;
+    if (frame.prevIndex >= 0 && frame.prevIndex < m_prevIndex.dirCount()) {
+        m_prevIndex.forEachChild(frame.prevIndex, [&](int child) {
+            previousChildren.insert(m_prevIndex.name(child), child);
+        });
+    }
+
+    // Children are appended in one run so they form a contiguous range
+    DiskUsageTree *tree = frame.treeNode != DiskUsageTree::NoNode ? m_usageTree.data() : nullptr;
+    const quint32 firstChild = tree ? tree->nodeCount() : 0;
+
+    // Symlinks are already left out: following them would double count or loop
+    m_lister.list(frame.path, m_entries);
+    if (m_polite) m_throttle.consume(int(m_entries.size()));
+
+    const QString prefix = frame.path.endsWith('/') ? frame.path : frame.path + '/';
+    int entryCount = 0;
+    for (const DirectoryLister::Entry &entry : std::as_const(m_entries)) {
+        if (entry.isDir) {
+            quint32 node = tree ? tree->addNode(frame.treeNode, entry.name, 0, true) : DiskUsageTree::NoNode;
+            frame.pendingDirs.append({prefix + entry.name, previousChildren.value(entry.name, -1), node});
+        } else {
+            if (tree) tree->addNode(frame.treeNode, entry.name, quint64(entry.size), false);
+            frame.ownBytes += entry.size;
+            frame.ownFiles++;
+            if (m_largestFiles.accepts(entry.size)) m_largestFiles.add(prefix + entry.name, entry.size);
+            m_byteCount += entry.size;
+            m_fileCount++;
+        }
+
+        // Huge flat directories must stay cancellable
+        if (++entryCount % 4096 == 0 && m_cancelRequested) break;
+    }
+
+    if (tree) {
+        tree->setChildren(frame.treeNode, firstChild, tree->nodeCount() - firstChild);
+    }
+
+    m_dirCount++;
 }
 
 bool ScanWorker::isSafeToDelete(const QString &path, const QFileInfo &info)
@@ -223,40 +846,45 @@ bool ScanWorker::isSafeToDelete(const QString &path, const QFileInfo &info)
     if (info.lastModified() > thirtyDaysAgo) {
         return false; // Recently modified, might be active
     }
-    
+
     // Check 2: Not in system directories
     QString normalizedPath = path.toLower();
-    if (normalizedPath.contains("windows") || 
+    if (normalizedPath.contains("windows") ||
         normalizedPath.contains("program files") ||
         normalizedPath.contains("system32")) {
         return false;
     }
-    
-    return true; // Skip process check for performance
+
+    // Check 3: No running process has its cwd, binary, an open file or an
+    // active virtualenv inside it
+    const QString user = m_openPaths.processUsing(path);
+    if (!user.isEmpty()) {
+        qDebug() << "In use by" << user << ":" << path;
+        return false;
+    }
+
+    return true;
 }
 
-QVariantMap ScanWorker::targetToVariant(const CleanupTarget &target)
+void ScanWorker::reportProgress(const QString &currentPath, bool force)
 {
-    QVariantMap map;
-    map["path"] = target.path;
-    map["type"] = target.type;
-    map["size"] = target.size;
-    map["sizeFormatted"] = formatSize(target.size);
-    map["lastModified"] = target.lastModified.toString("yyyy-MM-dd");
-    map["isSafe"] = target.isSafe;
-    map["reason"] = target.reason;
-    return map;
+    qint64 now = m_scanTimer.elapsed();
+
+    if (!m_pendingBatch.isEmpty() &&
+        (force || m_pendingBatch.size() >= m_batchSize || now - m_lastFlushMs >= kFlushIntervalMs)) {
+        flushBatch();
+    }
+
+    if (force || now - m_lastStatsMs >= kStatsIntervalMs) {
+        m_lastStatsMs = now;
+        emit scanStats(m_dirCount, m_fileCount, m_byteCount, now);
+        emit progressUpdate("Scanning: " + currentPath);
+    }
 }
 
-QString ScanWorker::formatSize(qint64 bytes)
+void ScanWorker::flushBatch()
 {
-    if (bytes < 1024) {
-        return QString::number(bytes) + " B";
-    } else if (bytes < 1024 * 1024) {
-        return QString::number(bytes / 1024.0, 'f', 1) + " KB";
-    } else if (bytes < 1024 * 1024 * 1024) {
-        return QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + " MB";
-    } else {
-        return QString::number(bytes / (1024.0 * 1024.0 * 1024.0), 'f', 2) + " GB";
-    }
+    m_lastFlushMs = m_scanTimer.elapsed();
+    emit targetsFound(m_pendingBatch);
+    m_pendingBatch.clear();
 }
@@ -0,0 +1,256 @@
+#include "DiskUsageModel.h"
+#include "CleanupTargetModel.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+// A flat directory can hold 100k+ entries; only the largest are turned into
+// tiles and anything smaller than a few pixels goes into "other"
+constexpr int kMaxTiles = 400;
+constexpr qreal kMinTileArea = 24.0;
+}
+
+DiskUsageModel::DiskUsageModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int DiskUsageModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return m_tiles.size();
+}
+
+QVariant DiskUsageModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_tiles.size()) {
+        return QVariant();
+    }
+
+    const Tile &tile = m_tiles.at(index.row());
+    const bool isOther = tile.node == DiskUsageTree::NoNode;
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return isOther ? QString("%1 smaller items").arg(tile.otherCount) : m_tree->name(tile.node);
+    case PathRole:
+        return isOther ? currentPath() : m_tree->path(tile.node);
+    case SizeRole:
+        return qint64(tile.size);
+    case SizeFormattedRole:
+        return CleanupTargetModel::formatSize(qint64(tile.size));
+    case IsDirRole:
+        return !isOther && m_tree->isDir(tile.node);
+    case IsOtherRole:
+        return isOther;
+    case CanDrillDownRole:
+        return !isOther && m_tree->isDir(tile.node) && m_tree->childCount(tile.node) > 0;
+    case TileXRole:
+        return tile.rect.x();
+    case TileYRole:
+        return tile.rect.y();
+    case TileWidthRole:
+        return tile.rect.width();
+    case TileHeightRole:
+        return tile.rect.height();
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> DiskUsageModel::roleNames() const
+{
+    return {
+        {NameRole, "name"},
+        {PathRole, "path"},
+        {SizeRole, "size"},
+        {SizeFormattedRole, "sizeFormatted"},
+        {IsDirRole, "isDir"},
+        {IsOtherRole, "isOther"},
+        {CanDrillDownRole, "canDrillDown"},
+        {TileXRole, "tileX"},
+        {TileYRole, "tileY"},
+        {TileWidthRole, "tileWidth"},
+        {TileHeightRole, "tileHeight"}
+    };
+}
+
+void DiskUsageModel::setTree(const QSharedPointer<DiskUsageTree> &tree)
+{
+    m_tree = tree;
+    emit treeChanged();
+    setCurrent(m_tree && m_tree->nodeCount() > 0 ? 0 : DiskUsageTree::NoNode);
+}
+
+void DiskUsageModel::clear()
+{
+    if (!m_tree) return;
+    setTree(QSharedPointer<DiskUsageTree>());
+}
+
+QString DiskUsageModel::currentPath() const
+{
+    return m_current != DiskUsageTree::NoNode ? m_tree->path(m_current) : QString();
+}
+
+qint64 DiskUsageModel::currentSize() const
+{
+    return m_current != DiskUsageTree::NoNode ? qint64(m_tree->size(m_current)) : 0;
+}
+
+bool DiskUsageModel::canGoUp() const
+{
+    return m_current != DiskUsageTree::NoNode && m_tree->parent(m_current) != DiskUsageTree::NoNode;
+}
+
+void DiskUsageModel::setViewWidth(qreal width)
+{
+    if (qFuzzyCompare(m_viewWidth, width)) return;
+    m_viewWidth = width;
+    rebuild();
+    emit viewSizeChanged();
+}
+
+void DiskUsageModel::setViewHeight(qreal height)
+{
+    if (qFuzzyCompare(m_viewHeight, height)) return;
+    m_viewHeight = height;
+    rebuild();
+    emit viewSizeChanged();
+}
+
+void DiskUsageModel::drillDown(int row)
+{
+    if (row < 0 || row >= m_tiles.size()) return;
+
+    quint32 node = m_tiles.at(row).node;
+    if (node == DiskUsageTree::NoNode || !m_tree->isDir(node) || m_tree->childCount(node) == 0) return;
+    setCurrent(node);
+}
+
+void DiskUsageModel::goUp()
+{
+    if (!canGoUp()) return;
+    setCurrent(m_tree->parent(m_current));
+}
+
+void DiskUsageModel::goToRoot()
+{
+    if (!m_tree || m_tree->nodeCount() == 0) return;
+    setCurrent(0);
+}
+
+void DiskUsageModel::setCurrent(quint32 node)
+{
+    m_current = node;
+    rebuild();
+    emit currentChanged();
+}
+
+void DiskUsageModel::rebuild()
+{
+    beginResetModel();
+    m_tiles.clear();
+
+    const qreal viewArea = m_viewWidth * m_viewHeight;
+    if (m_tree && m_current != DiskUsageTree::NoNode && viewArea > 0) {
+        const quint32 first = m_tree->firstChild(m_current);
+        const quint32 count = m_tree->childCount(m_current);
+
+        QList<Tile> children;
+        children.reserve(int(count));
+        quint64 total = 0;
+        for (quint32 node = first; node < first + count; ++node) {
+            quint64 size = m_tree->size(node);
+            if (size == 0) continue;
+            children.append({node, size, 0, QRectF()});
+            total += size;
+        }
+
+        if (total > 0) {
+            const auto largerFirst = [](const Tile &a, const Tile &b) { return a.size > b.size; };
+            const int keep = std::min(int(children.size()), kMaxTiles);
+            std::partial_sort(children.begin(), children.begin() + keep, children.end(), largerFirst);
+
+            quint64 shown = 0;
+            for (int i = 0; i < keep; ++i) {
+                if (qreal(children[i].size) * viewArea / qreal(total) < kMinTileArea) break;
+                shown += children[i].size;
+                m_tiles.append(children[i]);
+            }
+
+            if (shown < total) {
+                Tile other;
+                other.size = total - shown;
+                other.otherCount = int(children.size()) - int(m_tiles.size());
+                m_tiles.append(other);
+            }
+
+            squarify(m_tiles, QRectF(0, 0, m_viewWidth, m_viewHeight));
+        }
+    }
+
+    endResetModel();
+}
+
+void DiskUsageModel::squarify(QList<Tile> &tiles, const QRectF &bounds)
+{
+    // Squarified treemap (Bruls, Huizing, van Wijk): tiles are added to the
+    // current row along the short side while that keeps the worst aspect
+    // ratio improving, then the row is fixed and the rest of the rectangle
+    // is filled the same way. Expects tiles largest first.
+    qreal total = 0;
+    for (const Tile &tile : tiles) {
+        total += qreal(tile.size);
+    }
+    if (total <= 0) return;
+
+    const qreal scale = bounds.width() * bounds.height() / total;
+    QRectF free = bounds;
+
+    int start = 0;
+    while (start < tiles.size()) {
+        const qreal side = std::min(free.width(), free.height());
+        if (side <= 0) break;
+
+        qreal rowArea = 0;
+        qreal rowMax = 0;
+        qreal rowMin = std::numeric_limits<qreal>::max();
+        qreal worst = std::numeric_limits<qreal>::max();
+        int end = start;
+        while (end < tiles.size()) {
+            const qreal area = qreal(tiles[end].size) * scale;
+            const qreal newArea = rowArea + area;
+            const qreal newMax = std::max(rowMax, area);
+            const qreal newMin = std::min(rowMin, area);
+            const qreal newWorst = std::max(side * side * newMax / (newArea * newArea),
+                                            newArea * newArea / (side * side * newMin));
+            if (end > start && newWorst > worst) break;
+
+            rowArea = newArea;
+            rowMax = newMax;
+            rowMin = newMin;
+            worst = newWorst;
+            ++end;
+        }
+
+        const qreal thickness = rowArea / side;
+        qreal offset = 0;
+        const bool vertical = free.width() >= free.height();
+        for (int i = start; i < end; ++i) {
+            const qreal length = qreal(tiles[i].size) * scale / thickness;
+            if (vertical) {
+                tiles[i].rect = QRectF(free.x(), free.y() + offset, thickness, length);
+            } else {
+                tiles[i].rect = QRectF(free.x() + offset, free.y(), length, thickness);
+            }
+            offset += length;
+        }
+
+        if (vertical) {
+            free.setLeft(free.left() + thickness);
+        } else {
+            free.setTop(free.top() + thickness);
+        }
+        start = end;
+    }
+}
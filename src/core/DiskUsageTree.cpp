@@ -0,0 +1,122 @@
+#include "DiskUsageTree.h"
+#include <QHashFunctions>
+#include <QStringList>
+#include <cstring>
+
+DiskUsageTree::DiskUsageTree()
+{
+    m_internSlots.fill(kEmptySlot, 1024);
+}
+
+quint32 DiskUsageTree::addNode(quint32 parent, const QString &name, quint64 size, bool isDir)
+{
+    quint32 offset = intern(name.toUtf8());
+
+    m_parent.append(parent);
+    m_nameOffset.append(isDir ? (offset | kDirFlag) : offset);
+    m_size.append(size);
+    m_firstChild.append(0);
+    m_childCount.append(0);
+    return quint32(m_parent.size() - 1);
+}
+
+void DiskUsageTree::setChildren(quint32 node, quint32 first, quint32 count)
+{
+    m_firstChild[node] = first;
+    m_childCount[node] = count;
+}
+
+void DiskUsageTree::squeeze()
+{
+    m_internSlots.clear();
+    m_internSlots.squeeze();
+    m_internCount = 0;
+
+    m_parent.squeeze();
+    m_nameOffset.squeeze();
+    m_size.squeeze();
+    m_firstChild.squeeze();
+    m_childCount.squeeze();
+    m_names.squeeze();
+}
+
+QString DiskUsageTree::name(quint32 node) const
+{
+    quint32 offset = m_nameOffset[node] & ~kDirFlag;
+    return QString::fromUtf8(m_names.constData() + offset);
+}
+
+QString DiskUsageTree::path(quint32 node) const
+{
+    // The root node is named after the scanned path itself
+    QStringList parts;
+    for (quint32 n = node; n != NoNode; n = m_parent[n]) {
+        parts.prepend(name(n));
+    }
+
+    QString result = parts.takeFirst();
+    for (const QString &part : std::as_const(parts)) {
+        if (!result.endsWith('/')) result += '/';
+        result += part;
+    }
+    return result;
+}
+
+qint64 DiskUsageTree::memoryUsage() const
+{
+    return qint64(m_parent.capacity()) * sizeof(quint32)
+         + qint64(m_nameOffset.capacity()) * sizeof(quint32)
+         + qint64(m_size.capacity()) * sizeof(quint64)
+         + qint64(m_firstChild.capacity()) * sizeof(quint32)
+         + qint64(m_childCount.capacity()) * sizeof(quint32)
+         + m_names.capacity()
+         + qint64(m_internSlots.capacity()) * sizeof(quint32);
+}
+
+quint32 DiskUsageTree::intern(const QByteArray &name)
+{
+    if (m_internSlots.isEmpty()) {
+        // Interning was dropped by squeeze(); keep working, just without dedup
+        quint32 offset = quint32(m_names.size());
+        m_names.append(name.constData(), name.size() + 1);
+        return offset;
+    }
+
+    const size_t mask = size_t(m_internSlots.size() - 1);
+    size_t slot = qHash(name) & mask;
+    while (m_internSlots[slot] != kEmptySlot) {
+        const char *existing = m_names.constData() + m_internSlots[slot];
+        if (std::strncmp(existing, name.constData(), name.size()) == 0 && existing[name.size()] == '\0') {
+            return m_internSlots[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    quint32 offset = quint32(m_names.size());
+    m_names.append(name.constData(), name.size() + 1); // keep the terminating NUL
+    m_internSlots[slot] = offset;
+
+    // Keep probe chains short: grow at 50% load
+    if (++m_internCount * 2 > quint32(m_internSlots.size())) {
+        growInternTable();
+    }
+    return offset;
+}
+
+void DiskUsageTree::growInternTable()
+{
+    QList<quint32> oldSlots = m_internSlots;
+    m_internSlots.fill(kEmptySlot, oldSlots.size() * 2);
+
+    const size_t mask = size_t(m_internSlots.size() - 1);
+    for (quint32 offset : std::as_const(oldSlots)) {
+        if (offset == kEmptySlot) continue;
+
+        const char *name = m_names.constData() + offset;
+        size_t slot = qHash(QByteArray::fromRawData(name, qstrlen(name))) & mask;
+        while (m_internSlots[slot] != kEmptySlot) {
+            slot = (slot + 1) & mask;
+        }
+        m_internSlots[slot] = offset;
+    }
+}
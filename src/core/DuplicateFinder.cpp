@@ -0,0 +1,398 @@
+#include "DuplicateFinder.h"
+#include <QDebug>
+#include <QDirIterator>
+#include <QFile>
+#include <QHash>
+#include <QSemaphore>
+#include <QSet>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+constexpr qint64 kEdgeBlock = 4096;               // bytes hashed at each end in stage 2
+constexpr qint64 kReadBuffer = 1024 * 1024;       // full-hash read size
+constexpr int kMaxInFlight = 8;                   // files being read at once
+constexpr int kMaxCandidatesPerPass = 250000;     // bounds paths held in memory
+constexpr qint64 kProgressIntervalMs = 250;
+
+// XXH64 (public domain reference algorithm), streaming form
+class Xxh64
+{
+public:
+    explicit Xxh64(quint64 seed = 0)
+        : m_seed(seed)
+    {
+        m_v[0] = seed + kP1 + kP2;
+        m_v[1] = seed + kP2;
+        m_v[2] = seed;
+        m_v[3] = seed - kP1;
+    }
+
+    void update(const char *data, qint64 length)
+    {
+        const uchar *p = reinterpret_cast<const uchar *>(data);
+        m_total += quint64(length);
+
+        if (m_bufferLength + length < 32) {
+            std::memcpy(m_buffer + m_bufferLength, p, size_t(length));
+            m_bufferLength += int(length);
+            return;
+        }
+
+        if (m_bufferLength > 0) {
+            int fill = 32 - m_bufferLength;
+            std::memcpy(m_buffer + m_bufferLength, p, size_t(fill));
+            consumeStripe(m_buffer);
+            p += fill;
+            length -= fill;
+            m_bufferLength = 0;
+        }
+
+        while (length >= 32) {
+            consumeStripe(p);
+            p += 32;
+            length -= 32;
+        }
+
+        if (length > 0) {
+            std::memcpy(m_buffer, p, size_t(length));
+            m_bufferLength = int(length);
+        }
+    }
+
+    quint64 digest() const
+    {
+        quint64 h;
+        if (m_total >= 32) {
+            h = rotl(m_v[0], 1) + rotl(m_v[1], 7) + rotl(m_v[2], 12) + rotl(m_v[3], 18);
+            for (quint64 v : m_v) {
+                h = (h ^ round(0, v)) * kP1 + kP4;
+            }
+        } else {
+            h = m_seed + kP5;
+        }
+        h += m_total;
+
+        const uchar *p = m_buffer;
+        int remaining = m_bufferLength;
+        while (remaining >= 8) {
+            h ^= round(0, qFromLittleEndian<quint64>(p));
+            h = rotl(h, 27) * kP1 + kP4;
+            p += 8;
+            remaining -= 8;
+        }
+        if (remaining >= 4) {
+            h ^= quint64(qFromLittleEndian<quint32>(p)) * kP1;
+            h = rotl(h, 23) * kP2 + kP3;
+            p += 4;
+            remaining -= 4;
+        }
+        while (remaining > 0) {
+            h ^= quint64(*p) * kP5;
+            h = rotl(h, 11) * kP1;
+            ++p;
+            --remaining;
+        }
+
+        h ^= h >> 33;
+        h *= kP2;
+        h ^= h >> 29;
+        h *= kP3;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+    static constexpr quint64 kP1 = 11400714785074694791ULL;
+    static constexpr quint64 kP2 = 14029467366897019727ULL;
+    static constexpr quint64 kP3 = 1609587929392839161ULL;
+    static constexpr quint64 kP4 = 9650029242287828579ULL;
+    static constexpr quint64 kP5 = 2870177450012600261ULL;
+
+    quint64 m_seed;
+    quint64 m_v[4];
+    uchar m_buffer[32];
+    int m_bufferLength = 0;
+    quint64 m_total = 0;
+
+    static quint64 rotl(quint64 x, int r) { return (x << r) | (x >> (64 - r)); }
+    static quint64 round(quint64 acc, quint64 input)
+    {
+        acc += input * kP2;
+        acc = rotl(acc, 31);
+        return acc * kP1;
+    }
+
+    void consumeStripe(const uchar *p)
+    {
+        for (int i = 0; i < 4; ++i) {
+            m_v[i] = round(m_v[i], qFromLittleEndian<quint64>(p + i * 8));
+        }
+    }
+};
+}
+
+DuplicateFinder::DuplicateFinder(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(kMaxInFlight);
+}
+
+DuplicateFinder::~DuplicateFinder()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void DuplicateFinder::setRootPath(const QString &path)
+{
+    m_rootPath = path;
+    m_cancelRequested = false;
+}
+
+void DuplicateFinder::cancel()
+{
+    m_cancelRequested = true;
+}
+
+template <typename Fn>
+void DuplicateFinder::walkFiles(Fn visit)
+{
+    // Symlinks are neither reported nor followed
+    QDirIterator it(m_rootPath, QDir::Files | QDir::Hidden | QDir::System | QDir::NoSymLinks,
+                    QDirIterator::Subdirectories);
+
+    int entryCount = 0;
+    while (it.hasNext()) {
+        const QFileInfo info = it.nextFileInfo();
+        if (info.size() >= m_minFileSize) {
+            visit(info.filePath(), info.size());
+        }
+
+        if (++entryCount % 4096 == 0 && m_cancelRequested) return;
+    }
+}
+
+void DuplicateFinder::findDuplicates()
+{
+    m_totalReclaimable = 0;
+    m_lastProgressMs = 0;
+    m_progressTimer.start();
+
+    // Stage 1: only sizes are kept, so this is cheap even for millions of files
+    QHash<qint64, quint32> sizeCounts;
+    qint64 fileCount = 0;
+    walkFiles([&](const QString &, qint64 size) {
+        ++sizeCounts[size];
+        if (++fileCount % 4096 == 0) {
+            reportProgress(QString("Sizing: %1 files").arg(fileCount));
+        }
+    });
+
+    // Larger sizes first: they reclaim the most and show up early
+    QList<QPair<qint64, quint32>> sizes;
+    for (auto it = sizeCounts.constBegin(); it != sizeCounts.constEnd(); ++it) {
+        if (it.value() >= 2) sizes.append({it.key(), it.value()});
+    }
+    sizeCounts.clear();
+    std::sort(sizes.begin(), sizes.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    qint64 candidateTotal = 0;
+    for (const auto &entry : std::as_const(sizes)) candidateTotal += entry.second;
+    qDebug() << "Duplicate search:" << fileCount << "files," << candidateTotal << "share a size";
+
+    // Candidates are collected per size range so at most
+    // kMaxCandidatesPerPass paths are held at once
+    int next = 0;
+    while (next < sizes.size() && !m_cancelRequested) {
+        QSet<qint64> passSizes;
+        qint64 passCount = 0;
+        while (next < sizes.size() && (passCount == 0 || passCount + sizes[next].second <= kMaxCandidatesPerPass)) {
+            passSizes.insert(sizes[next].first);
+            passCount += sizes[next].second;
+            ++next;
+        }
+
+        QList<Candidate> candidates;
+        candidates.reserve(int(passCount));
+        walkFiles([&](const QString &path, qint64 size) {
+            if (passSizes.contains(size)) {
+                Candidate candidate;
+                candidate.path = path;
+                candidate.size = size;
+                candidates.append(candidate);
+            }
+        });
+
+        processCandidates(candidates);
+    }
+
+    bool cancelled = m_cancelRequested.load();
+    emit finished(m_totalReclaimable, cancelled);
+}
+
+void DuplicateFinder::processCandidates(QList<Candidate> &candidates)
+{
+    auto bySizeAndHash = [](const Candidate &a, const Candidate &b) {
+        if (a.size != b.size) return a.size > b.size;
+        if (a.hash != b.hash) return a.hash < b.hash;
+        if (a.dev != b.dev) return a.dev < b.dev;
+        return a.ino < b.ino;
+    };
+    auto sameContent = [](const Candidate &a, const Candidate &b) {
+        return a.size == b.size && a.hash == b.hash;
+    };
+
+    // Drops unreadable files, hard links to an already kept inode, and
+    // candidates left without a partner
+    auto keepCollisions = [&](QList<Candidate> &list) {
+        std::sort(list.begin(), list.end(), bySizeAndHash);
+
+        QList<Candidate> kept;
+        int start = 0;
+        while (start < list.size()) {
+            int end = start + 1;
+            while (end < list.size() && sameContent(list[start], list[end])) ++end;
+
+            QList<Candidate> group;
+            for (int i = start; i < end; ++i) {
+                const Candidate &c = list[i];
+                if (!c.readable) continue;
+                if (!group.isEmpty() && c.ino != 0 && c.dev == group.last().dev && c.ino == group.last().ino) continue;
+                group.append(c);
+            }
+            if (group.size() >= 2) kept.append(group);
+            start = end;
+        }
+        list = kept;
+    };
+
+    // Stage 2: first and last block
+    hashCandidates(candidates, true, "Comparing file edges");
+    if (m_cancelRequested) return;
+    keepCollisions(candidates);
+
+    // Stage 3: files larger than the two edge blocks need a full hash;
+    // smaller ones were already read completely
+    QList<Candidate> needFullHash;
+    QList<Candidate> complete;
+    for (Candidate &c : candidates) {
+        (c.size > 2 * kEdgeBlock ? needFullHash : complete).append(std::move(c));
+    }
+    candidates.clear();
+
+    hashCandidates(needFullHash, false, "Hashing");
+    if (m_cancelRequested) return;
+    keepCollisions(needFullHash);
+    complete.append(needFullHash);
+    needFullHash.clear();
+    std::sort(complete.begin(), complete.end(), bySizeAndHash);
+
+    QList<DuplicateGroup> groups;
+    int start = 0;
+    while (start < complete.size()) {
+        int end = start + 1;
+        while (end < complete.size() && sameContent(complete[start], complete[end])) ++end;
+
+        DuplicateGroup group;
+        group.fileSize = complete[start].size;
+        for (int i = start; i < end; ++i) {
+            group.paths.append(complete[i].path);
+        }
+        m_totalReclaimable += group.reclaimable();
+        groups.append(group);
+        start = end;
+    }
+
+    if (!groups.isEmpty()) {
+        emit groupsFound(groups);
+    }
+}
+
+void DuplicateFinder::hashCandidates(QList<Candidate> &candidates, bool partial, const QString &stage)
+{
+    // The semaphore keeps at most kMaxInFlight files open and reading;
+    // every task writes only its own candidate, so no locking is needed
+    QSemaphore inFlight(kMaxInFlight);
+    std::atomic<qint64> done{0};
+    const qint64 total = candidates.size();
+
+    for (int i = 0; i < candidates.size(); ++i) {
+        if (m_cancelRequested) break;
+
+        inFlight.acquire();
+        Candidate *candidate = &candidates[i];
+        m_pool.start([this, candidate, partial, &inFlight, &done]() {
+            candidate->readable = hashFile(*candidate, partial, m_cancelRequested);
+            ++done;
+            inFlight.release();
+        });
+
+        reportProgress(QString("%1: %2 / %3 files").arg(stage).arg(done.load()).arg(total));
+    }
+
+    m_pool.waitForDone();
+}
+
+bool DuplicateFinder::hashFile(Candidate &candidate, bool partial, const std::atomic<bool> &cancel)
+{
+    QFile file(candidate.path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) return false;
+
+#ifdef Q_OS_UNIX
+    // Identity of the inode, so hard links are not reported as duplicates
+    struct stat sb;
+    if (::fstat(file.handle(), &sb) == 0) {
+        candidate.dev = quint64(sb.st_dev);
+        candidate.ino = quint64(sb.st_ino);
+    }
+#endif
+#ifdef Q_OS_LINUX
+    if (!partial) {
+        ::posix_fadvise(file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+
+    Xxh64 hash;
+    if (partial) {
+        char block[kEdgeBlock];
+        qint64 head = file.read(block, std::min(candidate.size, kEdgeBlock));
+        if (head < 0) return false;
+        hash.update(block, head);
+
+        if (candidate.size > kEdgeBlock) {
+            // The tail block never overlaps the head
+            qint64 tailStart = std::max(kEdgeBlock, candidate.size - kEdgeBlock);
+            if (!file.seek(tailStart)) return false;
+            qint64 tail = file.read(block, candidate.size - tailStart);
+            if (tail < 0) return false;
+            hash.update(block, tail);
+        }
+    } else {
+        QByteArray buffer(int(std::min(candidate.size, kReadBuffer)), Qt::Uninitialized);
+        qint64 read;
+        while ((read = file.read(buffer.data(), buffer.size())) > 0) {
+            hash.update(buffer.constData(), read);
+            if (cancel) return false;
+        }
+        if (read < 0) return false;
+    }
+
+    candidate.hash = hash.digest();
+    return true;
+}
+
+void DuplicateFinder::reportProgress(const QString &progress)
+{
+    qint64 now = m_progressTimer.elapsed();
+    if (now - m_lastProgressMs < kProgressIntervalMs) return;
+
+    m_lastProgressMs = now;
+    emit progressUpdate(progress);
+}
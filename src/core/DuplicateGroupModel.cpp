@@ -0,0 +1,85 @@
+#include "DuplicateGroupModel.h"
+#include "CleanupTargetModel.h"
+#include <algorithm>
+
+DuplicateGroupModel::DuplicateGroupModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int DuplicateGroupModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return m_groups.size();
+}
+
+QVariant DuplicateGroupModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_groups.size()) {
+        return QVariant();
+    }
+
+    const DuplicateGroup &group = m_groups.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return group.paths.value(0);
+    case FileSizeRole:
+        return group.fileSize;
+    case FileSizeFormattedRole:
+        return CleanupTargetModel::formatSize(group.fileSize);
+    case FileCountRole:
+        return group.paths.size();
+    case ReclaimableRole:
+        return group.reclaimable();
+    case ReclaimableFormattedRole:
+        return CleanupTargetModel::formatSize(group.reclaimable());
+    case PathsRole:
+        return group.paths;
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> DuplicateGroupModel::roleNames() const
+{
+    return {
+        {FileSizeRole, "fileSize"},
+        {FileSizeFormattedRole, "fileSizeFormatted"},
+        {FileCountRole, "fileCount"},
+        {ReclaimableRole, "reclaimable"},
+        {ReclaimableFormattedRole, "reclaimableFormatted"},
+        {PathsRole, "paths"}
+    };
+}
+
+void DuplicateGroupModel::appendGroups(const QList<DuplicateGroup> &groups)
+{
+    if (groups.isEmpty()) return;
+
+    for (const DuplicateGroup &group : groups) {
+        auto it = std::upper_bound(m_groups.cbegin(), m_groups.cend(), group,
+                                   [](const DuplicateGroup &a, const DuplicateGroup &b) {
+                                       return a.reclaimable() > b.reclaimable();
+                                   });
+        int row = int(it - m_groups.cbegin());
+        beginInsertRows(QModelIndex(), row, row);
+        m_groups.insert(row, group);
+        m_totalReclaimable += group.reclaimable();
+        endInsertRows();
+    }
+
+    emit countChanged();
+    emit totalReclaimableChanged();
+}
+
+void DuplicateGroupModel::clear()
+{
+    if (m_groups.isEmpty()) return;
+
+    beginResetModel();
+    m_groups.clear();
+    m_totalReclaimable = 0;
+    endResetModel();
+
+    emit countChanged();
+    emit totalReclaimableChanged();
+}
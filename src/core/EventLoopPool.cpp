@@ -0,0 +1,63 @@
+#include "EventLoopPool.h"
+#include <QDebug>
+
+namespace {
+// Each loop only waits on file descriptors and timers, so a few are plenty
+constexpr int kMinThreads = 2;
+constexpr int kMaxThreads = 4;
+}
+
+EventLoopPool::EventLoopPool(int threadCount, QObject *parent)
+    : QObject(parent)
+{
+    if (threadCount <= 0) {
+        threadCount = qBound(kMinThreads, QThread::idealThreadCount() / 2, kMaxThreads);
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        QThread *thread = new QThread(this);
+        thread->setObjectName(QString("EventLoop-%1").arg(i));
+        thread->start();
+        m_threads.append(thread);
+        m_load.append(0);
+    }
+    qDebug() << "Event loop pool started with" << threadCount << "threads";
+}
+
+EventLoopPool::~EventLoopPool()
+{
+    // Objects still adopted are deleted on their thread as it finishes
+    for (auto it = m_assigned.cbegin(); it != m_assigned.cend(); ++it) {
+        it.key()->deleteLater();
+    }
+    for (QThread *thread : std::as_const(m_threads)) {
+        thread->quit();
+    }
+    for (QThread *thread : std::as_const(m_threads)) {
+        thread->wait();
+    }
+}
+
+void EventLoopPool::adopt(QObject *object)
+{
+    if (!object || m_assigned.contains(object)) return;
+
+    int best = 0;
+    for (int i = 1; i < m_load.size(); ++i) {
+        if (m_load[i] < m_load[best]) best = i;
+    }
+
+    object->moveToThread(m_threads[best]);
+    m_assigned.insert(object, best);
+    ++m_load[best];
+}
+
+void EventLoopPool::release(QObject *object)
+{
+    auto it = m_assigned.find(object);
+    if (it == m_assigned.end()) return;
+
+    --m_load[it.value()];
+    m_assigned.erase(it);
+    object->deleteLater();
+}
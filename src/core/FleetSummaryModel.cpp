@@ -0,0 +1,187 @@
+#include "FleetSummaryModel.h"
+#include "ProcStats.h"
+#include "ServerListModel.h"
+
+namespace {
+constexpr int kRefreshIntervalMs = 1000;
+constexpr int kMaxHotHosts = 5;
+}
+
+FleetSummaryModel::FleetSummaryModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    m_groups.push_back(std::make_unique<Group>());
+    m_rows.insert(QString(), 0);
+
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &FleetSummaryModel::refresh);
+}
+
+FleetSummaryModel::~FleetSummaryModel() = default;
+
+int FleetSummaryModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return int(m_groups.size());
+}
+
+QVariant FleetSummaryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= int(m_groups.size())) {
+        return QVariant();
+    }
+
+    const Group &group = *m_groups[size_t(index.row())];
+    switch (role) {
+    case Qt::DisplayRole:
+    case GroupRole:
+        return group.name.isEmpty() ? QStringLiteral("ALL") : group.name;
+    case ServersRole:
+        return group.servers;
+    case CpuP50Role:
+        return group.cpuP50;
+    case CpuP95Role:
+        return group.cpuP95;
+    case CpuP99Role:
+        return group.cpuP99;
+    case RamP99Role:
+        return group.ramP99;
+    case HotHostsRole:
+        return group.hotHosts.join(", ");
+    case NetUpRole:
+        return ProcStats::formatRate(group.netUp);
+    case NetDownRole:
+        return ProcStats::formatRate(group.netDown);
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> FleetSummaryModel::roleNames() const
+{
+    return {
+        {GroupRole, "group"},
+        {ServersRole, "servers"},
+        {CpuP50Role, "cpuP50"},
+        {CpuP95Role, "cpuP95"},
+        {CpuP99Role, "cpuP99"},
+        {RamP99Role, "ramP99"},
+        {HotHostsRole, "hotHosts"},
+        {NetUpRole, "netUp"},
+        {NetDownRole, "netDown"}
+    };
+}
+
+void FleetSummaryModel::setSample(const ServerInfo &server)
+{
+    auto it = m_members.find(server.id);
+    if (it != m_members.end()) {
+        apply(server.id, it.value(), -1);
+    } else {
+        it = m_members.insert(server.id, Member());
+    }
+
+    Member &member = it.value();
+    member.name = server.name;
+    member.groups = server.tags;
+    member.cpu = server.cpuUsage;
+    member.ram = server.ramUsage;
+    member.netUp = server.networkUp;
+    member.netDown = server.networkDown;
+    apply(server.id, member, +1);
+}
+
+void FleetSummaryModel::removeServer(const QString &id)
+{
+    const auto it = m_members.constFind(id);
+    if (it == m_members.constEnd()) return;
+
+    apply(id, it.value(), -1);
+    m_members.erase(it);
+}
+
+FleetSummaryModel::Group *FleetSummaryModel::group(const QString &name)
+{
+    const auto it = m_rows.constFind(name);
+    if (it != m_rows.constEnd()) return m_groups[size_t(it.value())].get();
+
+    const int row = int(m_groups.size());
+    beginInsertRows(QModelIndex(), row, row);
+    m_groups.push_back(std::make_unique<Group>());
+    m_groups.back()->name = name;
+    m_rows.insert(name, row);
+    endInsertRows();
+    emit countChanged();
+    return m_groups.back().get();
+}
+
+void FleetSummaryModel::apply(const QString &id, const Member &member, int sign)
+{
+    QStringList names = member.groups;
+    names.prepend(QString());
+
+    for (const QString &name : names) {
+        Group *target = group(name);
+        if (sign > 0) {
+            ++target->servers;
+            target->cpu.add(member.cpu);
+            target->ram.add(member.ram);
+            target->ramRanking.insert({member.ram, id});
+        } else {
+            --target->servers;
+            target->cpu.remove(member.cpu);
+            target->ram.remove(member.ram);
+            target->ramRanking.erase({member.ram, id});
+        }
+
+        // Running sums; an empty group starts again from exact zeros
+        if (target->servers == 0) {
+            target->netUp = 0.0;
+            target->netDown = 0.0;
+        } else {
+            target->netUp = qMax(0.0, target->netUp + sign * member.netUp);
+            target->netDown = qMax(0.0, target->netDown + sign * member.netDown);
+        }
+        target->dirty = true;
+    }
+
+    if (!m_refreshTimer.isActive()) m_refreshTimer.start();
+}
+
+void FleetSummaryModel::refresh()
+{
+    for (size_t row = 0; row < m_groups.size(); ++row) {
+        Group &group = *m_groups[row];
+        if (!group.dirty) continue;
+        group.dirty = false;
+
+        group.cpuP50 = group.cpu.quantile(0.50);
+        group.cpuP95 = group.cpu.quantile(0.95);
+        group.cpuP99 = group.cpu.quantile(0.99);
+        group.ramP99 = group.ram.quantile(0.99);
+
+        // Within the sketch's error of the p99 counts as above it
+        const double threshold = group.ramP99 * (1.0 - group.ram.relativeAccuracy());
+        group.hotHosts.clear();
+        for (auto it = group.ramRanking.rbegin(); it != group.ramRanking.rend(); ++it) {
+            if (it->first < threshold || group.hotHosts.size() >= kMaxHotHosts) break;
+            group.hotHosts.append(m_members.value(it->second).name);
+        }
+
+        const QModelIndex changed = index(int(row));
+        emit dataChanged(changed, changed);
+    }
+
+    // Tags nobody reports under any more go away; the fleet row stays
+    for (int row = int(m_groups.size()) - 1; row > 0; --row) {
+        if (m_groups[size_t(row)]->servers > 0) continue;
+        beginRemoveRows(QModelIndex(), row, row);
+        m_groups.erase(m_groups.begin() + row);
+        endRemoveRows();
+        emit countChanged();
+    }
+    m_rows.clear();
+    for (size_t row = 0; row < m_groups.size(); ++row) {
+        m_rows.insert(m_groups[row]->name, int(row));
+    }
+}
@@ -0,0 +1,107 @@
+#include "HistorySparkLine.h"
+#include "ServerListModel.h"
+#include <QPainter>
+#include <QPen>
+#include <QVarLengthArray>
+#include <cmath>
+
+HistorySparkLine::HistorySparkLine(QQuickItem *parent)
+    : QQuickPaintedItem(parent)
+{
+    setAntialiasing(true);
+}
+
+void HistorySparkLine::setSource(ServerListModel *source)
+{
+    if (m_source == source) return;
+    m_source = source;
+    emit sourceChanged();
+    update();
+}
+
+void HistorySparkLine::setServerId(const QString &id)
+{
+    if (m_serverId == id) return;
+    m_serverId = id;
+    emit serverIdChanged();
+    update();
+}
+
+void HistorySparkLine::setMetric(Metric metric)
+{
+    if (m_metric == metric) return;
+    m_metric = metric;
+    emit metricChanged();
+    update();
+}
+
+void HistorySparkLine::setTier(Tier tier)
+{
+    if (m_tier == tier) return;
+    m_tier = tier;
+    emit tierChanged();
+    update();
+}
+
+void HistorySparkLine::setRevision(quint32 revision)
+{
+    if (m_revision == revision) return;
+    m_revision = revision;
+    emit revisionChanged();
+    update();
+}
+
+void HistorySparkLine::setLineColor(const QColor &color)
+{
+    if (m_lineColor == color) return;
+    m_lineColor = color;
+    emit lineColorChanged();
+    update();
+}
+
+void HistorySparkLine::paint(QPainter *painter)
+{
+    const MetricHistory *history = m_source ? m_source->history(m_serverId) : nullptr;
+    if (!history) return;
+
+    const MetricHistory::Tier tier = MetricHistory::Tier(m_tier);
+    const MetricHistory::Metric metric = MetricHistory::Metric(m_metric);
+    const int count = history->count(tier);
+    if (count < 2) return;
+
+    // Percentages use a fixed scale; rates scale to the largest value shown
+    double scale = 100.0;
+    if (!MetricHistory::isPercent(metric)) {
+        scale = 0.0;
+        for (int i = 0; i < count; ++i) {
+            const double value = history->value(tier, metric, i);
+            if (!std::isnan(value)) scale = qMax(scale, value);
+        }
+        if (scale <= 0.0) scale = 1.0;
+    }
+
+    // Newest value at the right edge; a full ring spans the whole width
+    const double w = width();
+    const double h = height();
+    const double xStep = w / (MetricHistory::kCapacity[tier] - 1);
+    const double xStart = w - (count - 1) * xStep;
+
+    QPen pen(m_lineColor, 1.5);
+    painter->setPen(pen);
+
+    // Gaps split the line into separate runs
+    QVarLengthArray<QPointF, 128> run;
+    auto flush = [&]() {
+        if (run.size() > 1) painter->drawPolyline(run.constData(), int(run.size()));
+        run.clear();
+    };
+    for (int i = 0; i < count; ++i) {
+        const double value = history->value(tier, metric, i);
+        if (std::isnan(value)) {
+            flush();
+            continue;
+        }
+        run.append(QPointF(xStart + i * xStep, h - qBound(0.0, value / scale, 1.0) * h));
+    }
+    flush();
+}
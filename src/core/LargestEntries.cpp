@@ -0,0 +1,41 @@
+#include "LargestEntries.h"
+#include <algorithm>
+
+namespace {
+// Orders the heap so the smallest entry is on top
+bool largerFirst(const LargeEntry &a, const LargeEntry &b)
+{
+    return a.size > b.size;
+}
+}
+
+LargestEntries::LargestEntries(int capacity)
+    : m_capacity(qMax(0, capacity))
+{
+}
+
+void LargestEntries::setCapacity(int capacity)
+{
+    m_capacity = qMax(0, capacity);
+    m_heap.clear();
+    m_heap.reserve(m_capacity);
+}
+
+void LargestEntries::add(const QString &path, qint64 size)
+{
+    if (!accepts(size)) return;
+
+    if (m_heap.size() == m_capacity) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), largerFirst);
+        m_heap.removeLast();
+    }
+    m_heap.append({path, size});
+    std::push_heap(m_heap.begin(), m_heap.end(), largerFirst);
+}
+
+QList<LargeEntry> LargestEntries::sorted() const
+{
+    QList<LargeEntry> entries = m_heap;
+    std::sort(entries.begin(), entries.end(), largerFirst);
+    return entries;
+}
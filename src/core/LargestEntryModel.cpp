@@ -0,0 +1,55 @@
+#include "LargestEntryModel.h"
+#include "CleanupTargetModel.h"
+
+LargestEntryModel::LargestEntryModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int LargestEntryModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return m_entries.size();
+}
+
+QVariant LargestEntryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_entries.size()) {
+        return QVariant();
+    }
+
+    const LargeEntry &entry = m_entries.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case PathRole:
+        return entry.path;
+    case SizeRole:
+        return entry.size;
+    case SizeFormattedRole:
+        return CleanupTargetModel::formatSize(entry.size);
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> LargestEntryModel::roleNames() const
+{
+    return {
+        {PathRole, "path"},
+        {SizeRole, "size"},
+        {SizeFormattedRole, "sizeFormatted"}
+    };
+}
+
+void LargestEntryModel::setEntries(const QList<LargeEntry> &entries)
+{
+    beginResetModel();
+    m_entries = entries;
+    endResetModel();
+    emit countChanged();
+}
+
+void LargestEntryModel::clear()
+{
+    if (m_entries.isEmpty()) return;
+    setEntries({});
+}
@@ -0,0 +1,110 @@
+#include "MetricHistory.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr qint64 kPeriodMs[MetricHistory::TierCount] = {0, 60 * 1000, 15 * 60 * 1000};
+
+// Codes per doubling of a rate: 254 codes cover 2^33 B/s
+constexpr double kRateCodesPerOctave = 7.5;
+constexpr double kPercentCodesPerPoint = 2.5;
+}
+
+MetricHistory::MetricHistory()
+{
+    std::memset(m_data, kGap, sizeof(m_data));
+    int offset = 0;
+    for (int tier = 0; tier < TierCount; ++tier) {
+        m_tiers[tier].offset = offset;
+        offset += MetricCount * kCapacity[tier];
+    }
+}
+
+void MetricHistory::add(qint64 timeMs, const double values[MetricCount])
+{
+    push(Raw, values);
+    accumulate(Minute, timeMs / kPeriodMs[Minute], values);
+    ++m_revision;
+}
+
+double MetricHistory::value(Tier tier, Metric metric, int index) const
+{
+    const Ring &ring = m_tiers[tier];
+    if (index < 0 || index >= ring.count) return std::numeric_limits<double>::quiet_NaN();
+
+    const int capacity = kCapacity[tier];
+    const int slot = (ring.head - ring.count + index + capacity) % capacity;
+    return decode(metric, m_data[ring.offset + metric * capacity + slot]);
+}
+
+quint8 MetricHistory::encode(Metric metric, double value)
+{
+    if (std::isnan(value)) return kGap;
+    if (isPercent(metric)) {
+        return quint8(std::lround(qBound(0.0, value, 100.0) * kPercentCodesPerPoint));
+    }
+    const double code = std::log2(1.0 + qMax(0.0, value)) * kRateCodesPerOctave;
+    return quint8(qMin(254L, std::lround(code)));
+}
+
+double MetricHistory::decode(Metric metric, quint8 code)
+{
+    if (code == kGap) return std::numeric_limits<double>::quiet_NaN();
+    if (isPercent(metric)) return code / kPercentCodesPerPoint;
+    return std::exp2(code / kRateCodesPerOctave) - 1.0;
+}
+
+void MetricHistory::push(Tier tier, const double values[MetricCount])
+{
+    Ring &ring = m_tiers[tier];
+    const int capacity = kCapacity[tier];
+    for (int metric = 0; metric < MetricCount; ++metric) {
+        m_data[ring.offset + metric * capacity + ring.head] = encode(Metric(metric), values[metric]);
+    }
+    ring.head = (ring.head + 1) % capacity;
+    ring.count = qMin(ring.count + 1, capacity);
+}
+
+void MetricHistory::pushGap(Tier tier)
+{
+    double gap[MetricCount];
+    for (double &value : gap) value = std::numeric_limits<double>::quiet_NaN();
+    push(tier, gap);
+}
+
+void MetricHistory::accumulate(Tier tier, qint64 period, const double values[MetricCount])
+{
+    Rollup &rollup = m_rollups[tier];
+
+    if (rollup.period >= 0 && period != rollup.period) {
+        if (period < rollup.period) return; // Clock stepped back
+
+        // The finished period becomes one value here and feeds the next tier
+        if (rollup.samples > 0) {
+            double averages[MetricCount];
+            for (int metric = 0; metric < MetricCount; ++metric) {
+                averages[metric] = rollup.sums[metric] / rollup.samples;
+            }
+            push(tier, averages);
+            if (tier + 1 < TierCount) {
+                const Tier next = Tier(tier + 1);
+                accumulate(next, rollup.period * kPeriodMs[tier] / kPeriodMs[next], averages);
+            }
+        }
+
+        // Periods without a sample show as gaps
+        const qint64 missed = qMin<qint64>(period - rollup.period - 1, kCapacity[tier]);
+        for (qint64 i = 0; i < missed; ++i) {
+            pushGap(tier);
+        }
+
+        rollup = Rollup();
+    }
+
+    rollup.period = period;
+    ++rollup.samples;
+    for (int metric = 0; metric < MetricCount; ++metric) {
+        rollup.sums[metric] += values[metric];
+    }
+}
@@ -0,0 +1,196 @@
+#include "PollScheduler.h"
+#include <QDebug>
+#include <QRandomGenerator>
+#include <cmath>
+
+namespace {
+constexpr int kDefaultMaxInFlight = 32;
+// Polls due within one slice go out together
+constexpr int kSliceMs = 20;
+// A worker reports every poll well before this; past it the slot is freed
+constexpr int kPollTimeoutMs = 20000;
+constexpr qint64 kMaxBackoffMs = 5 * 60 * 1000;
+constexpr double kGoldenRatio = 0.6180339887498949;
+}
+
+PollScheduler::PollScheduler(QObject *parent)
+    : QObject(parent)
+    , m_maxInFlight(kDefaultMaxInFlight)
+{
+    m_clock.start();
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &PollScheduler::onTimer);
+}
+
+void PollScheduler::setMaxInFlight(int count)
+{
+    m_maxInFlight = qMax(1, count);
+    dispatchWaiting();
+}
+
+void PollScheduler::addServer(const QString &id, int intervalMs)
+{
+    if (m_entries.contains(id)) return;
+
+    Entry &entry = m_entries[id];
+    entry.intervalMs = qMax(1000, intervalMs);
+
+    // Golden-ratio phases stay evenly spread however many servers join
+    const double phase = std::fmod(double(m_added++) * kGoldenRatio, 1.0);
+    enqueue(id, entry, m_clock.elapsed() + qint64(phase * entry.intervalMs));
+    arm();
+}
+
+void PollScheduler::removeServer(const QString &id)
+{
+    const auto it = m_entries.find(id);
+    if (it == m_entries.end()) return;
+
+    // A waiting id is dropped when it comes up
+    if (it->state != Waiting) m_queue.erase(it->queued);
+    if (it->state == InFlight) --m_inFlight;
+    m_entries.erase(it);
+
+    dispatchWaiting();
+    arm();
+}
+
+void PollScheduler::setInterval(const QString &id, int intervalMs)
+{
+    const auto it = m_entries.find(id);
+    if (it == m_entries.end()) return;
+    it->intervalMs = qMax(1000, intervalMs);
+}
+
+void PollScheduler::pause()
+{
+    if (m_paused) return;
+    m_paused = true;
+    m_pausedAt = m_clock.elapsed();
+    m_timer.stop();
+}
+
+void PollScheduler::resume()
+{
+    if (!m_paused) return;
+    m_paused = false;
+
+    // Queued polls move by the length of the pause; timeouts of polls in
+    // flight stay where they are
+    const qint64 shift = m_clock.elapsed() - m_pausedAt;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->state != Queued) continue;
+        const qint64 due = it->queued->first;
+        m_queue.erase(it->queued);
+        it->scheduledMs += shift;
+        it->queued = m_queue.emplace(due + shift, it.key());
+    }
+
+    dispatchWaiting();
+    arm();
+}
+
+void PollScheduler::pollFinished(const QString &id, bool ok)
+{
+    const auto it = m_entries.find(id);
+    if (it == m_entries.end() || it->state != InFlight) return;
+
+    finish(id, *it, ok);
+    dispatchWaiting();
+    arm();
+}
+
+void PollScheduler::enqueue(const QString &id, Entry &entry, qint64 atMs)
+{
+    entry.state = Queued;
+    entry.scheduledMs = atMs;
+    entry.queued = m_queue.emplace(atMs, id);
+}
+
+void PollScheduler::dispatch(const QString &id, Entry &entry)
+{
+    entry.state = InFlight;
+    entry.dispatchedMs = m_clock.elapsed();
+    entry.queued = m_queue.emplace(entry.dispatchedMs + kPollTimeoutMs, id);
+    ++m_inFlight;
+    emit pollDue(id);
+}
+
+void PollScheduler::dispatchWaiting()
+{
+    while (!m_paused && m_inFlight < m_maxInFlight && !m_waiting.empty()) {
+        const QString id = m_waiting.front();
+        m_waiting.pop_front();
+
+        const auto it = m_entries.find(id);
+        if (it == m_entries.end() || it->state != Waiting) continue;
+        dispatch(id, *it);
+    }
+}
+
+void PollScheduler::finish(const QString &id, Entry &entry, bool ok)
+{
+    m_queue.erase(entry.queued);
+    --m_inFlight;
+
+    const qint64 now = m_clock.elapsed();
+    if (ok) {
+        entry.failures = 0;
+        m_latency.add(double(now - entry.dispatchedMs));
+        // Back on the server's own phase, skipping periods that already passed
+        qint64 next = entry.scheduledMs + entry.intervalMs;
+        if (next <= now) {
+            next += ((now - next) / entry.intervalMs + 1) * entry.intervalMs;
+        }
+        enqueue(id, entry, next);
+        return;
+    }
+
+    // Doubling backoff, jittered over its upper half so that hosts failing
+    // together do not retry together
+    ++entry.failures;
+    const qint64 backoff = qMin(kMaxBackoffMs, qint64(entry.intervalMs) << qMin(entry.failures, 16));
+    const qint64 delay = backoff / 2 + QRandomGenerator::global()->bounded(backoff / 2 + 1);
+    qDebug() << "Poll of" << id << "failed" << entry.failures << "times, retrying in" << delay << "ms";
+    enqueue(id, entry, now + delay);
+}
+
+void PollScheduler::onTimer()
+{
+    if (m_paused) return;
+
+    const qint64 horizon = m_clock.elapsed() + kSliceMs;
+    while (!m_queue.empty() && m_queue.begin()->first <= horizon) {
+        const QString id = m_queue.begin()->second;
+        Entry &entry = m_entries[id];
+
+        if (entry.state == InFlight) {
+            qDebug() << "Poll of" << id << "timed out";
+            finish(id, entry, false);
+            continue;
+        }
+
+        m_queue.erase(entry.queued);
+        if (m_inFlight < m_maxInFlight) {
+            dispatch(id, entry);
+        } else {
+            entry.state = Waiting;
+            m_waiting.push_back(id);
+        }
+    }
+
+    dispatchWaiting();
+    arm();
+}
+
+void PollScheduler::arm()
+{
+    if (m_paused) return;
+    if (m_queue.empty()) {
+        m_timer.stop();
+        return;
+    }
+
+    const qint64 wait = m_queue.begin()->first - m_clock.elapsed();
+    m_timer.start(int(qBound<qint64>(0, wait, 24 * 3600 * 1000)));
+}
@@ -0,0 +1,247 @@
+#include "ProcReader.h"
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Files are read in pieces of this size; only a single line longer than
+// this is lost
+constexpr size_t kReadBufferSize = 16384;
+
+const char *skipSpaces(const char *p)
+{
+    while (*p == ' ' || *p == '\t') ++p;
+    return p;
+}
+
+// Next unsigned number on the line; stays put at the end of the line
+uint64_t nextNumber(const char *&p)
+{
+    p = skipSpaces(p);
+    char *end = nullptr;
+    const uint64_t value = std::strtoull(p, &end, 10);
+    p = end;
+    return value;
+}
+
+// Calls handler(line) for every line of the file, NUL-terminated without
+// its newline, until it returns false. A line is handed over only once
+// its newline has been read, so a partial line left by one read(2) waits
+// for the next and a cut-off last line is never parsed. False when the
+// file cannot be opened.
+template <typename Handler>
+bool forEachLine(const char *path, Handler handler)
+{
+#ifdef __linux__
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    char buffer[kReadBufferSize];
+    size_t used = 0;
+    bool overlong = false; // inside a line that did not fit the buffer
+    for (;;) {
+        const ssize_t n = ::read(fd, buffer + used, sizeof(buffer) - used);
+        if (n <= 0) break;
+        used += size_t(n);
+
+        size_t start = 0;
+        while (char *newline = static_cast<char *>(std::memchr(buffer + start, '\n', used - start))) {
+            *newline = '\0';
+            const bool skip = overlong;
+            overlong = false;
+            if (!skip && !handler(static_cast<const char *>(buffer + start))) {
+                ::close(fd);
+                return true;
+            }
+            start = size_t(newline - buffer) + 1;
+        }
+
+        std::memmove(buffer, buffer + start, used - start);
+        used -= start;
+        if (used == sizeof(buffer)) {
+            overlong = true;
+            used = 0;
+        }
+    }
+    ::close(fd);
+    return true;
+#else
+    (void)path;
+    (void)handler;
+    return false;
+#endif
+}
+}
+
+bool ProcReader::readCpu(uint64_t &total, uint64_t &idle)
+{
+    bool found = false;
+    forEachLine("/proc/stat", [&](const char *line) {
+        if (std::strncmp(line, "cpu ", 4) != 0) return false;
+
+        // cpu  user nice system idle iowait irq softirq steal guest guest_nice
+        // guest time is already part of user, so only the first eight count
+        const char *p = line + 4;
+        uint64_t fields[8] = {};
+        for (uint64_t &field : fields) field = nextNumber(p);
+
+        total = 0;
+        for (uint64_t field : fields) total += field;
+        idle = fields[3] + fields[4];
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool ProcReader::readMemory(uint64_t &totalKb, uint64_t &availableKb)
+{
+    totalKb = 0;
+    availableKb = 0;
+    forEachLine("/proc/meminfo", [&](const char *line) {
+        if (std::strncmp(line, "MemTotal:", 9) == 0) {
+            const char *p = line + 9;
+            totalKb = nextNumber(p);
+        } else if (std::strncmp(line, "MemAvailable:", 13) == 0) {
+            const char *p = line + 13;
+            availableKb = nextNumber(p);
+        }
+        return true;
+    });
+    return totalKb > 0;
+}
+
+bool ProcReader::readNetwork(uint64_t &rxBytes, uint64_t &txBytes)
+{
+    rxBytes = 0;
+    txBytes = 0;
+    //   eth0: rx_bytes rx_packets ... (8 rx fields) tx_bytes ...
+    return forEachLine("/proc/net/dev", [&](const char *line) {
+        const char *colon = std::strchr(line, ':');
+        if (!colon) return true; // header lines
+
+        const char *name = skipSpaces(line);
+        if (colon - name == 2 && std::strncmp(name, "lo", 2) == 0) return true;
+
+        const char *p = colon + 1;
+        uint64_t fields[9] = {};
+        for (uint64_t &field : fields) field = nextNumber(p);
+        rxBytes += fields[0];
+        txBytes += fields[8];
+        return true;
+    });
+}
+
+bool ProcReader::readDiskStats(uint64_t &readSectors, uint64_t &writtenSectors)
+{
+    readSectors = 0;
+    writtenSectors = 0;
+    // major minor name reads merged sectors_read ms writes merged sectors_written ...
+    return forEachLine("/proc/diskstats", [&](const char *line) {
+        const char *p = line;
+        nextNumber(p);
+        nextNumber(p);
+        p = skipSpaces(p);
+
+        char name[64];
+        size_t length = 0;
+        while (p[length] && p[length] != ' ' && length < sizeof(name) - 1) {
+            name[length] = p[length];
+            ++length;
+        }
+        name[length] = '\0';
+        p += length;
+        if (!isWholeDisk(name)) return true;
+
+        uint64_t fields[7] = {};
+        for (uint64_t &field : fields) field = nextNumber(p);
+        readSectors += fields[2];
+        writtenSectors += fields[6];
+        return true;
+    });
+}
+
+bool ProcReader::readFileSystem(const char *path, uint64_t &usedBytes, uint64_t &availableBytes)
+{
+#ifdef __linux__
+    struct statvfs st;
+    if (::statvfs(path, &st) != 0 || st.f_blocks == 0) return false;
+    // As df computes it: used excludes the root reserve, available does not
+    usedBytes = uint64_t(st.f_blocks - st.f_bfree) * st.f_frsize;
+    availableBytes = uint64_t(st.f_bavail) * st.f_frsize;
+    return true;
+#else
+    (void)path;
+    (void)usedBytes;
+    (void)availableBytes;
+    return false;
+#endif
+}
+
+uint64_t ProcReader::monotonicMs()
+{
+#ifdef __linux__
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000 + uint64_t(ts.tv_nsec) / 1000000;
+#else
+    return 0;
+#endif
+}
+
+void ProcReader::sample(AgentSample &sample)
+{
+    sample = AgentSample();
+    sample.set(AgentUptimeMs, monotonicMs());
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (readCpu(a, b)) {
+        sample.set(AgentCpuTotal, a);
+        sample.set(AgentCpuIdle, b);
+    }
+    if (readMemory(a, b)) {
+        sample.set(AgentMemTotalKb, a);
+        sample.set(AgentMemAvailableKb, b);
+    }
+    if (readNetwork(a, b)) {
+        sample.set(AgentNetRxBytes, a);
+        sample.set(AgentNetTxBytes, b);
+    }
+    if (readDiskStats(a, b)) {
+        sample.set(AgentDiskReadSectors, a);
+        sample.set(AgentDiskWrittenSectors, b);
+    }
+    if (readFileSystem("/", a, b)) {
+        sample.set(AgentFsUsedBytes, a);
+        sample.set(AgentFsAvailableBytes, b);
+    }
+}
+
+bool ProcReader::isWholeDisk(const char *name)
+{
+    // Virtual and stacked devices would count the same I/O twice
+    static const char *const kSkipped[] = {"loop", "ram", "zram", "dm-", "md", "sr", "fd"};
+    for (const char *prefix : kSkipped) {
+        if (std::strncmp(name, prefix, std::strlen(prefix)) == 0) return false;
+    }
+
+    const size_t length = std::strlen(name);
+    if (length == 0) return false;
+
+    // nvme0n1p2, mmcblk0p1
+    if (std::strncmp(name, "nvme", 4) == 0 || std::strncmp(name, "mmcblk", 6) == 0) {
+        const char *p = std::strrchr(name, 'p');
+        if (!p || p == name || p[1] == '\0') return true;
+        return !(p[1] >= '0' && p[1] <= '9' && p[-1] >= '0' && p[-1] <= '9');
+    }
+    // sda1, vdb2, xvda3
+    const char last = name[length - 1];
+    return !(last >= '0' && last <= '9');
+}
@@ -0,0 +1,218 @@
+#include "ProcStats.h"
+#include "ProcReader.h"
+
+namespace {
+constexpr quint64 kSectorBytes = 512;
+
+enum class Section {
+    None,
+    Uptime,
+    Stat,
+    Meminfo,
+    NetDev,
+    DiskStats,
+    StatFs
+};
+
+Section sectionFor(const QString &tag)
+{
+    if (tag == "@uptime") return Section::Uptime;
+    if (tag == "@stat") return Section::Stat;
+    if (tag == "@meminfo") return Section::Meminfo;
+    if (tag == "@netdev") return Section::NetDev;
+    if (tag == "@diskstats") return Section::DiskStats;
+    if (tag == "@statfs") return Section::StatFs;
+    return Section::None;
+}
+
+// Counters only go up; a reset (reboot, driver reload) reads as no traffic
+double perSecond(quint64 previous, quint64 current, double seconds)
+{
+    if (current < previous || seconds <= 0.0) return 0.0;
+    return double(current - previous) / seconds;
+}
+
+// Each section costs a builtin read loop over one small file
+const char *const kSampleBody =
+    "echo @@sample; "
+    "echo @uptime; read -r l < /proc/uptime; echo \"$l\"; "
+    "echo @stat; read -r l < /proc/stat; echo \"$l\"; "
+    "echo @meminfo; while read -r k v _; do case $k in MemTotal:|MemAvailable:) echo \"$k $v\";; esac; done < /proc/meminfo; "
+    "echo @netdev; while IFS= read -r l; do echo \"$l\"; done < /proc/net/dev; "
+    "echo @diskstats; while IFS= read -r l; do echo \"$l\"; done < /proc/diskstats; ";
+
+const char *const kStatFs = "echo @statfs; stat -f -c \"%b %f %a %S\" /; ";
+}
+
+QString ProcStats::sampleScript(bool withStatFs)
+{
+    QString script = QString::fromLatin1(kSampleBody);
+    if (withStatFs) script += QString::fromLatin1(kStatFs);
+    script += "echo @@end";
+    return script;
+}
+
+QString ProcStats::streamScript(int statFsEvery)
+{
+    return QString("n=0; while read -r _; do %1"
+                   "[ $((n % %2)) -eq 0 ] && { %3}; "
+                   "n=$((n + 1)); echo @@end; done")
+        .arg(QString::fromLatin1(kSampleBody))
+        .arg(qMax(1, statFsEvery))
+        .arg(QString::fromLatin1(kStatFs));
+}
+
+bool ProcStats::parseFrame(const QStringList &lines, ProcSample &sample)
+{
+    sample = ProcSample();
+    Section section = Section::None;
+
+    for (const QString &line : lines) {
+        if (line.startsWith('@')) {
+            section = sectionFor(line.trimmed());
+            continue;
+        }
+
+        switch (section) {
+        case Section::Uptime:
+            // 123456.78 234567.89
+            sample.uptimeSeconds = line.section(' ', 0, 0).toDouble();
+            break;
+        case Section::Stat: {
+            // cpu  user nice system idle iowait irq softirq steal guest guest_nice
+            // guest time is already part of user, so only the first eight count
+            const QStringList parts = line.simplified().split(' ');
+            if (parts.size() < 5 || parts[0] != "cpu") break;
+            quint64 total = 0;
+            for (int i = 1; i < parts.size() && i <= 8; ++i) {
+                total += parts[i].toULongLong();
+            }
+            sample.cpuTotal = total;
+            sample.cpuIdle = parts[4].toULongLong() + parts.value(5).toULongLong();
+            sample.hasCpu = true;
+            break;
+        }
+        case Section::Meminfo:
+            if (line.startsWith("MemTotal:")) {
+                sample.memTotalKb = line.simplified().section(' ', 1, 1).toULongLong();
+            } else if (line.startsWith("MemAvailable:")) {
+                sample.memAvailableKb = line.simplified().section(' ', 1, 1).toULongLong();
+            }
+            break;
+        case Section::NetDev: {
+            //   eth0: rx_bytes rx_packets ... (8 rx fields) tx_bytes ...
+            const int colon = line.indexOf(':');
+            if (colon < 0) break; // header lines
+            if (line.left(colon).trimmed() == "lo") break;
+            const QStringList parts = line.mid(colon + 1).simplified().split(' ');
+            if (parts.size() < 9) break;
+            sample.netRxBytes += parts[0].toULongLong();
+            sample.netTxBytes += parts[8].toULongLong();
+            sample.hasNet = true;
+            break;
+        }
+        case Section::DiskStats: {
+            // major minor name reads merged sectors_read ms writes merged sectors_written ...
+            const QStringList parts = line.simplified().split(' ');
+            if (parts.size() < 10 || !ProcReader::isWholeDisk(parts[2].toLatin1().constData())) break;
+            sample.diskReadSectors += parts[5].toULongLong();
+            sample.diskWrittenSectors += parts[9].toULongLong();
+            sample.hasDiskIo = true;
+            break;
+        }
+        case Section::StatFs: {
+            // blocks free available block_size, as df computes it
+            const QStringList parts = line.simplified().split(' ');
+            if (parts.size() < 4) break;
+            const quint64 blockSize = parts[3].toULongLong();
+            const quint64 blocks = parts[0].toULongLong();
+            const quint64 freeBlocks = parts[1].toULongLong();
+            sample.fsUsedBytes = (blocks - qMin(blocks, freeBlocks)) * blockSize;
+            sample.fsAvailableBytes = parts[2].toULongLong() * blockSize;
+            sample.hasFs = blocks > 0;
+            break;
+        }
+        case Section::None:
+            break;
+        }
+    }
+
+    return sample.hasCpu;
+}
+
+bool ProcStats::fromAgent(const AgentSample &agent, ProcSample &sample)
+{
+    sample = ProcSample();
+    if (agent.has(AgentUptimeMs)) {
+        sample.uptimeSeconds = agent.values[AgentUptimeMs] / 1000.0;
+    }
+
+    sample.hasCpu = agent.has(AgentCpuTotal) && agent.has(AgentCpuIdle);
+    sample.cpuTotal = agent.values[AgentCpuTotal];
+    sample.cpuIdle = agent.values[AgentCpuIdle];
+
+    sample.memTotalKb = agent.values[AgentMemTotalKb];
+    sample.memAvailableKb = agent.values[AgentMemAvailableKb];
+
+    sample.hasNet = agent.has(AgentNetRxBytes);
+    sample.netRxBytes = agent.values[AgentNetRxBytes];
+    sample.netTxBytes = agent.values[AgentNetTxBytes];
+
+    sample.hasDiskIo = agent.has(AgentDiskReadSectors);
+    sample.diskReadSectors = agent.values[AgentDiskReadSectors];
+    sample.diskWrittenSectors = agent.values[AgentDiskWrittenSectors];
+
+    sample.hasFs = agent.has(AgentFsUsedBytes);
+    sample.fsUsedBytes = agent.values[AgentFsUsedBytes];
+    sample.fsAvailableBytes = agent.values[AgentFsAvailableBytes];
+
+    return sample.hasCpu;
+}
+
+ProcRates ProcStats::rates(const ProcSample &previous, const ProcSample &current, double fallbackSeconds)
+{
+    ProcRates rates;
+
+    double seconds = fallbackSeconds;
+    if (previous.uptimeSeconds >= 0.0 && current.uptimeSeconds > previous.uptimeSeconds) {
+        seconds = current.uptimeSeconds - previous.uptimeSeconds;
+    }
+
+    if (previous.hasCpu && current.hasCpu && current.cpuTotal > previous.cpuTotal
+        && current.cpuIdle >= previous.cpuIdle) {
+        const double idle = double(current.cpuIdle - previous.cpuIdle);
+        const double total = double(current.cpuTotal - previous.cpuTotal);
+        rates.cpuPercent = qBound(0.0, 100.0 * (1.0 - idle / total), 100.0);
+    }
+
+    if (current.memTotalKb > 0) {
+        const quint64 available = qMin(current.memAvailableKb, current.memTotalKb);
+        rates.ramPercent = 100.0 * double(current.memTotalKb - available) / double(current.memTotalKb);
+    }
+
+    if (current.hasFs && current.fsUsedBytes + current.fsAvailableBytes > 0) {
+        rates.diskPercent = 100.0 * double(current.fsUsedBytes)
+                            / double(current.fsUsedBytes + current.fsAvailableBytes);
+    }
+
+    if (previous.hasNet && current.hasNet) {
+        rates.netUpBytesPerSec = perSecond(previous.netTxBytes, current.netTxBytes, seconds);
+        rates.netDownBytesPerSec = perSecond(previous.netRxBytes, current.netRxBytes, seconds);
+    }
+
+    if (previous.hasDiskIo && current.hasDiskIo) {
+        rates.diskReadBytesPerSec = perSecond(previous.diskReadSectors, current.diskReadSectors, seconds) * kSectorBytes;
+        rates.diskWriteBytesPerSec = perSecond(previous.diskWrittenSectors, current.diskWrittenSectors, seconds) * kSectorBytes;
+    }
+
+    return rates;
+}
+
+QString ProcStats::formatRate(double bytesPerSecond)
+{
+    const double kb = bytesPerSecond / 1024.0;
+    if (kb > 1024) {
+        return QString::number(kb / 1024.0, 'f', 2) + " MB/s";
+    }
+    return QString::number(kb, 'f', 1) + " KB/s";
+}
@@ -0,0 +1,170 @@
+#include "ProcessPathIndex.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <cstdlib>
+
+#ifdef Q_OS_LINUX
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef Q_OS_LINUX
+// Environment variables naming a directory the process runs out of
+constexpr const char *kEnvPrefixes[] = {"VIRTUAL_ENV=", "CONDA_PREFIX="};
+
+QString readLinkAt(int dirFd, const char *name)
+{
+    char buffer[4096];
+    ssize_t length = ::readlinkat(dirFd, name, buffer, sizeof(buffer));
+    if (length <= 0 || buffer[0] != '/') return QString(); // sockets, pipes, anon inodes
+    return QFile::decodeName(QByteArray(buffer, int(length)));
+}
+#endif
+}
+
+ProcessPathIndex::ProcessPathIndex()
+{
+    clear();
+}
+
+bool ProcessPathIndex::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ProcessPathIndex::clear()
+{
+    m_nodes.clear();
+    m_nodes.append(Node());
+    m_processNames.clear();
+    m_pathCount = 0;
+}
+
+void ProcessPathIndex::build()
+{
+    clear();
+
+#ifdef Q_OS_LINUX
+    QElapsedTimer timer;
+    timer.start();
+
+    DIR *proc = ::opendir("/proc");
+    if (!proc) return;
+
+    const int self = int(::getpid());
+    int processCount = 0;
+
+    while (struct dirent *entry = ::readdir(proc)) {
+        char *end = nullptr;
+        const long pid = std::strtol(entry->d_name, &end, 10);
+        if (pid <= 0 || *end != '\0' || pid == self) continue;
+
+        // Other users' processes mostly refuse fd/maps; whatever is
+        // readable is used
+        const int pidFd = ::openat(::dirfd(proc), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (pidFd < 0) continue;
+        const int before = m_pathCount;
+
+        for (const char *link : {"cwd", "exe"}) {
+            const QString path = readLinkAt(pidFd, link);
+            if (!path.isEmpty()) insert(path, int(pid));
+        }
+
+        const int fdDirFd = ::openat(pidFd, "fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (DIR *fds = fdDirFd >= 0 ? ::fdopendir(fdDirFd) : nullptr) {
+            while (struct dirent *fd = ::readdir(fds)) {
+                if (fd->d_name[0] == '.') continue;
+                const QString path = readLinkAt(::dirfd(fds), fd->d_name);
+                if (!path.isEmpty()) insert(path, int(pid));
+            }
+            ::closedir(fds);
+        } else if (fdDirFd >= 0) {
+            ::close(fdDirFd);
+        }
+
+        // Mapped executables and shared objects; consecutive mappings of
+        // the same file are common and skipped
+        const QString procPath = QStringLiteral("/proc/") + QString::fromLatin1(entry->d_name);
+        QFile maps(procPath + "/maps");
+        if (maps.open(QIODevice::ReadOnly)) {
+            QByteArray previous;
+            const QList<QByteArray> lines = maps.readAll().split('\n');
+            for (const QByteArray &line : lines) {
+                const int slash = line.indexOf('/');
+                if (slash < 0) continue;
+                const QByteArray path = line.mid(slash);
+                if (path == previous) continue;
+                previous = path;
+                insert(QFile::decodeName(path), int(pid));
+            }
+        }
+
+        QFile environment(procPath + "/environ");
+        if (environment.open(QIODevice::ReadOnly)) {
+            const QList<QByteArray> vars = environment.readAll().split('\0');
+            for (const QByteArray &var : vars) {
+                for (const char *prefix : kEnvPrefixes) {
+                    if (var.startsWith(prefix)) {
+                        insert(QFile::decodeName(var.mid(int(qstrlen(prefix)))), int(pid));
+                    }
+                }
+            }
+        }
+
+        ::close(pidFd);
+        if (m_pathCount == before) continue;
+
+        ++processCount;
+        QFile comm(procPath + "/comm");
+        if (comm.open(QIODevice::ReadOnly)) {
+            m_processNames.insert(int(pid), QString::fromUtf8(comm.readAll().trimmed()));
+        }
+    }
+    ::closedir(proc);
+
+    qDebug() << "Process path index:" << m_pathCount << "paths from" << processCount << "processes,"
+             << m_nodes.size() << "nodes in" << timer.elapsed() << "ms";
+#endif
+}
+
+void ProcessPathIndex::insert(QStringView path, int pid)
+{
+    // Files unlinked while open still pin nothing on disk
+    if (path.endsWith(u" (deleted)")) return;
+
+    int node = 0;
+    if (!m_nodes[node].pid) m_nodes[node].pid = pid;
+    for (QStringView component : path.tokenize(u'/', Qt::SkipEmptyParts)) {
+        const QString key = component.toString();
+        int child = m_nodes.at(node).children.value(key, -1);
+        if (child < 0) {
+            child = m_nodes.size();
+            m_nodes[node].children.insert(key, child);
+            m_nodes.append(Node());
+            m_nodes[child].pid = pid;
+        }
+        node = child;
+    }
+    ++m_pathCount;
+}
+
+QString ProcessPathIndex::processUsing(const QString &dirPath) const
+{
+    if (m_pathCount == 0) return QString();
+
+    int node = 0;
+    for (QStringView component : QStringView(dirPath).tokenize(u'/', Qt::SkipEmptyParts)) {
+        node = m_nodes.at(node).children.value(component.toString(), -1);
+        if (node < 0) return QString();
+    }
+
+    const int pid = m_nodes.at(node).pid;
+    return QString("%1 (%2)").arg(m_processNames.value(pid, QStringLiteral("pid"))).arg(pid);
+}
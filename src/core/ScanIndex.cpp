@@ -0,0 +1,302 @@
+#include "ScanIndex.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace {
+constexpr char kMagic[8] = {'A', 'C', 'S', 'C', 'N', 'I', 'D', 'X'};
+constexpr quint32 kVersion = 1;
+
+quint64 align8(quint64 value)
+{
+    return (value + 7) & ~quint64(7);
+}
+}
+
+struct ScanIndex::Header {
+    char magic[8];
+    quint32 version;
+    quint32 dirCount;
+    quint32 targetCount;
+    quint32 rootPathLength;
+    qint64 scanTimeMs;
+    quint64 dirsOffset;
+    quint64 targetsOffset;
+    quint64 namesOffset;
+    quint64 namesSize;
+    quint32 rootPathOffset;
+    quint32 reserved;
+};
+
+static_assert(sizeof(ScanIndex::DirRecord) % 8 == 0, "DirRecord must keep 8-byte alignment");
+static_assert(sizeof(ScanIndex::TargetRecord) % 8 == 0, "TargetRecord must keep 8-byte alignment");
+
+ScanIndex::~ScanIndex()
+{
+    close();
+}
+
+bool ScanIndex::open(const QString &fileName, const QString &rootPath)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(Header))) {
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        close();
+        return false;
+    }
+
+    // Validate every section against the file size before trusting offsets
+    const Header *h = header();
+    const quint64 size = quint64(m_size);
+    bool valid = std::memcmp(h->magic, kMagic, sizeof(kMagic)) == 0
+        && h->version == kVersion
+        && h->dirsOffset + quint64(h->dirCount) * sizeof(DirRecord) <= size
+        && h->targetsOffset + quint64(h->targetCount) * sizeof(TargetRecord) <= size
+        && h->namesOffset + h->namesSize <= size
+        && h->dirsOffset % 8 == 0 && h->targetsOffset % 8 == 0;
+
+    if (!valid || string(h->rootPathOffset, h->rootPathLength) != rootPath) {
+        qDebug() << "Ignoring scan index" << fileName << "- invalid or for another root";
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void ScanIndex::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    m_size = 0;
+    m_file.close();
+}
+
+int ScanIndex::dirCount() const
+{
+    return m_data ? int(header()->dirCount) : 0;
+}
+
+const ScanIndex::DirRecord &ScanIndex::dir(int index) const
+{
+    const auto *dirs = reinterpret_cast<const DirRecord *>(m_data + header()->dirsOffset);
+    return dirs[index];
+}
+
+QString ScanIndex::name(int index) const
+{
+    const DirRecord &record = dir(index);
+    return string(record.nameOffset, record.nameLength);
+}
+
+qint64 ScanIndex::scanTimeMs() const
+{
+    return m_data ? header()->scanTimeMs : 0;
+}
+
+QList<CleanupTarget> ScanIndex::targets() const
+{
+    QList<CleanupTarget> result;
+    if (!m_data) return result;
+
+    const Header *h = header();
+    const auto *records = reinterpret_cast<const TargetRecord *>(m_data + h->targetsOffset);
+    result.reserve(h->targetCount);
+    for (quint32 i = 0; i < h->targetCount; ++i) {
+        const TargetRecord &record = records[i];
+        CleanupTarget target;
+        target.path = string(record.pathOffset, record.pathLength);
+        target.type = string(record.typeOffset, record.typeLength);
+        target.reason = string(record.reasonOffset, record.reasonLength);
+        target.size = qint64(record.size);
+        target.lastModified = QDateTime::fromMSecsSinceEpoch(record.lastModifiedMs);
+        target.isSafe = record.isSafe != 0;
+        result.append(target);
+    }
+    return result;
+}
+
+bool ScanIndex::isUnchanged(int index, const DirStat &st) const
+{
+    if (index < 0 || index >= dirCount()) return false;
+
+    const DirRecord &record = dir(index);
+    return record.dev == st.dev
+        && record.ino == st.ino
+        && record.mtimeNs == st.mtimeNs
+        && record.ctimeNs == st.ctimeNs;
+}
+
+bool ScanIndex::isSupported()
+{
+#ifdef Q_OS_UNIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ScanIndex::statDirectory(const QString &path, DirStat &st)
+{
+#ifdef Q_OS_UNIX
+    struct stat sb;
+    if (::lstat(QFile::encodeName(path).constData(), &sb) != 0) return false;
+    if (!S_ISDIR(sb.st_mode)) return false;
+
+    st.dev = quint64(sb.st_dev);
+    st.ino = quint64(sb.st_ino);
+#if defined(Q_OS_DARWIN)
+    st.mtimeNs = qint64(sb.st_mtimespec.tv_sec) * 1000000000 + sb.st_mtimespec.tv_nsec;
+    st.ctimeNs = qint64(sb.st_ctimespec.tv_sec) * 1000000000 + sb.st_ctimespec.tv_nsec;
+#else
+    st.mtimeNs = qint64(sb.st_mtim.tv_sec) * 1000000000 + sb.st_mtim.tv_nsec;
+    st.ctimeNs = qint64(sb.st_ctim.tv_sec) * 1000000000 + sb.st_ctim.tv_nsec;
+#endif
+    return true;
+#else
+    Q_UNUSED(path);
+    Q_UNUSED(st);
+    return false;
+#endif
+}
+
+QString ScanIndex::indexPathFor(const QString &rootPath)
+{
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QByteArray key = QCryptographicHash::hash(QDir::cleanPath(rootPath).toUtf8(),
+                                              QCryptographicHash::Sha1).toHex().left(16);
+    return cacheDir + "/scan-index-" + QString::fromLatin1(key) + ".bin";
+}
+
+const ScanIndex::Header *ScanIndex::header() const
+{
+    return reinterpret_cast<const Header *>(m_data);
+}
+
+QString ScanIndex::string(quint32 offset, quint32 length) const
+{
+    const Header *h = header();
+    if (quint64(offset) + length > h->namesSize) return QString();
+    return QString::fromUtf8(reinterpret_cast<const char *>(m_data + h->namesOffset + offset),
+                             length);
+}
+
+// ============ ScanIndexWriter Implementation ============
+
+void ScanIndexWriter::clear()
+{
+    m_dirs.clear();
+    m_targets.clear();
+    m_names.clear();
+}
+
+int ScanIndexWriter::beginDirectory(const ScanIndex::DirStat &st, const QString &name)
+{
+    ScanIndex::DirRecord record = {};
+    record.dev = st.dev;
+    record.ino = st.ino;
+    record.mtimeNs = st.mtimeNs;
+    record.ctimeNs = st.ctimeNs;
+    appendString(name, record.nameOffset, record.nameLength);
+
+    m_dirs.append(record);
+    return int(m_dirs.size() - 1);
+}
+
+void ScanIndexWriter::endDirectory(int slot, quint64 ownBytes, quint32 ownFiles, quint64 totalBytes)
+{
+    if (slot < 0 || slot >= m_dirs.size()) return;
+
+    ScanIndex::DirRecord &record = m_dirs[slot];
+    record.ownBytes = ownBytes;
+    record.ownFiles = ownFiles;
+    record.totalBytes = totalBytes;
+    record.subtreeEnd = quint32(m_dirs.size());
+}
+
+void ScanIndexWriter::addTarget(const CleanupTarget &target)
+{
+    ScanIndex::TargetRecord record = {};
+    record.size = quint64(target.size);
+    record.lastModifiedMs = target.lastModified.toMSecsSinceEpoch();
+    record.isSafe = target.isSafe ? 1 : 0;
+    appendString(target.path, record.pathOffset, record.pathLength);
+    appendString(target.type, record.typeOffset, record.typeLength);
+    appendString(target.reason, record.reasonOffset, record.reasonLength);
+    m_targets.append(record);
+}
+
+bool ScanIndexWriter::save(const QString &fileName, const QString &rootPath, qint64 scanTimeMs) const
+{
+    QByteArray names = m_names;
+    quint32 rootOffset = quint32(names.size());
+    QByteArray rootUtf8 = rootPath.toUtf8();
+    names.append(rootUtf8);
+
+    ScanIndex::Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.dirCount = quint32(m_dirs.size());
+    header.targetCount = quint32(m_targets.size());
+    header.rootPathOffset = rootOffset;
+    header.rootPathLength = quint32(rootUtf8.size());
+    header.scanTimeMs = scanTimeMs;
+    header.dirsOffset = align8(sizeof(ScanIndex::Header));
+    header.targetsOffset = align8(header.dirsOffset + m_dirs.size() * sizeof(ScanIndex::DirRecord));
+    header.namesOffset = align8(header.targetsOffset + m_targets.size() * sizeof(ScanIndex::TargetRecord));
+    header.namesSize = quint64(names.size());
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    // QSaveFile keeps the previous index intact until the new one is complete
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write scan index:" << fileName << file.errorString();
+        return false;
+    }
+
+    auto pad = [&file](quint64 offset) {
+        qint64 gap = qint64(offset) - file.pos();
+        if (gap > 0) file.write(QByteArray(gap, '\0'));
+    };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    pad(header.dirsOffset);
+    file.write(reinterpret_cast<const char *>(m_dirs.constData()),
+               m_dirs.size() * sizeof(ScanIndex::DirRecord));
+    pad(header.targetsOffset);
+    file.write(reinterpret_cast<const char *>(m_targets.constData()),
+               m_targets.size() * sizeof(ScanIndex::TargetRecord));
+    pad(header.namesOffset);
+    file.write(names);
+
+    return file.commit();
+}
+
+void ScanIndexWriter::appendString(const QString &str, quint32 &offset, quint32 &length)
+{
+    QByteArray utf8 = str.toUtf8();
+    offset = quint32(m_names.size());
+    length = quint32(utf8.size());
+    m_names.append(utf8);
+}
@@ -0,0 +1,523 @@
+#include "ScanSnapshot.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <vector>
+
+namespace {
+constexpr char kMagic[8] = {'A', 'C', 'S', 'N', 'A', 'P', 'S', 'H'};
+constexpr quint32 kVersion = 1;
+constexpr int kBufferSize = 64 * 1024;
+constexpr quint64 kFnvOffset = 0xcbf29ce484222325ull;
+constexpr quint64 kFnvPrime = 0x100000001b3ull;
+
+void appendVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+// Buffered sequential reader over one section of a snapshot file
+class SectionReader
+{
+public:
+    bool open(const QString &fileName, qint64 offset, qint64 length)
+    {
+        m_file.setFileName(fileName);
+        if (!m_file.open(QIODevice::ReadOnly) || !m_file.seek(offset)) return false;
+        m_remaining = length;
+        return true;
+    }
+
+    bool atEnd() const { return m_pos >= m_buffer.size() && m_remaining <= 0; }
+
+    bool readVarint(quint64 &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            char byte;
+            if (!readByte(byte)) return false;
+            value |= quint64(uchar(byte) & 0x7F) << shift;
+            if (!(uchar(byte) & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool readBytes(char *out, qint64 length)
+    {
+        while (length > 0) {
+            if (m_pos >= m_buffer.size() && !refill()) return false;
+            const qint64 chunk = qMin<qint64>(length, m_buffer.size() - m_pos);
+            std::memcpy(out, m_buffer.constData() + m_pos, size_t(chunk));
+            m_pos += int(chunk);
+            out += chunk;
+            length -= chunk;
+        }
+        return true;
+    }
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    int m_pos = 0;
+    qint64 m_remaining = 0;
+
+    bool readByte(char &byte)
+    {
+        if (m_pos >= m_buffer.size() && !refill()) return false;
+        byte = m_buffer.at(m_pos++);
+        return true;
+    }
+
+    bool refill()
+    {
+        if (m_remaining <= 0) return false;
+        m_buffer = m_file.read(qMin<qint64>(kBufferSize, m_remaining));
+        m_remaining -= m_buffer.size();
+        m_pos = 0;
+        return !m_buffer.isEmpty();
+    }
+};
+
+// Front-coded relative paths, decoded one at a time
+class PathReader
+{
+public:
+    bool open(const QString &fileName, qint64 offset, qint64 length)
+    {
+        return m_reader.open(fileName, offset, length);
+    }
+
+    bool next(QByteArray &path)
+    {
+        if (m_reader.atEnd()) return false;
+        quint64 shared, suffix;
+        if (!m_reader.readVarint(shared) || !m_reader.readVarint(suffix)) return false;
+        if (shared > quint64(m_path.size())) return false;
+        m_path.truncate(qsizetype(shared));
+        const qsizetype start = m_path.size();
+        m_path.resize(start + qsizetype(suffix));
+        if (!m_reader.readBytes(m_path.data() + start, qint64(suffix))) return false;
+        path = m_path;
+        return true;
+    }
+
+private:
+    SectionReader m_reader;
+    QByteArray m_path;
+};
+
+// Delta-coded (hash, size) pairs in hash order
+class SizeReader
+{
+public:
+    bool open(const QString &fileName, qint64 offset, qint64 length)
+    {
+        return m_reader.open(fileName, offset, length);
+    }
+
+    bool next()
+    {
+        quint64 delta;
+        if (m_reader.atEnd() || !m_reader.readVarint(delta) || !m_reader.readVarint(bytes)) {
+            done = true;
+            return false;
+        }
+        hash += delta;
+        return true;
+    }
+
+    quint64 hash = 0;
+    quint64 bytes = 0;
+    bool done = false;
+
+private:
+    SectionReader m_reader;
+};
+
+QString absolutePath(const QString &rootPath, const QByteArray &relativePath)
+{
+    if (relativePath.isEmpty()) return rootPath;
+    const QString prefix = rootPath.endsWith('/') ? rootPath : rootPath + '/';
+    return prefix + QString::fromUtf8(relativePath);
+}
+}
+
+struct ScanSnapshot::Header {
+    char magic[8];
+    quint32 version;
+    quint32 dirCount;
+    qint64 scanTimeMs;
+    quint64 totalBytes;
+    quint64 sizeSectionBytes;
+    quint64 pathSectionBytes;
+    quint32 rootPathLength;
+    quint32 reserved;
+};
+
+namespace {
+struct OpenSnapshot {
+    ScanSnapshot::Header header;
+    QString rootPath;
+    qint64 sizeOffset = 0;
+    qint64 pathOffset = 0;
+};
+
+bool readHeader(const QString &fileName, OpenSnapshot &snapshot)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    ScanSnapshot::Header &h = snapshot.header;
+    if (file.read(reinterpret_cast<char *>(&h), sizeof(h)) != qint64(sizeof(h))) return false;
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) return false;
+
+    snapshot.rootPath = QString::fromUtf8(file.read(h.rootPathLength));
+    snapshot.sizeOffset = qint64(sizeof(h)) + h.rootPathLength;
+    snapshot.pathOffset = snapshot.sizeOffset + qint64(h.sizeSectionBytes);
+    return snapshot.pathOffset + qint64(h.pathSectionBytes) <= file.size();
+}
+
+// Keeps the count largest changes by magnitude in one direction
+class TopChanges
+{
+public:
+    struct Item {
+        quint64 magnitude;
+        quint64 hash;
+        quint64 oldSize;
+        quint64 newSize;
+        bool operator>(const Item &other) const { return magnitude > other.magnitude; }
+    };
+
+    explicit TopChanges(int count) : m_count(size_t(qMax(0, count))) {}
+
+    void offer(quint64 magnitude, quint64 hash, quint64 oldSize, quint64 newSize)
+    {
+        if (m_count == 0) return;
+        if (m_heap.size() < m_count) {
+            m_heap.push({magnitude, hash, oldSize, newSize});
+        } else if (magnitude > m_heap.top().magnitude) {
+            m_heap.pop();
+            m_heap.push({magnitude, hash, oldSize, newSize});
+        }
+    }
+
+    // Largest first
+    std::vector<Item> take()
+    {
+        std::vector<Item> items;
+        items.reserve(m_heap.size());
+        while (!m_heap.empty()) {
+            items.push_back(m_heap.top());
+            m_heap.pop();
+        }
+        std::reverse(items.begin(), items.end());
+        return items;
+    }
+
+private:
+    size_t m_count;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> m_heap;
+};
+}
+
+quint64 ScanSnapshot::hashPath(const QByteArray &relativePath)
+{
+    quint64 hash = kFnvOffset;
+    for (char c : relativePath) {
+        hash ^= uchar(c);
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+QString ScanSnapshot::snapshotDirFor(const QString &rootPath)
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QByteArray key = QCryptographicHash::hash(QDir::cleanPath(rootPath).toUtf8(),
+                                              QCryptographicHash::Sha1).toHex().left(16);
+    return dataDir + "/snapshots/" + QString::fromLatin1(key);
+}
+
+QString ScanSnapshot::newSnapshotPathFor(const QString &rootPath, qint64 scanTimeMs)
+{
+    return snapshotDirFor(rootPath) + "/"
+           + QDateTime::fromMSecsSinceEpoch(scanTimeMs).toString("yyyyMMdd-HHmmss") + ".acsnap";
+}
+
+QList<ScanSnapshot::Info> ScanSnapshot::list(const QString &rootPath)
+{
+    QList<Info> snapshots;
+    QDir dir(snapshotDirFor(rootPath));
+    const QStringList files = dir.entryList({"*.acsnap"}, QDir::Files);
+    for (const QString &file : files) {
+        Info info;
+        if (readInfo(dir.filePath(file), info)) snapshots.append(info);
+    }
+    std::sort(snapshots.begin(), snapshots.end(), [](const Info &a, const Info &b) {
+        return a.scanTimeMs > b.scanTimeMs;
+    });
+    return snapshots;
+}
+
+void ScanSnapshot::prune(const QString &rootPath, int keepRecent, int keepDays)
+{
+    const QList<Info> snapshots = list(rootPath);
+    QDate lastDay;
+    int days = 0;
+    for (int i = 0; i < snapshots.size(); ++i) {
+        const QDate day = QDateTime::fromMSecsSinceEpoch(snapshots.at(i).scanTimeMs).date();
+        const bool firstOfDay = day != lastDay;
+        if (firstOfDay) {
+            lastDay = day;
+            ++days;
+        }
+        if (i < keepRecent || (firstOfDay && days <= keepDays)) continue;
+        QFile::remove(snapshots.at(i).fileName);
+    }
+}
+
+bool ScanSnapshot::readInfo(const QString &fileName, Info &info)
+{
+    OpenSnapshot snapshot;
+    if (!readHeader(fileName, snapshot)) return false;
+
+    info.fileName = fileName;
+    info.rootPath = snapshot.rootPath;
+    info.scanTimeMs = snapshot.header.scanTimeMs;
+    info.dirCount = snapshot.header.dirCount;
+    info.totalBytes = snapshot.header.totalBytes;
+    return true;
+}
+
+SnapshotDiff ScanSnapshot::diff(const QString &olderFile, const QString &newerFile, int topCount)
+{
+    SnapshotDiff result;
+
+    OpenSnapshot older, newer;
+    if (!readHeader(olderFile, older) || !readHeader(newerFile, newer)) {
+        result.error = "Cannot read snapshot";
+        return result;
+    }
+    if (QDir::cleanPath(older.rootPath) != QDir::cleanPath(newer.rootPath)) {
+        result.error = "Snapshots are of different directories";
+        return result;
+    }
+
+    result.rootPath = newer.rootPath;
+    result.oldScanTimeMs = older.header.scanTimeMs;
+    result.newScanTimeMs = newer.header.scanTimeMs;
+    result.oldTotal = older.header.totalBytes;
+    result.newTotal = newer.header.totalBytes;
+    result.oldDirCount = older.header.dirCount;
+    result.newDirCount = newer.header.dirCount;
+
+    SizeReader a, b;
+    if (!a.open(olderFile, older.sizeOffset, qint64(older.header.sizeSectionBytes))
+        || !b.open(newerFile, newer.sizeOffset, qint64(newer.header.sizeSectionBytes))) {
+        result.error = "Cannot read snapshot";
+        return result;
+    }
+
+    // Merge join on hash: a directory missing on one side counts as 0 bytes
+    TopChanges growers(topCount);
+    TopChanges shrinkers(topCount);
+    auto consider = [&](quint64 hash, quint64 oldSize, quint64 newSize) {
+        if (newSize > oldSize) {
+            growers.offer(newSize - oldSize, hash, oldSize, newSize);
+        } else if (oldSize > newSize) {
+            shrinkers.offer(oldSize - newSize, hash, oldSize, newSize);
+        }
+    };
+
+    a.next();
+    b.next();
+    while (!a.done || !b.done) {
+        if (b.done || (!a.done && a.hash < b.hash)) {
+            consider(a.hash, a.bytes, 0);
+            a.next();
+        } else if (a.done || b.hash < a.hash) {
+            consider(b.hash, 0, b.bytes);
+            b.next();
+        } else {
+            consider(a.hash, a.bytes, b.bytes);
+            a.next();
+            b.next();
+        }
+    }
+
+    const std::vector<TopChanges::Item> grown = growers.take();
+    const std::vector<TopChanges::Item> shrunk = shrinkers.take();
+
+    // Name only the winners: one more pass over each path section
+    QHash<quint64, QString> names;
+    for (const auto &item : grown) names.insert(item.hash, QString());
+    for (const auto &item : shrunk) names.insert(item.hash, QString());
+
+    int unresolved = names.size();
+    for (const auto *snapshot : {&newer, &older}) {
+        if (unresolved == 0) break;
+        const QString &fileName = snapshot == &newer ? newerFile : olderFile;
+        PathReader paths;
+        if (!paths.open(fileName, snapshot->pathOffset, qint64(snapshot->header.pathSectionBytes))) continue;
+
+        QByteArray path;
+        while (unresolved > 0 && paths.next(path)) {
+            auto it = names.find(hashPath(path));
+            if (it != names.end() && it->isEmpty()) {
+                *it = absolutePath(snapshot->rootPath, path);
+                --unresolved;
+            }
+        }
+    }
+
+    auto toChanges = [&names](const std::vector<TopChanges::Item> &items) {
+        QList<SnapshotChange> changes;
+        changes.reserve(qsizetype(items.size()));
+        for (const auto &item : items) {
+            SnapshotChange change;
+            change.path = names.value(item.hash);
+            change.oldSize = qint64(item.oldSize);
+            change.newSize = qint64(item.newSize);
+            changes.append(change);
+        }
+        return changes;
+    };
+    result.growers = toChanges(grown);
+    result.shrinkers = toChanges(shrunk);
+    result.ok = true;
+    return result;
+}
+
+// ============ ScanSnapshotWriter Implementation ============
+
+ScanSnapshotWriter::~ScanSnapshotWriter()
+{
+    abort();
+}
+
+bool ScanSnapshotWriter::begin(const QString &fileName, const QString &rootPath)
+{
+    abort();
+
+    m_fileName = fileName;
+    m_rootPath = QDir::cleanPath(rootPath);
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    m_pathFile.setFileName(fileName + ".paths");
+    if (!m_pathFile.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        qWarning() << "Cannot write snapshot:" << m_pathFile.errorString();
+        return false;
+    }
+    return true;
+}
+
+void ScanSnapshotWriter::addDirectory(const QString &path, quint64 subtreeBytes)
+{
+    if (!isOpen()) return;
+
+    QByteArray relative;
+    const QString clean = QDir::cleanPath(path);
+    if (clean.size() > m_rootPath.size()) {
+        const int skip = m_rootPath.endsWith('/') ? m_rootPath.size() : m_rootPath.size() + 1;
+        relative = clean.mid(skip).toUtf8();
+    } else {
+        m_totalBytes = subtreeBytes;
+    }
+
+    m_records.append({ScanSnapshot::hashPath(relative), subtreeBytes});
+
+    // Front coding against the previous path
+    qsizetype shared = 0;
+    const qsizetype limit = qMin(relative.size(), m_previousPath.size());
+    while (shared < limit && relative.at(shared) == m_previousPath.at(shared)) ++shared;
+    appendVarint(m_pathBuffer, quint64(shared));
+    appendVarint(m_pathBuffer, quint64(relative.size() - shared));
+    m_pathBuffer.append(relative.constData() + shared, relative.size() - shared);
+    m_previousPath = relative;
+
+    if (m_pathBuffer.size() >= kBufferSize) flushPaths();
+}
+
+void ScanSnapshotWriter::flushPaths()
+{
+    m_pathFile.write(m_pathBuffer);
+    m_pathBuffer.clear();
+}
+
+bool ScanSnapshotWriter::finish(qint64 scanTimeMs)
+{
+    if (!isOpen()) return false;
+    flushPaths();
+
+    std::sort(m_records.begin(), m_records.end(), [](const Record &a, const Record &b) {
+        return a.hash < b.hash;
+    });
+
+    QByteArray sizes;
+    sizes.reserve(m_records.size() * 4);
+    quint64 previous = 0;
+    for (const Record &record : std::as_const(m_records)) {
+        appendVarint(sizes, record.hash - previous);
+        appendVarint(sizes, record.bytes);
+        previous = record.hash;
+    }
+
+    const QByteArray root = m_rootPath.toUtf8();
+    ScanSnapshot::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.dirCount = quint32(m_records.size());
+    header.scanTimeMs = scanTimeMs;
+    header.totalBytes = m_totalBytes;
+    header.sizeSectionBytes = quint64(sizes.size());
+    header.pathSectionBytes = quint64(m_pathFile.size());
+    header.rootPathLength = quint32(root.size());
+
+    QSaveFile out(m_fileName);
+    bool ok = out.open(QIODevice::WriteOnly);
+    if (ok) {
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(root);
+        out.write(sizes);
+        m_pathFile.seek(0);
+        while (ok && !m_pathFile.atEnd()) {
+            const QByteArray chunk = m_pathFile.read(kBufferSize);
+            ok = out.write(chunk) == chunk.size();
+        }
+        ok = ok && out.commit();
+    }
+    if (!ok) qWarning() << "Cannot write snapshot" << m_fileName << ":" << out.errorString();
+
+    qDebug() << "Snapshot:" << m_records.size() << "directories in"
+             << (sizeof(header) + root.size() + sizes.size() + header.pathSectionBytes) << "bytes";
+
+    abort();
+    return ok;
+}
+
+void ScanSnapshotWriter::abort()
+{
+    if (m_pathFile.isOpen()) {
+        m_pathFile.close();
+        m_pathFile.remove();
+    }
+    m_records.clear();
+    m_records.squeeze();
+    m_pathBuffer.clear();
+    m_previousPath.clear();
+    m_totalBytes = 0;
+}
@@ -0,0 +1,174 @@
+#include "ScanThrottle.h"
+#include <QDebug>
+#include <QFile>
+#include <QThread>
+
+#ifdef Q_OS_LINUX
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr int kDefaultOpsPerSecond = 2000;
+// Up to a quarter second of operations may be spent in one burst
+constexpr double kBurstSeconds = 0.25;
+constexpr qint64 kPressureCheckIntervalMs = 1000;
+constexpr int kPressurePollMs = 250;
+// A pause ends after this even under sustained pressure; the next check a
+// second later may pause again, so the scan still trickles forward
+constexpr qint64 kMaxPressureWaitMs = 30000;
+// Percent of the last 10 s in which some task stalled on I/O
+constexpr double kPressureHigh = 10.0;
+constexpr double kPressureLow = 3.0;
+
+#ifdef Q_OS_LINUX
+// From linux/ioprio.h, which is not installed everywhere
+constexpr int kIoprioWhoProcess = 1;
+constexpr int kIoprioClassShift = 13;
+constexpr int kIoprioClassIdle = 3;
+#endif
+}
+
+ScanThrottle::ScanThrottle()
+    : m_opsPerSecond(kDefaultOpsPerSecond)
+{
+}
+
+void ScanThrottle::setOpsPerSecond(int ops)
+{
+    m_opsPerSecond = qMax(1, ops);
+}
+
+void ScanThrottle::start()
+{
+    if (m_active) return;
+    m_active = true;
+
+#ifdef Q_OS_LINUX
+    // A who of 0 means the calling thread for both calls
+    // Only what was actually changed is restored by stop()
+    m_savedIoPriority = int(::syscall(SYS_ioprio_get, kIoprioWhoProcess, 0));
+    if (::syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, kIoprioClassIdle << kIoprioClassShift) != 0) {
+        qWarning() << "Could not set idle I/O priority:" << qt_error_string(errno);
+        m_savedIoPriority = -1;
+    }
+
+    m_savedPolicy = ::sched_getscheduler(0);
+    struct sched_param param;
+    m_savedSchedPriority = ::sched_getparam(0, &param) == 0 ? param.sched_priority : 0;
+    param.sched_priority = 0;
+    if (m_savedPolicy == SCHED_IDLE) {
+        m_savedPolicy = -1;
+    } else if (::sched_setscheduler(0, SCHED_IDLE, &param) != 0) {
+        qWarning() << "Could not set SCHED_IDLE:" << qt_error_string(errno);
+        m_savedPolicy = -1;
+    }
+#endif
+
+    m_clock.start();
+    m_lastRefillNs = 0;
+    m_lastPressureCheckMs = 0;
+    m_tokens = m_opsPerSecond * kBurstSeconds;
+}
+
+void ScanThrottle::stop()
+{
+    if (!m_active) return;
+    m_active = false;
+
+#ifdef Q_OS_LINUX
+    if (m_savedIoPriority >= 0
+        && ::syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, m_savedIoPriority) != 0) {
+        qWarning() << "Could not restore I/O priority:" << qt_error_string(errno);
+    }
+    // Leaving SCHED_IDLE needs CAP_SYS_NICE or a fitting RLIMIT_NICE, so an
+    // unprivileged thread usually stays idle for the rest of its life
+    if (m_savedPolicy >= 0) {
+        struct sched_param param;
+        param.sched_priority = m_savedSchedPriority;
+        if (::sched_setscheduler(0, m_savedPolicy, &param) != 0) {
+            qWarning() << "Could not leave SCHED_IDLE:" << qt_error_string(errno);
+        }
+    }
+    m_savedIoPriority = -1;
+    m_savedPolicy = -1;
+#endif
+}
+
+void ScanThrottle::consume(int ops)
+{
+    if (!m_active) return;
+
+    const qint64 nowMs = m_clock.elapsed();
+    if (nowMs - m_lastPressureCheckMs >= kPressureCheckIntervalMs) {
+        m_lastPressureCheckMs = nowMs;
+        if (ioPressure() >= kPressureHigh) waitForLowPressure();
+    }
+
+    // Refill, then let the balance go negative and sleep off the debt;
+    // one call can cover a whole directory listing
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    const double burst = m_opsPerSecond * kBurstSeconds;
+    m_tokens = qMin(burst, m_tokens + (nowNs - m_lastRefillNs) * 1e-9 * m_opsPerSecond);
+    m_lastRefillNs = nowNs;
+    m_tokens -= ops;
+
+    if (m_tokens < 0) {
+        qint64 waitMs = qint64(-m_tokens * 1000.0 / m_opsPerSecond);
+        while (waitMs > 0 && !isCancelled()) {
+            const qint64 slice = qMin<qint64>(waitMs, 100);
+            QThread::msleep(slice);
+            waitMs -= slice;
+        }
+    }
+}
+
+void ScanThrottle::waitForLowPressure()
+{
+    qDebug() << "I/O pressure high, pausing scan";
+    if (m_pauseHandler) m_pauseHandler(true);
+
+    const qint64 startMs = m_clock.elapsed();
+    bool timedOut = false;
+    while (!isCancelled()) {
+        QThread::msleep(kPressurePollMs);
+        const double pressure = ioPressure();
+        if (pressure < kPressureLow) break;
+        if (m_clock.elapsed() - startMs >= kMaxPressureWaitMs) {
+            timedOut = true;
+            break;
+        }
+    }
+
+    if (timedOut) {
+        qWarning() << "I/O pressure still high after" << kMaxPressureWaitMs / 1000 << "s, resuming scan";
+    } else {
+        qDebug() << "I/O pressure back to normal, resuming scan";
+    }
+    if (m_pauseHandler) m_pauseHandler(false);
+
+    // The pause itself must not turn into a burst afterwards
+    m_lastRefillNs = m_clock.nsecsElapsed();
+    m_tokens = 0;
+}
+
+double ScanThrottle::ioPressure()
+{
+#ifdef Q_OS_LINUX
+    // some avg10=1.23 avg60=0.45 avg300=0.12 total=123456
+    QFile file("/proc/pressure/io");
+    if (!file.open(QIODevice::ReadOnly)) return -1.0;
+
+    const QByteArray line = file.readLine();
+    if (!line.startsWith("some ")) return -1.0;
+    const int start = line.indexOf("avg10=");
+    if (start < 0) return -1.0;
+    const int end = line.indexOf(' ', start);
+    bool ok = false;
+    const double value = line.mid(start + 6, end - start - 6).toDouble(&ok);
+    return ok ? value : -1.0;
+#else
+    return -1.0;
+#endif
+}
@@ -0,0 +1,175 @@
+#include "ServerListModel.h"
+#include "ProcStats.h"
+
+ServerListModel::ServerListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int ServerListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return m_servers.size();
+}
+
+QVariant ServerListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_servers.size()) {
+        return QVariant();
+    }
+
+    const ServerInfo &server = m_servers.at(index.row());
+    switch (role) {
+    case IdRole:
+        return server.id;
+    case Qt::DisplayRole:
+    case NameRole:
+        return server.name;
+    case HostRole:
+        return server.host;
+    case PortRole:
+        return server.port;
+    case UsernameRole:
+        return server.username;
+    case TagsRole:
+        return server.tags.join(", ");
+    case PollIntervalRole:
+        return server.pollInterval;
+    case ConnectedRole:
+        return server.connected;
+    case CpuUsageRole:
+        return server.cpuUsage;
+    case RamUsageRole:
+        return server.ramUsage;
+    case DiskUsageRole:
+        return server.diskUsage;
+    case NetworkUpRole:
+        return ProcStats::formatRate(server.networkUp);
+    case NetworkDownRole:
+        return ProcStats::formatRate(server.networkDown);
+    case DiskReadRole:
+        return ProcStats::formatRate(server.diskRead);
+    case DiskWriteRole:
+        return ProcStats::formatRate(server.diskWrite);
+    case LastErrorRole:
+        return server.lastError;
+    case HistoryRevisionRole:
+        return m_histories[index.row()]->revision();
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> ServerListModel::roleNames() const
+{
+    return {
+        {IdRole, "serverId"},
+        {NameRole, "name"},
+        {HostRole, "host"},
+        {PortRole, "port"},
+        {UsernameRole, "username"},
+        {TagsRole, "tags"},
+        {PollIntervalRole, "pollInterval"},
+        {ConnectedRole, "connected"},
+        {CpuUsageRole, "cpuUsage"},
+        {RamUsageRole, "ramUsage"},
+        {DiskUsageRole, "diskUsage"},
+        {NetworkUpRole, "networkUp"},
+        {NetworkDownRole, "networkDown"},
+        {DiskReadRole, "diskRead"},
+        {DiskWriteRole, "diskWrite"},
+        {LastErrorRole, "lastError"},
+        {HistoryRevisionRole, "historyRevision"}
+    };
+}
+
+const ServerInfo *ServerListModel::find(const QString &id) const
+{
+    const auto it = m_rows.constFind(id);
+    return it == m_rows.constEnd() ? nullptr : &m_servers.at(it.value());
+}
+
+void ServerListModel::append(const ServerInfo &server)
+{
+    if (m_rows.contains(server.id)) return;
+
+    const int row = m_servers.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_servers.append(server);
+    m_histories.push_back(std::make_unique<MetricHistory>());
+    m_rows.insert(server.id, row);
+    endInsertRows();
+    emit countChanged();
+}
+
+void ServerListModel::remove(const QString &id)
+{
+    const auto it = m_rows.constFind(id);
+    if (it == m_rows.constEnd()) return;
+
+    const int row = it.value();
+    beginRemoveRows(QModelIndex(), row, row);
+    m_servers.removeAt(row);
+    m_histories.erase(m_histories.begin() + row);
+    m_rows.remove(id);
+    for (int i = row; i < m_servers.size(); ++i) {
+        m_rows[m_servers.at(i).id] = i;
+    }
+    endRemoveRows();
+    emit countChanged();
+}
+
+void ServerListModel::update(const ServerInfo &server)
+{
+    const auto it = m_rows.constFind(server.id);
+    if (it == m_rows.constEnd()) return;
+
+    const int row = it.value();
+    ServerInfo &current = m_servers[row];
+
+    QList<int> roles;
+    auto assign = [&roles](auto &field, const auto &value, int role) {
+        if (field == value) return;
+        field = value;
+        roles.append(role);
+    };
+    assign(current.name, server.name, NameRole);
+    assign(current.host, server.host, HostRole);
+    assign(current.port, server.port, PortRole);
+    assign(current.username, server.username, UsernameRole);
+    assign(current.tags, server.tags, TagsRole);
+    assign(current.pollInterval, server.pollInterval, PollIntervalRole);
+    assign(current.connected, server.connected, ConnectedRole);
+    assign(current.cpuUsage, server.cpuUsage, CpuUsageRole);
+    assign(current.ramUsage, server.ramUsage, RamUsageRole);
+    assign(current.diskUsage, server.diskUsage, DiskUsageRole);
+    assign(current.networkUp, server.networkUp, NetworkUpRole);
+    assign(current.networkDown, server.networkDown, NetworkDownRole);
+    assign(current.diskRead, server.diskRead, DiskReadRole);
+    assign(current.diskWrite, server.diskWrite, DiskWriteRole);
+    assign(current.lastError, server.lastError, LastErrorRole);
+    current.password = server.password;
+
+    if (roles.isEmpty()) return;
+    if (roles.contains(NameRole)) roles.append(Qt::DisplayRole);
+
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, roles);
+}
+
+const MetricHistory *ServerListModel::history(const QString &id) const
+{
+    const auto it = m_rows.constFind(id);
+    return it == m_rows.constEnd() ? nullptr : m_histories[it.value()].get();
+}
+
+void ServerListModel::addSample(const QString &id, qint64 timeMs, const double values[MetricHistory::MetricCount])
+{
+    const auto it = m_rows.constFind(id);
+    if (it == m_rows.constEnd()) return;
+
+    const int row = it.value();
+    m_histories[row]->add(timeMs, values);
+
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, {HistoryRevisionRole});
+}
@@ -1,16 +1,141 @@
 #include "ServerManager.h"
+#include "EventLoopPool.h"
+#include "PollScheduler.h"
 #include <QUuid>
 #include <QDebug>
 #include <QSettings>
 #include <QRegularExpression>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QSysInfo>
+
+#ifdef Q_OS_UNIX
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#endif
+
+namespace {
+constexpr int kDefaultPollIntervalMs = 5000;
+constexpr int kDefaultMaxConcurrentConnects = 32;
+constexpr int kConnectTimeoutMs = 15000;
+constexpr int kStatsTimeoutMs = 15000;
+// Streams that end this many times without a sample fall back to polling
+constexpr int kMaxStreamFailures = 3;
+constexpr int kMaxFrameLines = 512;
+
+// Sampled every tick; statfs of / (a process on the host) only every
+// twelfth sample in streaming mode
+constexpr int kStatFsEvery = 12;
+
+// ac-agent is cached per build under the login directory of the host
+const char kAgentCacheDir[] = ".cache/ac-agent";
+constexpr int kAgentUploadTimeoutMs = 60000;
+
+// The ac-agent binary installed next to the application, read and hashed
+// once for all workers
+struct LocalAgent {
+    QByteArray binary;
+    QString sha256;
+    QStringList machines; // uname -m of the hosts it runs on
+};
+
+const LocalAgent &localAgent()
+{
+    static const LocalAgent agent = []() {
+        LocalAgent local;
+        QFile file(QCoreApplication::applicationDirPath() + "/ac-agent");
+        if (!file.open(QIODevice::ReadOnly)) return local;
+
+        local.binary = file.readAll();
+        local.sha256 = QCryptographicHash::hash(local.binary, QCryptographicHash::Sha256).toHex();
+
+        const QString arch = QSysInfo::buildCpuArchitecture();
+        if (arch == "x86_64") {
+            local.machines << "x86_64" << "amd64";
+        } else if (arch == "arm64") {
+            local.machines << "aarch64" << "arm64";
+        } else if (arch == "i386") {
+            local.machines << "i386" << "i486" << "i586" << "i686";
+        } else if (arch == "arm") {
+            local.machines << "armv7l" << "armv6l";
+        } else {
+            local.machines << arch;
+        }
+        return local;
+    }();
+    return agent;
+}
+
+// Names and addresses of this machine, lowercase, looked up once for all
+// workers instead of running hostname on every connect
+const QSet<QString> &localIdentities()
+{
+    static const QSet<QString> identities = []() {
+        QSet<QString> local = {"localhost", "127.0.0.1", "::1", "0.0.0.0"};
+        local.insert(QSysInfo::machineHostName().toLower());
+#ifdef Q_OS_UNIX
+        ifaddrs *interfaces = nullptr;
+        if (::getifaddrs(&interfaces) == 0) {
+            for (ifaddrs *it = interfaces; it; it = it->ifa_next) {
+                if (!it->ifa_addr) continue;
+
+                const int family = it->ifa_addr->sa_family;
+                const void *address = nullptr;
+                if (family == AF_INET) {
+                    address = &reinterpret_cast<const sockaddr_in *>(it->ifa_addr)->sin_addr;
+                } else if (family == AF_INET6) {
+                    address = &reinterpret_cast<const sockaddr_in6 *>(it->ifa_addr)->sin6_addr;
+                }
+                char text[INET6_ADDRSTRLEN];
+                if (address && ::inet_ntop(family, address, text, sizeof(text))) {
+                    local.insert(QString::fromLatin1(text).toLower());
+                }
+            }
+            ::freeifaddrs(interfaces);
+        }
+#endif
+        return local;
+    }();
+    return identities;
+}
+}
 
 ServerManager::ServerManager(QObject *parent)
     : QObject(parent)
 {
+    m_loops = new EventLoopPool(0, this);
+    m_model = new ServerListModel(this);
+    m_fleet = new FleetSummaryModel(this);
     loadServers();
+
+    QSettings settings("AlisaCorp", "SystemMonitor");
+    m_streamingMode = settings.value("streamingMode", true).toBool();
+    m_agentMode = settings.value("agentMode", false).toBool();
+    m_connectOnStartup = settings.value("connectOnStartup", false).toBool();
+    m_maxConcurrentConnects = qMax(1, settings.value("maxConcurrentConnects", kDefaultMaxConcurrentConnects).toInt());
+    const QVariantMap groupIntervals = settings.value("groupIntervals").toMap();
+    for (auto it = groupIntervals.constBegin(); it != groupIntervals.constEnd(); ++it) {
+        m_groupIntervals.insert(it.key(), it.value().toInt());
+    }
     
-    // Note: Each RemoteWorker has its own timer for stats updates
-    // No need for a global refresh timer
+    // One scheduler polls every connected server
+    m_scheduler = new PollScheduler(this);
+    m_scheduler->setMaxInFlight(settings.value("maxConcurrentPolls", m_scheduler->maxInFlight()).toInt());
+    connect(m_scheduler, &PollScheduler::pollDue, this, [this](const QString &id) {
+        if (RemoteWorker *worker = m_workers.value(id)) {
+            QMetaObject::invokeMethod(worker, "fetchStats", Qt::QueuedConnection);
+        } else {
+            m_scheduler->pollFinished(id, false);
+        }
+    });
+
+    // Once the event loop runs, so the window comes up first
+    if (m_connectOnStartup) {
+        QTimer::singleShot(0, this, &ServerManager::connectAll);
+    }
 }
 
 ServerManager::~ServerManager()
@@ -28,7 +153,8 @@ ServerManager::~ServerManager()
 }
 
 void ServerManager::addServer(const QString &name, const QString &host, int port,
-                              const QString &username, const QString &password, bool autoConnect)
+                              const QString &username, const QString &password, const QString &tags,
+                              int pollInterval, bool autoConnect)
 {
     ServerInfo server;
     server.id = generateId();
@@ -37,19 +163,11 @@ void ServerManager::addServer(const QString &name, const QString &host, int port
     server.port = port;
     server.username = username;
     server.password = password;
-    server.connected = false;
-    server.cpuUsage = 0.0;
-    server.ramUsage = 0.0;
-    server.diskUsage = 0.0;
-    server.networkUp = "0 KB/s";
-    server.networkDown = "0 KB/s";
-    server.lastError = "";
-
-    m_serverMap[server.id] = server;
-    m_servers.append(serverToVariant(server));
+    server.tags = parseTags(tags);
+    server.pollInterval = qMax(0, pollInterval);
 
+    m_model->append(server);
     saveServers();
-    emit serversChanged();
 
     // Auto-connect only if requested
     if (autoConnect) {
@@ -58,31 +176,31 @@ void ServerManager::addServer(const QString &name, const QString &host, int port
 }
 
 void ServerManager::updateServer(const QString &id, const QString &name, const QString &host, int port,
-                                 const QString &username, const QString &password)
+                                 const QString &username, const QString &password, const QString &tags,
+                                 int pollInterval)
 {
-    if (!m_serverMap.contains(id)) return;
+    if (!m_model->find(id)) return;
     
     // Disconnect if currently connected
-    bool wasConnected = m_serverMap[id].connected;
+    bool wasConnected = m_model->find(id)->connected;
     if (wasConnected) {
         disconnectFromServer(id);
     }
     
     // Update server info
-    m_serverMap[id].name = name;
-    m_serverMap[id].host = host;
-    m_serverMap[id].port = port;
-    m_serverMap[id].username = username;
-    m_serverMap[id].password = password;
-    
-    // Rebuild variant list
-    m_servers.clear();
-    for (const ServerInfo &server : m_serverMap) {
-        m_servers.append(serverToVariant(server));
+    ServerInfo server = *m_model->find(id);
+    server.name = name;
+    server.host = host;
+    server.port = port;
+    server.username = username;
+    if (!password.isEmpty()) {
+        server.password = password;
     }
+    server.tags = parseTags(tags);
+    server.pollInterval = qMax(0, pollInterval);
+    m_model->update(server);
     
     saveServers();
-    emit serversChanged();
     
     // Reconnect if it was connected before
     if (wasConnected) {
@@ -92,57 +210,57 @@ void ServerManager::updateServer(const QString &id, const QString &name, const Q
 
 void ServerManager::removeServer(const QString &id)
 {
-    if (!m_serverMap.contains(id)) return;
+    if (!m_model->find(id)) return;
     
     disconnectFromServer(id);
-    m_serverMap.remove(id);
-    
-    // Rebuild variant list
-    m_servers.clear();
-    for (const ServerInfo &server : m_serverMap) {
-        m_servers.append(serverToVariant(server));
-    }
+    m_model->remove(id);
     
     saveServers();
-    emit serversChanged();
 }
 
 void ServerManager::connectToServer(const QString &id)
 {
-    if (!m_serverMap.contains(id)) return;
-    
-    ServerInfo &server = m_serverMap[id];
+    const ServerInfo *server = m_model->find(id);
+    if (!server) return;
+    if (m_workers.contains(id)) {
+        // A failed worker stays around with its error until replaced
+        if (server->connected || server->lastError.isEmpty()) return;
+        disconnectFromServer(id);
+        server = m_model->find(id);
+        if (!server) return;
+    }
     
-    // Create worker thread
-    QThread *thread = new QThread(this);
-    RemoteWorker *worker = new RemoteWorker(id, server.host, server.port,
-                                           server.username, server.password);
-    worker->moveToThread(thread);
+    // The worker lives on one of the shared event-loop threads
+    RemoteWorker *worker = new RemoteWorker(id, server->host, server->port,
+                                           server->username, server->password);
+    worker->setStreaming(m_streamingMode);
+    worker->setAgent(m_agentMode);
+    if (m_fakeHosts) {
+        worker->setTransport(RemoteWorker::FakeHost, m_fakeHostOptions);
+    }
+    m_loops->adopt(worker);
     
     // Connect signals
-    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
     connect(worker, &RemoteWorker::statsReady, this, &ServerManager::onRemoteStatsReady);
     connect(worker, &RemoteWorker::error, this, &ServerManager::onConnectionError);
-    connect(worker, &RemoteWorker::connected, this, [this, id]() {
-        if (m_serverMap.contains(id)) {
-            m_serverMap[id].connected = true;
-            m_serverMap[id].lastError = ""; // Clear any previous errors
-
-            // Update variant list
-            m_servers.clear();
-            for (const ServerInfo &srv : m_serverMap) {
-                m_servers.append(serverToVariant(srv));
-            }
+    connect(worker, &RemoteWorker::pollFinished, m_scheduler, &PollScheduler::pollFinished);
+    connect(worker, &RemoteWorker::connected, this, [this, id, worker]() {
+        // Queued from a worker that has since been released
+        if (m_workers.value(id) != worker) return;
+        if (const ServerInfo *current = m_model->find(id)) {
+            ServerInfo server = *current;
+            server.connected = true;
+            server.lastError = ""; // Clear any previous errors
+            m_model->update(server);
+            m_scheduler->addServer(id, pollIntervalMs(server));
 
             emit serverConnected(id);
-            emit serversChanged();
         }
+        connectFinished(id, true);
     });
     
     m_workers[id] = worker;
-    m_threads[id] = thread;
     
-    thread->start();
     QMetaObject::invokeMethod(worker, "connect", Qt::QueuedConnection);
 }
 
@@ -150,31 +268,111 @@ void ServerManager::disconnectFromServer(const QString &id)
 {
     if (!m_workers.contains(id)) return;
 
-    QMetaObject::invokeMethod(m_workers[id], "disconnect", Qt::QueuedConnection);
+    // Runs on the worker's thread before the deferred delete; nothing waits
+    RemoteWorker *worker = m_workers.take(id);
+    QMetaObject::invokeMethod(worker, "disconnect", Qt::QueuedConnection);
+    m_loops->release(worker);
+
+    m_scheduler->removeServer(id);
+    m_fleet->removeServer(id);
+    connectFinished(id, false);
+    if (const ServerInfo *current = m_model->find(id)) {
+        ServerInfo server = *current;
+        server.connected = false;
+        m_model->update(server);
 
-    if (m_threads.contains(id)) {
-        m_threads[id]->quit();
-        m_threads[id]->wait();
-        m_threads[id]->deleteLater();
-        m_threads.remove(id);
+        emit serverDisconnected(id);
     }
+}
 
-    m_workers.remove(id);
+void ServerManager::connectAll()
+{
+    for (const ServerInfo &server : m_model->servers()) {
+        if (server.connected || m_connecting.contains(server.id) || m_connectQueue.contains(server.id)) continue;
+        // A worker without a connection either failed or is still connecting
+        if (m_workers.contains(server.id) && server.lastError.isEmpty()) continue;
+        m_connectQueue.append(server.id);
+    }
+    if (m_connectQueue.isEmpty() || m_connectingAll) {
+        startQueuedConnects();
+        return;
+    }
 
-    if (m_serverMap.contains(id)) {
-        m_serverMap[id].connected = false;
+    qDebug() << "Connecting" << m_connectQueue.size() << "servers," << m_maxConcurrentConnects << "at a time";
+    m_connectingAll = true;
+    m_connectAllFailures = 0;
+    m_connectAllClock.start();
+    emit connectAllChanged();
+    startQueuedConnects();
+}
 
-        // Update variant list
-        m_servers.clear();
-        for (const ServerInfo &srv : m_serverMap) {
-            m_servers.append(serverToVariant(srv));
+void ServerManager::startQueuedConnects()
+{
+    while (m_connecting.size() < m_maxConcurrentConnects && !m_connectQueue.isEmpty()) {
+        const QString id = m_connectQueue.takeFirst();
+        const ServerInfo *server = m_model->find(id);
+        if (!server || server->connected) continue;
+
+        // Failed workers stay around with their error until replaced
+        if (m_workers.contains(id)) {
+            if (server->lastError.isEmpty()) continue;
+            disconnectFromServer(id);
         }
+        m_connecting.insert(id);
+        connectToServer(id);
+    }
 
-        emit serverDisconnected(id);
-        emit serversChanged();
+    if (m_connectingAll && m_connecting.isEmpty() && m_connectQueue.isEmpty()) {
+        m_connectingAll = false;
+        m_connectAllMs = m_connectAllClock.elapsed();
+        qDebug() << "Connect all finished in" << m_connectAllMs << "ms," << m_connectAllFailures << "failed";
+        emit connectAllChanged();
     }
 }
 
+void ServerManager::connectFinished(const QString &id, bool ok)
+{
+    if (!m_connecting.remove(id)) return;
+    if (!ok) ++m_connectAllFailures;
+    startQueuedConnects();
+}
+
+void ServerManager::setFakeHosts(const QStringList &options)
+{
+    m_fakeHosts = true;
+    m_fakeHostOptions = options;
+}
+
+void ServerManager::setConnectOnStartup(bool enabled)
+{
+    if (m_connectOnStartup == enabled) return;
+
+    m_connectOnStartup = enabled;
+    QSettings settings("AlisaCorp", "SystemMonitor");
+    settings.setValue("connectOnStartup", enabled);
+    emit connectOnStartupChanged();
+}
+
+void ServerManager::setStreamingMode(bool enabled)
+{
+    if (m_streamingMode == enabled) return;
+
+    m_streamingMode = enabled;
+    QSettings settings("AlisaCorp", "SystemMonitor");
+    settings.setValue("streamingMode", enabled);
+    emit streamingModeChanged();
+}
+
+void ServerManager::setAgentMode(bool enabled)
+{
+    if (m_agentMode == enabled) return;
+
+    m_agentMode = enabled;
+    QSettings settings("AlisaCorp", "SystemMonitor");
+    settings.setValue("agentMode", enabled);
+    emit agentModeChanged();
+}
+
 void ServerManager::refreshServer(const QString &id)
 {
     if (!m_workers.contains(id)) return;
@@ -191,17 +389,13 @@ void ServerManager::refreshAll()
 void ServerManager::pauseAll()
 {
     qDebug() << "Pausing all remote server stats fetching";
-    for (auto it = m_workers.begin(); it != m_workers.end(); ++it) {
-        QMetaObject::invokeMethod(it.value(), "pauseStats", Qt::QueuedConnection);
-    }
+    m_scheduler->pause();
 }
 
 void ServerManager::resumeAll()
 {
     qDebug() << "Resuming all remote server stats fetching";
-    for (auto it = m_workers.begin(); it != m_workers.end(); ++it) {
-        QMetaObject::invokeMethod(it.value(), "resumeStats", Qt::QueuedConnection);
-    }
+    m_scheduler->resume();
 }
 
 void ServerManager::copyToClipboard(const QString &text)
@@ -216,44 +410,51 @@ void ServerManager::copyToClipboard(const QString &text)
 }
 
 void ServerManager::onRemoteStatsReady(const QString &id, double cpu, double ram, double disk,
-                                      QString netUp, QString netDown)
+                                      double netUp, double netDown, double diskRead, double diskWrite)
 {
-    if (!m_serverMap.contains(id)) return;
+    // Results may still arrive from a worker that was just disconnected
+    const ServerInfo *current = m_model->find(id);
+    if (!current || !m_workers.contains(id)) return;
     
-    ServerInfo &server = m_serverMap[id];
+    // Only the roles that changed reach the view
+    ServerInfo server = *current;
     server.cpuUsage = cpu;
     server.ramUsage = ram;
     server.diskUsage = disk;
     server.networkUp = netUp;
     server.networkDown = netDown;
+    server.diskRead = diskRead;
+    server.diskWrite = diskWrite;
     server.lastError = "";
+    m_model->update(server);
+    m_fleet->setSample(server);
     
-    // Update variant list
-    m_servers.clear();
-    for (const ServerInfo &srv : m_serverMap) {
-        m_servers.append(serverToVariant(srv));
-    }
+    double values[MetricHistory::MetricCount];
+    values[MetricHistory::Cpu] = cpu;
+    values[MetricHistory::Ram] = ram;
+    values[MetricHistory::Disk] = disk;
+    values[MetricHistory::NetUp] = netUp;
+    values[MetricHistory::NetDown] = netDown;
+    m_model->addSample(id, QDateTime::currentMSecsSinceEpoch(), values);
     
     emit serverStatsUpdated(id);
-    emit serversChanged();
 }
 
 void ServerManager::onConnectionError(const QString &id, const QString &error)
 {
-    if (!m_serverMap.contains(id)) return;
+    const ServerInfo *current = m_model->find(id);
+    if (!current || !m_workers.contains(id)) return;
 
     qDebug() << "Connection error for server" << id << ":" << error;
-    m_serverMap[id].lastError = error;
-    m_serverMap[id].connected = false;
-
-    // Update variant list
-    m_servers.clear();
-    for (const ServerInfo &srv : m_serverMap) {
-        m_servers.append(serverToVariant(srv));
-    }
+    ServerInfo server = *current;
+    server.lastError = error;
+    server.connected = false;
+    m_model->update(server);
+    m_scheduler->removeServer(id);
+    m_fleet->removeServer(id);
+    connectFinished(id, false);
 
     emit serverError(id, error);
-    emit serversChanged();
 }
 
 QString ServerManager::generateId() const
@@ -261,23 +462,49 @@ QString ServerManager::generateId() const
     return QUuid::createUuid().toString(QUuid::WithoutBraces);
 }
 
-QVariantMap ServerManager::serverToVariant(const ServerInfo &server) const
+QStringList ServerManager::parseTags(const QString &tags)
 {
-    QVariantMap map;
-    map["id"] = server.id;
-    map["name"] = server.name;
-    map["host"] = server.host;
-    map["port"] = server.port;
-    map["username"] = server.username;
-    map["password"] = server.password;  // Include password for edit functionality
-    map["connected"] = server.connected;
-    map["cpuUsage"] = server.cpuUsage;
-    map["ramUsage"] = server.ramUsage;
-    map["diskUsage"] = server.diskUsage;
-    map["networkUp"] = server.networkUp;
-    map["networkDown"] = server.networkDown;
-    map["lastError"] = server.lastError;
-    return map;
+    QStringList result;
+    for (const QString &tag : tags.split(',', Qt::SkipEmptyParts)) {
+        const QString trimmed = tag.trimmed();
+        if (!trimmed.isEmpty() && !result.contains(trimmed)) result.append(trimmed);
+    }
+    return result;
+}
+
+int ServerManager::pollIntervalMs(const ServerInfo &server) const
+{
+    if (server.pollInterval > 0) return server.pollInterval * 1000;
+
+    int seconds = 0;
+    for (const QString &tag : server.tags) {
+        const int groupSeconds = m_groupIntervals.value(tag, 0);
+        if (groupSeconds > 0 && (seconds == 0 || groupSeconds < seconds)) seconds = groupSeconds;
+    }
+    return seconds > 0 ? seconds * 1000 : kDefaultPollIntervalMs;
+}
+
+void ServerManager::setGroupInterval(const QString &tag, int seconds)
+{
+    if (tag.isEmpty()) return;
+    if (seconds > 0) {
+        m_groupIntervals.insert(tag, seconds);
+    } else {
+        m_groupIntervals.remove(tag);
+    }
+
+    QVariantMap groupIntervals;
+    for (auto it = m_groupIntervals.constBegin(); it != m_groupIntervals.constEnd(); ++it) {
+        groupIntervals.insert(it.key(), it.value());
+    }
+    QSettings settings("AlisaCorp", "SystemMonitor");
+    settings.setValue("groupIntervals", groupIntervals);
+
+    for (const ServerInfo &server : m_model->servers()) {
+        if (server.connected && server.tags.contains(tag)) {
+            m_scheduler->setInterval(server.id, pollIntervalMs(server));
+        }
+    }
 }
 
 void ServerManager::saveServers()
@@ -285,7 +512,7 @@ void ServerManager::saveServers()
     QSettings settings("AlisaCorp", "SystemMonitor");
     settings.beginWriteArray("servers");
     int index = 0;
-    for (const ServerInfo &server : m_serverMap) {
+    for (const ServerInfo &server : m_model->servers()) {
         settings.setArrayIndex(index++);
         settings.setValue("id", server.id);
         settings.setValue("name", server.name);
@@ -293,6 +520,8 @@ void ServerManager::saveServers()
         settings.setValue("port", server.port);
         settings.setValue("username", server.username);
         settings.setValue("password", server.password); // Encrypt in production!
+        settings.setValue("tags", server.tags);
+        settings.setValue("pollInterval", server.pollInterval);
     }
     settings.endArray();
 }
@@ -310,16 +539,10 @@ void ServerManager::loadServers()
         server.port = settings.value("port").toInt();
         server.username = settings.value("username").toString();
         server.password = settings.value("password").toString();
-        server.connected = false;
-        server.cpuUsage = 0.0;
-        server.ramUsage = 0.0;
-        server.diskUsage = 0.0;
-        server.networkUp = "0 KB/s";
-        server.networkDown = "0 KB/s";
-        server.lastError = "";
+        server.tags = settings.value("tags").toStringList();
+        server.pollInterval = settings.value("pollInterval", 0).toInt();
         
-        m_serverMap[server.id] = server;
-        m_servers.append(serverToVariant(server));
+        m_model->append(server);
     }
     settings.endArray();
 }
@@ -335,15 +558,39 @@ RemoteWorker::RemoteWorker(const QString &id, const QString &host, int port,
     , m_port(port)
     , m_username(username)
     , m_password(password)
+    , m_transport(Ssh)
     , m_connected(false)
     , m_prevBytesSent(0)
     , m_prevBytesReceived(0)
-    , m_statsTimer(nullptr)
+    , m_pollPending(false)
+    , m_process(nullptr)
+    , m_streaming(false)
+    , m_stream(nullptr)
+    , m_sampleRequested(false)
+    , m_streamFailures(0)
+    , m_streamDelivered(false)
+    , m_procSampling(true)
+    , m_hasPrevSample(false)
+    , m_agentState(AgentUnavailable)
+    , m_streamIsAgent(false)
+    , m_agentGreeted(false)
 {
-    // Create timer for periodic stats updates
-    m_statsTimer = new QTimer(this);
-    m_statsTimer->setInterval(5000); // 5 seconds
-    QObject::connect(m_statsTimer, &QTimer::timeout, this, &RemoteWorker::fetchStats);
+}
+
+RemoteWorker::~RemoteWorker()
+{
+    // Also reached without disconnect() when the application shuts down
+    abortRemoteCommand();
+    stopStream();
+    if (m_connected) {
+        closeControlMaster();
+    }
+}
+
+void RemoteWorker::setTransport(Transport transport, const QStringList &fakeHostOptions)
+{
+    m_transport = transport;
+    m_fakeHostOptions = fakeHostOptions;
 }
 
 void RemoteWorker::setCredentials(const QString &host, int port, const QString &username, const QString &password)
@@ -359,7 +606,7 @@ void RemoteWorker::connect()
     qDebug() << "RemoteWorker::connect() called for" << m_id << "(" << m_host << ":" << m_port << ")";
     
     // Check if this is localhost - if so, skip remote monitoring
-    if (isLocalhost()) {
+    if (m_transport == Ssh && isLocalhost()) {
         qDebug() << "Skipping remote monitoring for" << m_id << "- detected as localhost";
         emit error(m_id, "Cannot monitor localhost remotely. Use Dashboard instead.");
         return;
@@ -367,77 +614,134 @@ void RemoteWorker::connect()
     
     qDebug() << "Testing SSH connection to" << m_host;
     // Test connection with simple command
-    QString output = executeRemoteCommand("echo 'connected'");
-    qDebug() << "Connection test output:" << output.left(100);
-    
-    if (output.contains("connected")) {
-        qDebug() << "Connection successful for" << m_id;
-        m_connected = true;
-        emit connected();
-        fetchStats(); // Initial fetch
-        m_statsTimer->start(); // Start periodic updates
-        qDebug() << "Stats timer started for" << m_id;
-    } else {
-        qDebug() << "Connection failed for" << m_id;
-        emit error(m_id, "Connection failed: " + output);
-    }
+    runRemoteCommand("echo 'connected'", kConnectTimeoutMs, [this](const QString &output) {
+        qDebug() << "Connection test output:" << output.left(100);
+
+        if (output.contains("connected")) {
+            qDebug() << "Connection successful for" << m_id;
+            m_connected = true;
+            // Polls come from the scheduler from here on
+            emit connected();
+            if (m_streaming && m_agentState == AgentUnknown) {
+                deployAgent();
+            }
+        } else {
+            qDebug() << "Connection failed for" << m_id;
+            emit error(m_id, "Connection failed: " + output);
+        }
+    });
 }
 
 void RemoteWorker::disconnect()
 {
     qDebug() << "RemoteWorker::disconnect() called for" << m_id;
-    m_connected = false;
-    if (m_statsTimer) {
-        m_statsTimer->stop();
-        qDebug() << "Stats timer stopped for" << m_id;
+    abortRemoteCommand();
+    stopStream();
+
+    if (m_connected) {
+        closeControlMaster();
     }
+    m_connected = false;
     
-    // Close SSH control socket
-    QString controlPath = QString("/tmp/ssh-control-%1-%2-%3")
+    emit disconnected();
+    qDebug() << "Disconnect complete for" << m_id;
+}
+
+QString RemoteWorker::controlPath() const
+{
+    return QString("/tmp/ssh-control-%1-%2-%3")
         .arg(m_host)
         .arg(m_port)
         .arg(m_username);
+}
+
+void RemoteWorker::closeControlMaster()
+{
+    if (m_transport != Ssh) return;
     
-    QProcess closeProcess;
+    // Fire and forget: nothing here waits for the master to exit
     QStringList args;
     args << "-p" << QString::number(m_port)
          << "-O" << "exit"
-         << "-o" << "ControlPath=" + controlPath
+         << "-o" << "ControlPath=" + controlPath()
          << m_username + "@" + m_host;
     
-    closeProcess.start("ssh", args);
-    closeProcess.waitForFinished(2000);
-    qDebug() << "SSH control socket closed for" << m_id;
-    
-    emit disconnected();
-    qDebug() << "Disconnect complete for" << m_id;
-}
-
-void RemoteWorker::pauseStats()
-{
-    if (m_statsTimer && m_statsTimer->isActive()) {
-        m_statsTimer->stop();
-        qDebug() << "Stats paused for" << m_id;
-    }
-}
-
-void RemoteWorker::resumeStats()
-{
-    if (m_connected && m_statsTimer && !m_statsTimer->isActive()) {
-        m_statsTimer->start();
-        qDebug() << "Stats resumed for" << m_id;
-    }
+    QProcess::startDetached("ssh", args);
+    qDebug() << "SSH control socket close requested for" << m_id;
 }
 
 void RemoteWorker::fetchStats()
 {
+    m_pollPending = true;
     if (!m_connected) {
         qDebug() << "fetchStats called but not connected for" << m_id;
+        finishPoll(false);
+        return;
+    }
+    
+    if (m_streaming) {
+        // Picked up again once the agent is settled
+        if (m_agentState == AgentDeploying) return;
+        if (!m_stream) startStream();
+
+        // The session answers one request at a time; a sample overdue by
+        // the command timeout means the session is stuck
+        if (m_sampleRequested) {
+            if (m_sampleClock.elapsed() < kStatsTimeoutMs) {
+                qDebug() << "Previous sample still pending for" << m_id << "- skipping";
+                return;
+            }
+            qDebug() << "Stream stalled for" << m_id << "- restarting";
+            stopStream();
+            if (++m_streamFailures >= kMaxStreamFailures) {
+                qDebug() << "Falling back to polling for" << m_id;
+                m_streaming = false;
+                fetchStats();
+                return;
+            }
+            startStream();
+        }
+        // A start failure may already have been reported
+        if (!m_stream) return;
+
+        m_stream->write("\n");
+        m_sampleRequested = true;
+        m_sampleClock.start();
+        return;
+    }
+    
+    // A slow host must not pile up fetches behind the one still running
+    if (m_process) {
+        qDebug() << "Previous fetch still running for" << m_id << "- skipping";
         return;
     }
     
     qDebug() << "fetchStats() called for" << m_id << "- fetching...";
     
+    if (m_procSampling) {
+        // Raw /proc counters read with shell builtins; top alone would walk
+        // every /proc/<pid> on the host
+        const QString command = QString("exec sh -c '%1'").arg(ProcStats::sampleScript(true));
+        runRemoteCommand(command, kStatsTimeoutMs, [this](const QString &output) {
+            if (output.startsWith("Error:")) {
+                qDebug() << "Failed to fetch stats for" << m_id << ":" << output.left(200);
+                finishPoll(false);
+                return;
+            }
+            
+            const QStringList lines = output.split('\n');
+            const int begin = lines.indexOf("@@sample");
+            const int end = lines.indexOf("@@end");
+            if (begin >= 0 && end > begin && onSampleFrame(lines.mid(begin + 1, end - begin - 1))) return;
+            
+            qDebug() << "Host" << m_id << "has no /proc/stat - using portable commands";
+            m_procSampling = false;
+            fetchStats();
+        });
+        return;
+    }
+    
+    // Portable commands for hosts without a Linux /proc.
     // Fetch all stats in one SSH session for efficiency
     // Use full paths and LC_ALL=C to ensure consistent output format
     QString commands = "LC_ALL=C /usr/bin/top -bn1 | /usr/bin/grep 'Cpu(s)' ; "
@@ -445,40 +749,361 @@ void RemoteWorker::fetchStats()
                       "LC_ALL=C /usr/bin/df -h / ; "
                       "/usr/bin/cat /proc/net/dev";
     
-    QString output = executeRemoteCommand(commands);
-    
+    runRemoteCommand(commands, kStatsTimeoutMs, [this](const QString &output) {
+        onStatsOutput(output);
+    });
+}
+
+void RemoteWorker::onStatsOutput(const QString &output)
+{
     qDebug() << "Remote stats output for" << m_id << ":" << output.left(200);
     
     if (output.isEmpty() || output.startsWith("Error:")) {
         qDebug() << "Failed to fetch stats for" << m_id;
+        finishPoll(false);
         return;
     }
     
     double cpu = parseCpuUsage(output);
     double ram = parseMemoryUsage(output);
     double disk = parseDiskUsage(output);
-    QString netUp, netDown;
+    double netUp = 0.0;
+    double netDown = 0.0;
     parseNetworkUsage(output, netUp, netDown);
     
     qDebug() << "Parsed stats for" << m_id << "- CPU:" << cpu << "RAM:" << ram << "DISK:" << disk;
-    qDebug() << "Timer active for" << m_id << ":" << (m_statsTimer ? m_statsTimer->isActive() : false);
     
-    emit statsReady(m_id, cpu, ram, disk, netUp, netDown);
+    emit statsReady(m_id, cpu, ram, disk, netUp, netDown, 0.0, 0.0);
+    finishPoll(true);
     qDebug() << "Stats emitted for" << m_id;
 }
 
-QString RemoteWorker::executeRemoteCommand(const QString &command)
+void RemoteWorker::finishPoll(bool ok)
+{
+    if (!m_pollPending) return;
+    m_pollPending = false;
+    emit pollFinished(m_id, ok);
+}
+
+void RemoteWorker::startStream()
 {
-    QProcess process;
+    m_streamIsAgent = m_agentState == AgentReady;
+    const QString command = m_streamIsAgent
+        ? "exec " + m_agentPath
+        : QString("exec sh -c '%1'").arg(ProcStats::streamScript(kStatFsEvery));
     
+    QString program;
     QStringList args;
+    hostCommand(command, program, args);
+    
+    qDebug() << "Starting stats stream for" << m_id << (m_streamIsAgent ? "from ac-agent" : "from the shell");
+    m_stream = new QProcess(this);
+    m_frame.clear();
+    m_agentBuffer.clear();
+    m_agentGreeted = false;
+    m_sampleRequested = false;
+    m_streamDelivered = false;
+    
+    QObject::connect(m_stream, &QProcess::readyReadStandardOutput, this, &RemoteWorker::onStreamReadyRead);
+    QObject::connect(m_stream, &QProcess::finished, this, &RemoteWorker::onStreamFinished);
+    QObject::connect(m_stream, &QProcess::errorOccurred, this, [this](QProcess::ProcessError processError) {
+        // finished() does not follow a failed start
+        if (processError == QProcess::FailedToStart) onStreamFinished();
+    });
+    
+    m_stream->start(program, args);
+}
+
+void RemoteWorker::stopStream()
+{
+    if (!m_stream) return;
+    
+    QProcess *stream = m_stream;
+    m_stream = nullptr;
+    stream->disconnect(this);
+    stream->kill();
+    stream->deleteLater();
+    m_frame.clear();
+    m_agentBuffer.clear();
+    m_streamIsAgent = false;
+    m_sampleRequested = false;
+}
+
+void RemoteWorker::onStreamReadyRead()
+{
+    if (m_streamIsAgent) {
+        onAgentOutput();
+        return;
+    }
+    
+    // Frames are parsed as lines arrive; a partial line waits for the rest
+    while (m_stream && m_stream->canReadLine()) {
+        QString line = QString::fromUtf8(m_stream->readLine());
+        line.chop(1);
+        
+        if (line == "@@sample") {
+            m_frame.clear();
+        } else if (line == "@@end") {
+            const QStringList frame = m_frame;
+            m_frame.clear();
+            m_sampleRequested = false;
+            if (onSampleFrame(frame)) {
+                m_streamDelivered = true;
+                m_streamFailures = 0;
+            } else {
+                // No /proc/stat: not a Linux host, so use the portable commands
+                qDebug() << "Host" << m_id << "cannot stream stats - falling back to polling";
+                stopStream();
+                m_streaming = false;
+                m_procSampling = false;
+                fetchStats();
+            }
+        } else if (m_frame.size() < kMaxFrameLines) {
+            m_frame.append(line);
+        }
+    }
+}
+
+void RemoteWorker::onStreamFinished()
+{
+    if (!m_stream) return;
+    
+    qDebug() << "Stats stream ended for" << m_id << ":" << m_stream->readAllStandardError().trimmed();
+    const bool delivered = m_streamDelivered;
+    const bool wasAgent = m_streamIsAgent;
+    stopStream();
+    
+    if (wasAgent && !delivered) {
+        onAgentFailed("ac-agent exited before its first sample");
+        return;
+    }
+    finishPoll(false);
+    
+    // Restarted on the next tick unless it keeps failing right away
+    if (!delivered && ++m_streamFailures >= kMaxStreamFailures) {
+        qDebug() << "Falling back to polling for" << m_id;
+        m_streaming = false;
+    }
+}
+
+bool RemoteWorker::onSampleFrame(const QStringList &lines)
+{
+    ProcSample sample;
+    if (!ProcStats::parseFrame(lines, sample)) return false;
+    
+    onSample(sample);
+    return true;
+}
+
+void RemoteWorker::onSample(ProcSample sample)
+{
+    // statfs is not part of every frame; the last value still holds
+    if (!sample.hasFs && m_hasPrevSample) {
+        sample.hasFs = m_prevSample.hasFs;
+        sample.fsUsedBytes = m_prevSample.fsUsedBytes;
+        sample.fsAvailableBytes = m_prevSample.fsAvailableBytes;
+    }
+    
+    // The host's uptime gives the real interval; the local clock is only a
+    // fallback and includes network jitter
+    const double localSeconds = m_prevSampleClock.isValid() ? m_prevSampleClock.elapsed() / 1000.0 : 0.0;
+    const ProcRates rates = ProcStats::rates(m_hasPrevSample ? m_prevSample : ProcSample(), sample, localSeconds);
+    m_prevSample = sample;
+    m_hasPrevSample = true;
+    m_prevSampleClock.start();
+    
+    emit statsReady(m_id, rates.cpuPercent, rates.ramPercent, rates.diskPercent,
+                    rates.netUpBytesPerSec, rates.netDownBytesPerSec,
+                    rates.diskReadBytesPerSec, rates.diskWriteBytesPerSec);
+    finishPoll(true);
+}
+
+void RemoteWorker::deployAgent()
+{
+    const LocalAgent &agent = localAgent();
+    if (agent.binary.isEmpty()) {
+        onAgentFailed("no ac-agent next to the application");
+        return;
+    }
+    
+    m_agentState = AgentDeploying;
+    m_agentPath = QString("%1/ac-agent-%2").arg(kAgentCacheDir, agent.sha256.left(16));
+    
+    // One round trip tells whether the host can run it and already has it
+    const QString command = QString("uname -sm; test -x %1 && echo present; true").arg(m_agentPath);
+    runRemoteCommand(command, kConnectTimeoutMs, [this](const QString &output) {
+        if (output.startsWith("Error:")) {
+            onAgentFailed(output);
+            return;
+        }
+        
+        const QString uname = output.section('\n', 0, 0).trimmed();
+        const QStringList parts = uname.split(' ', Qt::SkipEmptyParts);
+        if (parts.size() < 2 || parts[0] != "Linux" || !localAgent().machines.contains(parts[1])) {
+            onAgentFailed("host is " + uname);
+            return;
+        }
+        
+        if (output.contains("present")) {
+            qDebug() << "ac-agent already cached on" << m_id;
+            m_agentState = AgentReady;
+            if (m_pollPending) fetchStats();
+            return;
+        }
+        uploadAgent();
+    });
+}
+
+void RemoteWorker::uploadAgent()
+{
+    const LocalAgent &agent = localAgent();
+    const QString temp = m_agentPath + ".tmp";
+    
+    // The host checks the checksum before the file becomes executable, so a
+    // cut-off upload never ends up in the cache
+    const QString command = QString("mkdir -p %1 && cat > %2 && echo '%3  %2' | sha256sum -c - >/dev/null"
+                                    " && chmod 755 %2 && mv -f %2 %4 && echo installed || { rm -f %2; exit 1; }")
+        .arg(kAgentCacheDir, temp, agent.sha256, m_agentPath);
+    
+    qDebug() << "Uploading ac-agent to" << m_id << "-" << agent.binary.size() << "bytes";
+    runRemoteCommand(command, kAgentUploadTimeoutMs, [this](const QString &output) {
+        if (!output.contains("installed")) {
+            onAgentFailed("upload failed: " + output.left(200));
+            return;
+        }
+        m_agentState = AgentReady;
+        if (m_pollPending) fetchStats();
+    }, agent.binary);
+}
+
+void RemoteWorker::onAgentFailed(const QString &reason)
+{
+    // The shell sampler takes over for the rest of the session
+    qDebug() << "Not using ac-agent on" << m_id << ":" << reason;
+    m_agentState = AgentUnavailable;
+    if (m_streamIsAgent) stopStream();
+    if (m_connected && m_pollPending) fetchStats();
+}
+
+void RemoteWorker::onAgentOutput()
+{
+    m_agentBuffer.append(m_stream->readAllStandardOutput());
+    
+    if (!m_agentGreeted) {
+        if (m_agentBuffer.size() < int(kAgentMagicSize)) return;
+        if (!m_agentBuffer.startsWith(kAgentMagic)) {
+            onAgentFailed("unexpected output " + QString::fromLatin1(m_agentBuffer.left(32).toHex()));
+            return;
+        }
+        m_agentBuffer.remove(0, int(kAgentMagicSize));
+        m_agentGreeted = true;
+    }
+    
+    // Frames may arrive split or several at once
+    while (!m_agentBuffer.isEmpty()) {
+        AgentSample agentSample;
+        const long used = agentDecode(reinterpret_cast<const unsigned char *>(m_agentBuffer.constData()),
+                                      size_t(m_agentBuffer.size()), agentSample);
+        if (used == 0) return;
+        
+        ProcSample sample;
+        if (used < 0 || !ProcStats::fromAgent(agentSample, sample)) {
+            onAgentFailed("corrupt sample frame");
+            return;
+        }
+        m_agentBuffer.remove(0, int(used));
+        m_sampleRequested = false;
+        m_streamDelivered = true;
+        m_streamFailures = 0;
+        onSample(sample);
+    }
+}
+
+void RemoteWorker::runRemoteCommand(const QString &command, int timeoutMs, CommandCallback done,
+                                    const QByteArray &input)
+{
     QString program;
+    QStringList args;
+    hostCommand(command, program, args);
     
-    // Create control path for SSH connection multiplexing
-    QString controlPath = QString("/tmp/ssh-control-%1-%2-%3")
-        .arg(m_host)
-        .arg(m_port)
-        .arg(m_username);
+    qDebug() << "Executing SSH command for" << m_id << ":" << program << args.join(" ").replace(m_password, "***");
+    
+    // One command at a time per worker
+    abortRemoteCommand();
+    
+    QProcess *process = new QProcess(this);
+    QTimer *deadline = new QTimer(process);
+    deadline->setSingleShot(true);
+    m_process = process;
+    
+    // Runs once, for whichever comes first: exit, failure to start or the
+    // deadline. A command aborted in between never reports at all.
+    auto complete = [this, process, deadline, done](const QString &output) {
+        if (m_process != process) return;
+        m_process = nullptr;
+        deadline->stop();
+        process->disconnect(this);
+        process->deleteLater();
+        done(output);
+    };
+    
+    QObject::connect(deadline, &QTimer::timeout, this, [this, process, timeoutMs, complete]() {
+        if (m_process != process) return;
+        process->kill();
+        qDebug() << "SSH command timed out for" << m_id;
+        complete(QString("Error: Connection timed out after %1 seconds").arg(timeoutMs / 1000));
+    });
+    
+    QObject::connect(process, &QProcess::errorOccurred, this, [this, process, program, complete](QProcess::ProcessError processError) {
+        // Other errors are followed by finished()
+        if (processError != QProcess::FailedToStart) return;
+        qDebug() << "SSH command failed to start for" << m_id << ":" << process->errorString();
+        if (program == "sshpass") {
+            complete("Error: sshpass not found. Please install it: sudo apt install sshpass");
+        } else {
+            complete("Error: " + process->errorString());
+        }
+    });
+    
+    QObject::connect(process, &QProcess::finished, this, [this, process, program, complete](int exitCode, QProcess::ExitStatus status) {
+        if (status != QProcess::NormalExit || exitCode != 0) {
+            QString errorMsg = process->readAllStandardError();
+            qDebug() << "SSH error for" << m_id << "- Exit code:" << exitCode << "Error:" << errorMsg;
+            
+            if (program == "sshpass" && errorMsg.isEmpty()) {
+                errorMsg = "Authentication failed. Please check your credentials.";
+            } else if (errorMsg.contains("Connection timed out")) {
+                errorMsg = "Connection timed out. Check firewall/network or increase timeout.";
+            }
+            complete("Error: " + errorMsg);
+            return;
+        }
+        
+        QString output = process->readAllStandardOutput();
+        qDebug() << "SSH command successful for" << m_id << "- Output length:" << output.length();
+        complete(output);
+    });
+    
+    process->start(program, args);
+    if (m_process != process) return; // Failed to start and already reported
+    if (!input.isEmpty()) {
+        // Buffered until the process runs; closing the channel ends the input
+        process->write(input);
+    }
+    process->closeWriteChannel();
+    deadline->start(timeoutMs);
+}
+
+void RemoteWorker::hostCommand(const QString &command, QString &program, QStringList &args) const
+{
+    if (m_transport == FakeHost) {
+        program = QCoreApplication::applicationDirPath() + "/ac-fakehost";
+        args << m_fakeHostOptions << m_host << command;
+        return;
+    }
+    
+    // Control path for SSH connection multiplexing
+    const QString controlPath = this->controlPath();
     
     // Use sshpass for password authentication if password is provided
     if (!m_password.isEmpty()) {
@@ -511,35 +1136,17 @@ QString RemoteWorker::executeRemoteCommand(const QString &command)
              << m_username + "@" + m_host
              << command;
     }
+}
+
+void RemoteWorker::abortRemoteCommand()
+{
+    if (!m_process) return;
     
-    qDebug() << "Executing SSH command for" << m_id << ":" << program << args.join(" ").replace(m_password, "***");
-    
-    process.start(program, args);
-    bool finished = process.waitForFinished(15000); // 15 second timeout
-    
-    if (!finished) {
-        process.kill();
-        qDebug() << "SSH command timed out for" << m_id;
-        return "Error: Connection timed out after 15 seconds";
-    }
-    
-    if (process.exitCode() != 0) {
-        QString errorMsg = process.readAllStandardError();
-        qDebug() << "SSH error for" << m_id << "- Exit code:" << process.exitCode() << "Error:" << errorMsg;
-        
-        if (program == "sshpass" && errorMsg.isEmpty()) {
-            errorMsg = "Authentication failed. Please check your credentials.";
-        } else if (program == "sshpass" && process.error() == QProcess::FailedToStart) {
-            errorMsg = "sshpass not found. Please install it: sudo apt install sshpass";
-        } else if (errorMsg.contains("Connection timed out")) {
-            errorMsg = "Connection timed out. Check firewall/network or increase timeout.";
-        }
-        return "Error: " + errorMsg;
-    }
-    
-    QString output = process.readAllStandardOutput();
-    qDebug() << "SSH command successful for" << m_id << "- Output length:" << output.length();
-    return output;
+    QProcess *process = m_process;
+    m_process = nullptr;
+    process->disconnect(this);
+    process->kill();
+    process->deleteLater();
 }
 
 double RemoteWorker::parseCpuUsage(const QString &output)
@@ -592,7 +1199,7 @@ double RemoteWorker::parseDiskUsage(const QString &output)
     return 0.0;
 }
 
-void RemoteWorker::parseNetworkUsage(const QString &output, QString &up, QString &down)
+void RemoteWorker::parseNetworkUsage(const QString &output, double &up, double &down)
 {
     quint64 bytesSent = 0;
     quint64 bytesReceived = 0;
@@ -625,39 +1232,22 @@ void RemoteWorker::parseNetworkUsage(const QString &output, QString &up, QString
         }
     }
     
-    // Calculate speed (bytes per second)
-    // Note: Stats are fetched every 5 seconds, so we need to divide by 5
-    if (m_prevBytesReceived > 0 || m_prevBytesSent > 0) {
-        // We have previous values, calculate speed
-        qint64 uploadSpeed = (bytesSent - m_prevBytesSent) / 5;  // Divide by 5 seconds
-        qint64 downloadSpeed = (bytesReceived - m_prevBytesReceived) / 5;  // Divide by 5 seconds
-        
-        // Prevent negative values from counter resets
-        if (uploadSpeed < 0) uploadSpeed = 0;
-        if (downloadSpeed < 0) downloadSpeed = 0;
-        
-        // Convert to KB/s or MB/s
-        double upKB = uploadSpeed / 1024.0;
-        double downKB = downloadSpeed / 1024.0;
-        
-        if (upKB > 1024) {
-            up = QString::number(upKB / 1024.0, 'f', 2) + " MB/s";
-        } else {
-            up = QString::number(upKB, 'f', 1) + " KB/s";
-        }
-        
-        if (downKB > 1024) {
-            down = QString::number(downKB / 1024.0, 'f', 2) + " MB/s";
-        } else {
-            down = QString::number(downKB, 'f', 1) + " KB/s";
-        }
+    // Calculate speed (bytes per second) over the time since the last fetch;
+    // a slow or skipped fetch makes that longer than the timer interval
+    const double seconds = m_prevLegacyClock.isValid() ? m_prevLegacyClock.restart() / 1000.0 : 0.0;
+    if (!m_prevLegacyClock.isValid()) m_prevLegacyClock.start();
+    
+    if ((m_prevBytesReceived > 0 || m_prevBytesSent > 0) && seconds > 0.0) {
+        // Counter resets count as no traffic
+        up = bytesSent >= m_prevBytesSent ? (bytesSent - m_prevBytesSent) / seconds : 0.0;
+        down = bytesReceived >= m_prevBytesReceived ? (bytesReceived - m_prevBytesReceived) / seconds : 0.0;
         
         qDebug() << "Network for" << m_id << "- Up:" << up << "Down:" << down 
                  << "(bytes:" << bytesSent << bytesReceived << "prev:" << m_prevBytesSent << m_prevBytesReceived << ")";
     } else {
         // First fetch, just initialize
-        up = "0 KB/s";
-        down = "0 KB/s";
+        up = 0.0;
+        down = 0.0;
         qDebug() << "Network for" << m_id << "- First fetch, initializing counters";
     }
     
@@ -667,35 +1257,5 @@ void RemoteWorker::parseNetworkUsage(const QString &output, QString &up, QString
 
 bool RemoteWorker::isLocalhost() const
 {
-    // Check common localhost identifiers
-    if (m_host == "localhost" || 
-        m_host == "127.0.0.1" || 
-        m_host == "::1" ||
-        m_host == "0.0.0.0") {
-        return true;
-    }
-    
-    // Check if it's the local machine's hostname
-    QProcess process;
-    process.start("hostname", QStringList());
-    process.waitForFinished(1000);
-    QString localHostname = process.readAllStandardOutput().trimmed();
-    
-    if (m_host == localHostname) {
-        return true;
-    }
-    
-    // Check local IP addresses
-    process.start("hostname", QStringList() << "-I");
-    process.waitForFinished(1000);
-    QString localIPs = process.readAllStandardOutput().trimmed();
-    QStringList ipList = localIPs.split(' ', Qt::SkipEmptyParts);
-    
-    for (const QString &ip : ipList) {
-        if (m_host == ip.trimmed()) {
-            return true;
-        }
-    }
-    
-    return false;
+    return localIdentities().contains(m_host.trimmed().toLower());
 }
@@ -1,4 +1,5 @@
 #include "SystemMonitor.h"
+#include "ProcReader.h"
 #include <QDebug>
 #include <QFile>
 #include <QTextStream>
@@ -249,35 +250,18 @@ double SystemWorker::updateCpuUsage()
         }
     }
 #elif defined(Q_OS_LINUX)
-    // Linux: Read /proc/stat
-    QFile file("/proc/stat");
-    if (file.open(QIODevice::ReadOnly)) {
-        QTextStream in(&file);
-        QString line = in.readLine();
-        QStringList parts = line.split(' ', Qt::SkipEmptyParts);
-        
-        if (parts.size() >= 5 && parts[0] == "cpu") {
-            quint64 user = parts[1].toULongLong();
-            quint64 nice = parts[2].toULongLong();
-            quint64 system = parts[3].toULongLong();
-            quint64 idle = parts[4].toULongLong();
-            
-            quint64 totalTime = user + nice + system + idle;
-            quint64 idleTime = idle;
-            
-            if (m_prevTotalTime > 0) {
-                quint64 totalDelta = totalTime - m_prevTotalTime;
-                quint64 idleDelta = idleTime - m_prevIdleTime;
-                
-                if (totalDelta > 0) {
-                    cpuUsage = 100.0 * (1.0 - (double)idleDelta / totalDelta);
-                }
-            }
-            
-            m_prevTotalTime = totalTime;
-            m_prevIdleTime = idleTime;
+    // Linux: Read /proc/stat (same reader as the remote agent)
+    uint64_t totalTime = 0;
+    uint64_t idleTime = 0;
+    if (ProcReader::readCpu(totalTime, idleTime)) {
+        if (m_prevTotalTime > 0 && totalTime > m_prevTotalTime && idleTime >= m_prevIdleTime) {
+            quint64 totalDelta = totalTime - m_prevTotalTime;
+            quint64 idleDelta = idleTime - m_prevIdleTime;
+            cpuUsage = 100.0 * (1.0 - (double)idleDelta / totalDelta);
         }
-        file.close();
+        
+        m_prevTotalTime = totalTime;
+        m_prevIdleTime = idleTime;
         return cpuUsage;
     }
 #elif defined(Q_OS_MACOS)
@@ -330,26 +314,11 @@ double SystemWorker::updateMemoryUsage()
     }
 #elif defined(Q_OS_LINUX)
     // Linux: Read /proc/meminfo
-    QFile file("/proc/meminfo");
-    if (file.open(QIODevice::ReadOnly)) {
-        QTextStream in(&file);
-        quint64 memTotal = 0, memAvailable = 0;
-        
-        while (!in.atEnd()) {
-            QString line = in.readLine();
-            if (line.startsWith("MemTotal:")) {
-                memTotal = line.split(QRegularExpression("\\s+"))[1].toULongLong();
-            } else if (line.startsWith("MemAvailable:")) {
-                memAvailable = line.split(QRegularExpression("\\s+"))[1].toULongLong();
-            }
-        }
-        
-        if (memTotal > 0) {
-            ramUsage = 100.0 * (1.0 - (double)memAvailable / memTotal);
-            file.close();
-            return ramUsage;
-        }
-        file.close();
+    uint64_t memTotal = 0;
+    uint64_t memAvailable = 0;
+    if (ProcReader::readMemory(memTotal, memAvailable)) {
+        ramUsage = 100.0 * (1.0 - (double)memAvailable / memTotal);
+        return ramUsage;
     }
 #endif
     
@@ -395,31 +364,12 @@ void SystemWorker::updateNetworkUsage(QString &netUp, QString &netDown)
         }
     }
 #elif defined(Q_OS_LINUX)
-    // Linux: Read /proc/net/dev
-    QFile file("/proc/net/dev");
-    if (file.open(QIODevice::ReadOnly)) {
-        QTextStream in(&file);
-        
-        // Skip header lines
-        in.readLine();
-        in.readLine();
-        
-        while (!in.atEnd()) {
-            QString line = in.readLine();
-            if (line.contains(':')) {
-                QString interface = line.split(':')[0].trimmed();
-                
-                // Skip loopback
-                if (interface == "lo") continue;
-                
-                QStringList parts = line.split(':')[1].simplified().split(' ');
-                if (parts.size() >= 9) {
-                    bytesReceived += parts[0].toULongLong();
-                    bytesSent += parts[8].toULongLong();
-                }
-            }
-        }
-        file.close();
+    // Linux: Read /proc/net/dev, loopback excluded
+    uint64_t rxBytes = 0;
+    uint64_t txBytes = 0;
+    if (ProcReader::readNetwork(rxBytes, txBytes)) {
+        bytesReceived = rxBytes;
+        bytesSent = txBytes;
     }
 #elif defined(Q_OS_MACOS)
     // macOS: Use netstat -ib
@@ -0,0 +1,573 @@
+#include "TargetWatcher.h"
+#include "ScanIndex.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/fanotify.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr int kCoalesceIntervalMs = 500;
+// inotify watches are shared by every process of the user; live updates
+// run unasked after each scan, so they take a small slice of the limit
+constexpr int kWatchBudgetDivisor = 8;
+constexpr int kMaxWatchBudget = 8192;
+constexpr int kDefaultWatchBudget = 1024;
+
+#ifdef Q_OS_LINUX
+constexpr uint32_t kInotifyMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO
+                                | IN_ONLYDIR | IN_DONT_FOLLOW;
+#ifdef FAN_REPORT_DFID_NAME
+constexpr uint64_t kFanotifyMask = FAN_CREATE | FAN_DELETE | FAN_MODIFY | FAN_MOVED_FROM | FAN_MOVED_TO
+                                 | FAN_ONDIR;
+
+QByteArray handleKey(int type, const unsigned char *bytes, unsigned int length)
+{
+    QByteArray key(reinterpret_cast<const char *>(&type), sizeof(type));
+    key.append(reinterpret_cast<const char *>(bytes), length);
+    return key;
+}
+
+QByteArray fileHandleKey(const QByteArray &nativePath)
+{
+    alignas(struct file_handle) char storage[sizeof(struct file_handle) + MAX_HANDLE_SZ];
+    auto *fh = reinterpret_cast<struct file_handle *>(storage);
+    fh->handle_bytes = MAX_HANDLE_SZ;
+    int mountId = 0;
+    if (name_to_handle_at(AT_FDCWD, nativePath.constData(), fh, &mountId, 0) != 0) {
+        return QByteArray();
+    }
+    return handleKey(fh->handle_type, fh->f_handle, fh->handle_bytes);
+}
+#endif
+#endif
+
+QString joinPath(const QString &dir, const QString &name)
+{
+    return dir.endsWith('/') ? dir + name : dir + '/' + name;
+}
+}
+
+TargetWatcher::TargetWatcher(QObject *parent)
+    : QObject(parent)
+{
+    m_coalesceTimer = new QTimer(this);
+    m_coalesceTimer->setSingleShot(true);
+    m_coalesceTimer->setInterval(kCoalesceIntervalMs);
+    connect(m_coalesceTimer, &QTimer::timeout, this, &TargetWatcher::processPendingChanges);
+}
+
+TargetWatcher::~TargetWatcher()
+{
+    closeNotifier();
+}
+
+void TargetWatcher::watchTargets(const QString &rootPath, const QList<CleanupTarget> &targets)
+{
+    stopWatching();
+
+#ifdef Q_OS_LINUX
+    if (targets.isEmpty()) {
+        emit watchStateChanged("off", 0);
+        return;
+    }
+
+    // A filesystem mark can still be refused (no CAP_SYS_ADMIN, or a
+    // filesystem without fsid), in which case fall back to inotify
+    bool ready = openFanotify();
+    for (int i = 0; ready && i < targets.size(); ++i) {
+        WatchedDir probe;
+        if (!registerDirectory(targets[i].path, probe)) {
+            closeNotifier();
+            m_markedFilesystems.clear();
+            m_handleToDir.clear();
+            ready = false;
+        }
+    }
+    if (!ready && !openInotify()) {
+        emit watchStateChanged("off", 0);
+        return;
+    }
+
+    // Seed per-directory sizes from the index the scan just wrote instead of
+    // walking the targets a second time
+    ScanIndex index;
+    if (!index.open(ScanIndex::indexPathFor(rootPath), rootPath)) {
+        closeNotifier();
+        emit watchStateChanged("off", 0);
+        return;
+    }
+
+    QHash<QString, qint64> targetSizes;
+    QSet<QString> ancestors;
+    for (const CleanupTarget &target : targets) {
+        targetSizes.insert(target.path, target.size);
+        QString parent = QFileInfo(target.path).path();
+        while (parent.size() >= rootPath.size() && !ancestors.contains(parent)) {
+            ancestors.insert(parent);
+            if (parent == rootPath) break;
+            parent = QFileInfo(parent).path();
+        }
+    }
+
+    struct Level {
+        int end;
+        QString path;
+        QString target;
+    };
+    QList<Level> stack;
+    QHash<QString, QList<QPair<QString, qint64>>> dirsByTarget;
+
+    const int count = index.dirCount();
+    for (int i = 0; i < count;) {
+        while (!stack.isEmpty() && stack.last().end <= i) {
+            stack.removeLast();
+        }
+
+        const ScanIndex::DirRecord &record = index.dir(i);
+        const QString path = stack.isEmpty() ? rootPath : joinPath(stack.last().path, index.name(i));
+        QString target = stack.isEmpty() ? QString() : stack.last().target;
+        if (target.isEmpty() && targetSizes.contains(path)) {
+            target = path;
+        }
+
+        // Skip subtrees that neither are nor contain a target
+        if (target.isEmpty() && !ancestors.contains(path)) {
+            i = qMax(i + 1, int(record.subtreeEnd));
+            continue;
+        }
+
+        if (!target.isEmpty()) {
+            dirsByTarget[target].append(qMakePair(path, qint64(record.ownBytes)));
+        }
+        stack.append({int(record.subtreeEnd), path, target});
+        ++i;
+    }
+    index.close();
+
+    // Largest targets first, so a tight inotify budget covers what matters
+    QList<CleanupTarget> ordered = targets;
+    std::sort(ordered.begin(), ordered.end(), [](const CleanupTarget &a, const CleanupTarget &b) {
+        return a.size > b.size;
+    });
+
+    int watchedTargets = 0;
+    for (const CleanupTarget &target : ordered) {
+        const QList<QPair<QString, qint64>> dirs = dirsByTarget.value(target.path);
+        if (dirs.isEmpty()) continue;
+
+        if (m_mode == ModeInotify && m_wdToDir.size() + dirs.size() > m_watchBudget) {
+            qDebug() << "Watch budget exhausted, not watching" << target.path;
+            continue;
+        }
+
+        for (const auto &entry : dirs) {
+            WatchedDir dir;
+            dir.target = target.path;
+            dir.ownBytes = entry.second;
+            registerDirectory(entry.first, dir);
+            m_dirs.insert(entry.first, dir);
+        }
+        m_targetSizes.insert(target.path, target.size);
+        watchedTargets++;
+    }
+
+    qDebug() << "Live updates:" << watchedTargets << "targets," << m_dirs.size() << "directories via"
+             << (m_mode == ModeFanotify ? "fanotify" : "inotify");
+    emit watchStateChanged(m_mode == ModeFanotify ? "fanotify" : "inotify", watchedTargets);
+#else
+    Q_UNUSED(rootPath);
+    Q_UNUSED(targets);
+    emit watchStateChanged("off", 0);
+#endif
+}
+
+void TargetWatcher::unwatchTarget(const QString &path)
+{
+    if (!m_targetSizes.contains(path)) return;
+
+    removeDirectoryTree(path);
+    m_targetSizes.remove(path);
+    m_changedTargets.remove(path);
+}
+
+void TargetWatcher::stopWatching()
+{
+    closeNotifier();
+    m_coalesceTimer->stop();
+
+    m_dirs.clear();
+    m_targetSizes.clear();
+    m_wdToDir.clear();
+    m_handleToDir.clear();
+    m_markedFilesystems.clear();
+    m_dirtyDirs.clear();
+    m_createdDirs.clear();
+    m_removedDirs.clear();
+    m_changedTargets.clear();
+    m_budgetWarned = false;
+}
+
+void TargetWatcher::onEventsReady()
+{
+    if (m_mode == ModeFanotify) {
+        readFanotifyEvents();
+    } else if (m_mode == ModeInotify) {
+        readInotifyEvents();
+    }
+}
+
+void TargetWatcher::processPendingChanges()
+{
+    // Order matters: a directory removed and recreated inside one window
+    // must end up counted once
+    for (const QString &path : std::as_const(m_removedDirs)) {
+        removeDirectoryTree(path);
+    }
+    for (const QString &path : std::as_const(m_createdDirs)) {
+        QString target = targetFor(path);
+        if (!target.isEmpty() && !m_dirs.contains(path)) {
+            addDirectoryTree(path, target);
+        }
+    }
+    for (const QString &path : std::as_const(m_dirtyDirs)) {
+        auto it = m_dirs.find(path);
+        if (it == m_dirs.end()) continue;
+
+        bool exists = false;
+        qint64 ownBytes = measureOwnFiles(path, &exists);
+        if (!exists || ownBytes == it->ownBytes) continue;
+
+        m_targetSizes[it->target] += ownBytes - it->ownBytes;
+        m_changedTargets.insert(it->target);
+        it->ownBytes = ownBytes;
+    }
+
+    m_removedDirs.clear();
+    m_createdDirs.clear();
+    m_dirtyDirs.clear();
+
+    if (m_changedTargets.isEmpty()) return;
+
+    QHash<QString, qint64> sizes;
+    for (const QString &target : std::as_const(m_changedTargets)) {
+        sizes.insert(target, m_targetSizes.value(target));
+    }
+    m_changedTargets.clear();
+    emit targetSizesChanged(sizes);
+}
+
+bool TargetWatcher::openFanotify()
+{
+#if defined(Q_OS_LINUX) && defined(FAN_REPORT_DFID_NAME)
+    // EPERM without CAP_SYS_ADMIN, EINVAL on kernels older than 5.9
+    int fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK | FAN_REPORT_DFID_NAME,
+                           O_RDONLY | O_LARGEFILE);
+    if (fd < 0) return false;
+
+    m_fd = fd;
+    m_mode = ModeFanotify;
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &TargetWatcher::onEventsReady);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool TargetWatcher::openInotify()
+{
+#ifdef Q_OS_LINUX
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return false;
+
+    m_fd = fd;
+    m_mode = ModeInotify;
+    m_watchBudget = inotifyWatchBudget();
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &TargetWatcher::onEventsReady);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TargetWatcher::closeNotifier()
+{
+    delete m_notifier;
+    m_notifier = nullptr;
+
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+    m_fd = -1;
+    m_mode = ModeOff;
+}
+
+bool TargetWatcher::registerDirectory(const QString &path, WatchedDir &dir)
+{
+#ifdef Q_OS_LINUX
+    const QByteArray nativePath = QFile::encodeName(path);
+
+    if (m_mode == ModeInotify) {
+        if (m_wdToDir.size() >= m_watchBudget) {
+            if (!m_budgetWarned) {
+                qWarning() << "inotify watch budget of" << m_watchBudget
+                           << "reached; new directories are no longer tracked";
+                m_budgetWarned = true;
+            }
+            return false;
+        }
+
+        int wd = inotify_add_watch(m_fd, nativePath.constData(), kInotifyMask);
+        if (wd < 0) return false;
+        dir.wd = wd;
+        m_wdToDir.insert(wd, path);
+        return true;
+    }
+
+#ifdef FAN_REPORT_DFID_NAME
+    if (m_mode == ModeFanotify) {
+        struct stat sb;
+        if (::lstat(nativePath.constData(), &sb) != 0) return false;
+
+        // One mark covers the whole filesystem; events are matched to
+        // tracked directories by file handle
+        qulonglong dev = qulonglong(sb.st_dev);
+        if (!m_markedFilesystems.contains(dev)) {
+            if (fanotify_mark(m_fd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM, kFanotifyMask,
+                              AT_FDCWD, nativePath.constData()) != 0) {
+                qWarning() << "fanotify mark failed for" << path;
+                return false;
+            }
+            m_markedFilesystems.insert(dev);
+        }
+
+        QByteArray key = fileHandleKey(nativePath);
+        if (key.isEmpty()) return false;
+        m_handleToDir.insert(key, path);
+        dir.handle = key;
+        return true;
+    }
+#endif
+#else
+    Q_UNUSED(path);
+    Q_UNUSED(dir);
+#endif
+    return false;
+}
+
+void TargetWatcher::unregisterDirectory(const WatchedDir &dir)
+{
+#ifdef Q_OS_LINUX
+    if (m_mode == ModeInotify && dir.wd >= 0) {
+        // Fails harmlessly if the kernel already dropped the watch
+        inotify_rm_watch(m_fd, dir.wd);
+        m_wdToDir.remove(dir.wd);
+    }
+#ifdef FAN_REPORT_DFID_NAME
+    if (m_mode == ModeFanotify && !dir.handle.isEmpty()) {
+        m_handleToDir.remove(dir.handle);
+    }
+#endif
+#else
+    Q_UNUSED(dir);
+#endif
+}
+
+void TargetWatcher::readFanotifyEvents()
+{
+#if defined(Q_OS_LINUX) && defined(FAN_REPORT_DFID_NAME)
+    alignas(struct fanotify_event_metadata) char buffer[64 * 1024];
+
+    for (;;) {
+        ssize_t length = ::read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) break; // EAGAIN: queue drained
+
+        auto *meta = reinterpret_cast<struct fanotify_event_metadata *>(buffer);
+        for (; FAN_EVENT_OK(meta, length); meta = FAN_EVENT_NEXT(meta, length)) {
+            if (meta->mask & FAN_Q_OVERFLOW) {
+                markAllDirty();
+                continue;
+            }
+            if (meta->event_len <= sizeof(*meta)) continue;
+
+            auto *fid = reinterpret_cast<struct fanotify_event_info_fid *>(meta + 1);
+            if (fid->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME) continue;
+
+            auto *fh = reinterpret_cast<struct file_handle *>(fid->handle);
+            auto it = m_handleToDir.constFind(handleKey(fh->handle_type, fh->f_handle, fh->handle_bytes));
+            if (it == m_handleToDir.constEnd()) continue; // outside every target
+
+            const char *name = reinterpret_cast<const char *>(fh->f_handle + fh->handle_bytes);
+            if (qstrcmp(name, ".") == 0) continue;
+
+            queueEvent(it.value(), QFile::decodeName(name), meta->mask & FAN_ONDIR,
+                       meta->mask & (FAN_CREATE | FAN_MOVED_TO),
+                       meta->mask & (FAN_DELETE | FAN_MOVED_FROM));
+        }
+    }
+#endif
+}
+
+void TargetWatcher::readInotifyEvents()
+{
+#ifdef Q_OS_LINUX
+    alignas(struct inotify_event) char buffer[64 * 1024];
+
+    for (;;) {
+        ssize_t length = ::read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) break; // EAGAIN: queue drained
+
+        for (char *p = buffer; p < buffer + length;) {
+            auto *event = reinterpret_cast<struct inotify_event *>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                markAllDirty();
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                m_wdToDir.remove(event->wd);
+                continue;
+            }
+            if (event->len == 0) continue;
+
+            auto it = m_wdToDir.constFind(event->wd);
+            if (it == m_wdToDir.constEnd()) continue;
+
+            queueEvent(it.value(), QFile::decodeName(event->name), event->mask & IN_ISDIR,
+                       event->mask & (IN_CREATE | IN_MOVED_TO),
+                       event->mask & (IN_DELETE | IN_MOVED_FROM));
+        }
+    }
+#endif
+}
+
+void TargetWatcher::queueEvent(const QString &dirPath, const QString &name, bool isDir,
+                               bool created, bool removed)
+{
+    if (isDir) {
+        const QString path = joinPath(dirPath, name);
+        if (removed) m_removedDirs.append(path);
+        if (created) m_createdDirs.append(path);
+    } else {
+        m_dirtyDirs.insert(dirPath);
+    }
+
+    if (!m_coalesceTimer->isActive()) {
+        m_coalesceTimer->start();
+    }
+}
+
+void TargetWatcher::markAllDirty()
+{
+    // Events were lost; re-measure every tracked directory once
+    qDebug() << "Watch queue overflowed, re-measuring" << m_dirs.size() << "directories";
+    for (auto it = m_dirs.cbegin(); it != m_dirs.cend(); ++it) {
+        m_dirtyDirs.insert(it.key());
+    }
+
+    if (!m_coalesceTimer->isActive()) {
+        m_coalesceTimer->start();
+    }
+}
+
+void TargetWatcher::addDirectoryTree(const QString &path, const QString &target)
+{
+    QStringList pending{path};
+    while (!pending.isEmpty()) {
+        const QString dirPath = pending.takeLast();
+        if (m_dirs.contains(dirPath)) continue;
+
+        // Register before measuring so files created meanwhile raise events
+        WatchedDir dir;
+        dir.target = target;
+        registerDirectory(dirPath, dir);
+
+        bool exists = false;
+        dir.ownBytes = measureOwnFiles(dirPath, &exists);
+        if (!exists) {
+            unregisterDirectory(dir);
+            continue;
+        }
+
+        QDirIterator it(dirPath, QDir::Dirs | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+        while (it.hasNext()) {
+            pending.append(it.next());
+        }
+
+        m_dirs.insert(dirPath, dir);
+        m_targetSizes[target] += dir.ownBytes;
+        m_changedTargets.insert(target);
+    }
+}
+
+void TargetWatcher::removeDirectoryTree(const QString &path)
+{
+    auto release = [this](QMap<QString, WatchedDir>::iterator it) {
+        m_targetSizes[it->target] -= it->ownBytes;
+        m_changedTargets.insert(it->target);
+        unregisterDirectory(it.value());
+        return m_dirs.erase(it);
+    };
+
+    auto self = m_dirs.find(path);
+    if (self != m_dirs.end()) {
+        release(self);
+    }
+
+    // Descendants share the "path/" prefix and so form one contiguous range
+    const QString prefix = path + '/';
+    auto it = m_dirs.lowerBound(prefix);
+    while (it != m_dirs.end() && it.key().startsWith(prefix)) {
+        it = release(it);
+    }
+}
+
+QString TargetWatcher::targetFor(const QString &path) const
+{
+    const QString parent = QFileInfo(path).path();
+    auto it = m_dirs.constFind(parent);
+    return it == m_dirs.constEnd() ? QString() : it->target;
+}
+
+qint64 TargetWatcher::measureOwnFiles(const QString &path, bool *exists)
+{
+    QDir dir(path);
+    if (exists) *exists = dir.exists();
+
+    qint64 size = 0;
+    QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::System | QDir::NoSymLinks);
+    while (it.hasNext()) {
+        size += it.nextFileInfo().size();
+    }
+    return size;
+}
+
+int TargetWatcher::inotifyWatchBudget()
+{
+    // Leave nearly all of the per-user limit to editors, IDEs, file managers
+    // and build tools
+    QFile file("/proc/sys/fs/inotify/max_user_watches");
+    if (file.open(QIODevice::ReadOnly)) {
+        bool ok = false;
+        int maxWatches = file.readAll().trimmed().toInt(&ok);
+        if (ok && maxWatches > 0) {
+            return qMin(maxWatches / kWatchBudgetDivisor, kMaxWatchBudget);
+        }
+    }
+    return kDefaultWatchBudget;
+}
@@ -8,6 +8,7 @@
 #include "SystemMonitor.h"
 #include "DiskAnalyzer.h"
 #include "ServerManager.h"
+#include "HistorySparkLine.h"
 
 // Global log file
 QFile *logFile = nullptr;
@@ -68,6 +69,21 @@ int main(int argc, char *argv[])
     qmlRegisterType<SystemMonitor>("App", 1, 0, "SystemMonitor");
     qmlRegisterType<DiskAnalyzer>("App", 1, 0, "DiskAnalyzer");
     qmlRegisterType<ServerManager>("App", 1, 0, "ServerManager");
+    qmlRegisterUncreatableType<CleanupTargetModel>("App", 1, 0, "CleanupTargetModel",
+                                                   "Provided by DiskAnalyzer.cleanupTargets");
+    qmlRegisterUncreatableType<CleanupTargetProxyModel>("App", 1, 0, "CleanupTargetProxyModel",
+                                                        "Provided by DiskAnalyzer.visibleTargets");
+    qmlRegisterUncreatableType<DiskUsageModel>("App", 1, 0, "DiskUsageModel",
+                                               "Provided by DiskAnalyzer.usageTree");
+    qmlRegisterUncreatableType<DuplicateGroupModel>("App", 1, 0, "DuplicateGroupModel",
+                                                    "Provided by DiskAnalyzer.duplicateGroups");
+    qmlRegisterUncreatableType<LargestEntryModel>("App", 1, 0, "LargestEntryModel",
+                                                  "Provided by DiskAnalyzer.largestFiles and largestDirectories");
+    qmlRegisterUncreatableType<ServerListModel>("App", 1, 0, "ServerListModel",
+                                                "Provided by ServerManager.servers");
+    qmlRegisterUncreatableType<FleetSummaryModel>("App", 1, 0, "FleetSummaryModel",
+                                                  "Provided by ServerManager.fleet");
+    qmlRegisterType<HistorySparkLine>("App", 1, 0, "HistorySparkLine");
 
     QQmlApplicationEngine engine;
     QObject::connect(
@@ -0,0 +1,154 @@
+import QtQuick
+import QtQuick.Controls
+
+Item {
+    id: root
+
+    property var usageModel: null
+
+    Column {
+        anchors.fill: parent
+        spacing: 0
+
+        // Breadcrumb bar
+        Rectangle {
+            id: breadcrumb
+            width: parent.width
+            height: 32
+            color: "#0F0F0F"
+
+            Row {
+                anchors.fill: parent
+                anchors.leftMargin: 10
+                anchors.rightMargin: 10
+                spacing: 10
+
+                Rectangle {
+                    width: 40
+                    height: 22
+                    anchors.verticalCenter: parent.verticalCenter
+                    color: "transparent"
+                    border.color: root.usageModel && root.usageModel.canGoUp ? "#8B0000" : "#333"
+                    border.width: 1
+
+                    Text {
+                        anchors.centerIn: parent
+                        text: "UP"
+                        color: root.usageModel && root.usageModel.canGoUp ? "white" : "#555"
+                        font.pixelSize: 9
+                        font.family: "Segoe UI"
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        cursorShape: Qt.PointingHandCursor
+                        onClicked: root.usageModel.goUp()
+                    }
+                }
+
+                Text {
+                    width: parent.width - 160
+                    anchors.verticalCenter: parent.verticalCenter
+                    text: root.usageModel ? root.usageModel.currentPath : ""
+                    color: "#999"
+                    font.pixelSize: 10
+                    font.family: "Consolas"
+                    elide: Text.ElideMiddle
+                }
+
+                Text {
+                    anchors.verticalCenter: parent.verticalCenter
+                    text: root.usageModel && root.usageModel.hasTree
+                          ? diskSize(root.usageModel.currentSize) : ""
+                    color: "#00FF00"
+                    font.pixelSize: 10
+                    font.family: "Consolas"
+                }
+            }
+        }
+
+        Item {
+            id: canvas
+            width: parent.width
+            height: parent.height - breadcrumb.height
+            clip: true
+
+            onWidthChanged: if (root.usageModel) root.usageModel.viewWidth = width
+            onHeightChanged: if (root.usageModel) root.usageModel.viewHeight = height
+            Component.onCompleted: {
+                if (root.usageModel) {
+                    root.usageModel.viewWidth = width
+                    root.usageModel.viewHeight = height
+                }
+            }
+
+            Repeater {
+                model: root.usageModel
+
+                Rectangle {
+                    x: model.tileX
+                    y: model.tileY
+                    width: model.tileWidth
+                    height: model.tileHeight
+                    color: model.isOther ? "#1a1a1a"
+                         : model.isDir ? (tileMouse.containsMouse ? "#8B0000" : "#4a0000")
+                         : (tileMouse.containsMouse ? "#333" : "#222")
+                    border.color: "#0A0A0A"
+                    border.width: 1
+
+                    Column {
+                        anchors.fill: parent
+                        anchors.margins: 4
+                        spacing: 1
+                        visible: parent.width > 50 && parent.height > 26
+
+                        Text {
+                            width: parent.width
+                            text: model.name
+                            color: "white"
+                            font.pixelSize: 10
+                            font.family: "Segoe UI"
+                            elide: Text.ElideRight
+                        }
+
+                        Text {
+                            width: parent.width
+                            text: model.sizeFormatted
+                            color: "#888"
+                            font.pixelSize: 9
+                            font.family: "Consolas"
+                            elide: Text.ElideRight
+                        }
+                    }
+
+                    MouseArea {
+                        id: tileMouse
+                        anchors.fill: parent
+                        hoverEnabled: true
+                        cursorShape: model.canDrillDown ? Qt.PointingHandCursor : Qt.ArrowCursor
+                        onClicked: root.usageModel.drillDown(index)
+
+                        ToolTip.visible: containsMouse
+                        ToolTip.delay: 500
+                        ToolTip.text: model.path + "\n" + model.sizeFormatted
+                    }
+                }
+            }
+
+            Text {
+                anchors.centerIn: parent
+                visible: !root.usageModel || !root.usageModel.hasTree
+                text: "Run a scan to see the disk usage map"
+                color: "#666"
+                font.pixelSize: 14
+            }
+        }
+    }
+
+    function diskSize(bytes) {
+        if (bytes < 1024) return bytes + " B"
+        if (bytes < 1024 * 1024) return (bytes / 1024).toFixed(1) + " KB"
+        if (bytes < 1024 * 1024 * 1024) return (bytes / (1024 * 1024)).toFixed(1) + " MB"
+        return (bytes / (1024 * 1024 * 1024)).toFixed(2) + " GB"
+    }
+}
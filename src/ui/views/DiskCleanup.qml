@@ -8,26 +8,22 @@ Item {
     DiskAnalyzer {
         id: diskAnalyzer
         onScanComplete: (totalSavings) => {
-            statusText.text = "Found " + diskAnalyzer.cleanupTargets.length + " items. Potential savings: " + diskAnalyzer.formatSize(totalSavings)
+            summaryText = "Found " + diskAnalyzer.cleanupTargets.count + " items. Potential savings: " + diskAnalyzer.formatSize(totalSavings)
         }
     }
 
-    property string sortBy: "size" // size, date, type
-    property bool sortAscending: false
-    property var sortedTargets: {
-        var items = diskAnalyzer.cleanupTargets.slice()
-        if (sortBy === "size") {
-            items.sort((a, b) => sortAscending ? a.size - b.size : b.size - a.size)
-        } else if (sortBy === "date") {
-            items.sort((a, b) => {
-                var dateA = new Date(a.lastModified)
-                var dateB = new Date(b.lastModified)
-                return sortAscending ? dateA - dateB : dateB - dateA
-            })
-        } else if (sortBy === "type") {
-            items.sort((a, b) => sortAscending ? a.type.localeCompare(b.type) : b.type.localeCompare(a.type))
+    property string viewMode: "targets" // targets, map, largest, duplicates, growth
+    property bool largestDirectories: false
+    property string summaryText: ""
+
+    // Show the last scan's results as soon as the view is opened; the
+    // analyzer revalidates them in the background
+    property bool cacheRequested: false
+    onVisibleChanged: {
+        if (visible && !cacheRequested) {
+            cacheRequested = true
+            diskAnalyzer.loadCachedResults()
         }
-        return items
     }
 
     Column {
@@ -51,7 +47,7 @@ Item {
             }
 
             Item { 
-                width: parent.width - 600
+                width: parent.width - 900
                 height: 1
             }
 
@@ -60,6 +56,40 @@ Item {
                 spacing: 10
                 anchors.verticalCenter: parent.verticalCenter
 
+                // Result view selector
+                Repeater {
+                    model: [
+                        {label: "TARGETS", value: "targets"},
+                        {label: "MAP", value: "map"},
+                        {label: "LARGEST", value: "largest"},
+                        {label: "DUPES", value: "duplicates"},
+                        {label: "GROWTH", value: "growth"}
+                    ]
+
+                    Rectangle {
+                        width: 60
+                        height: 24
+                        color: viewMode === modelData.value ? "#8B0000" : "transparent"
+                        border.color: viewMode === modelData.value ? "#FF0000" : "#444"
+                        border.width: 1
+
+                        Text {
+                            anchors.centerIn: parent
+                            text: modelData.label
+                            color: viewMode === modelData.value ? "white" : "#888"
+                            font.pixelSize: 9
+                            font.weight: Font.Light
+                            font.family: "Segoe UI"
+                        }
+
+                        MouseArea {
+                            anchors.fill: parent
+                            cursorShape: Qt.PointingHandCursor
+                            onClicked: viewMode = modelData.value
+                        }
+                    }
+                }
+
                 Text {
                     text: "SORT BY:"
                     color: "#666"
@@ -79,14 +109,14 @@ Item {
                     Rectangle {
                         width: 50
                         height: 24
-                        color: sortBy === modelData.value ? "#8B0000" : "transparent"
-                        border.color: sortBy === modelData.value ? "#FF0000" : "#444"
+                        color: diskAnalyzer.visibleTargets.sortKey === modelData.value ? "#8B0000" : "transparent"
+                        border.color: diskAnalyzer.visibleTargets.sortKey === modelData.value ? "#FF0000" : "#444"
                         border.width: 1
 
                         Text {
                             anchors.centerIn: parent
                             text: modelData.label
-                            color: sortBy === modelData.value ? "white" : "#888"
+                            color: diskAnalyzer.visibleTargets.sortKey === modelData.value ? "white" : "#888"
                             font.pixelSize: 9
                             font.weight: Font.Light
                             font.family: "Segoe UI"
@@ -95,7 +125,7 @@ Item {
                         MouseArea {
                             anchors.fill: parent
                             cursorShape: Qt.PointingHandCursor
-                            onClicked: sortBy = modelData.value
+                            onClicked: diskAnalyzer.visibleTargets.sortKey = modelData.value
                         }
                     }
                 }
@@ -110,7 +140,7 @@ Item {
 
                     Text {
                         anchors.centerIn: parent
-                        text: sortAscending ? "↑" : "↓"
+                        text: diskAnalyzer.visibleTargets.sortAscending ? "↑" : "↓"
                         color: "#888"
                         font.pixelSize: 14
                     }
@@ -118,7 +148,7 @@ Item {
                     MouseArea {
                         anchors.fill: parent
                         cursorShape: Qt.PointingHandCursor
-                        onClicked: sortAscending = !sortAscending
+                        onClicked: diskAnalyzer.visibleTargets.sortAscending = !diskAnalyzer.visibleTargets.sortAscending
                     }
                 }
             }
@@ -140,8 +170,13 @@ Item {
                 Button {
                     width: 140
                     height: 40
-                    text: diskAnalyzer.isScanning ? "Scanning..." : "Start Scan"
-                    enabled: !diskAnalyzer.isScanning
+                    text: {
+                        if (viewMode === "duplicates")
+                            return diskAnalyzer.isFindingDuplicates ? "Cancel" : "Find Duplicates"
+                        if (viewMode === "growth")
+                            return "Compare"
+                        return diskAnalyzer.isScanning ? "Cancel" : "Start Scan"
+                    }
                     background: Rectangle {
                         color: parent.hovered ? "#8B0000" : "#660000"
                         border.color: "#FF0000"
@@ -157,33 +192,549 @@ Item {
                         font.weight: Font.Light
                         font.pixelSize: 13
                     }
-                    onClicked: diskAnalyzer.startScan()
+                    enabled: viewMode !== "growth" || (!diskAnalyzer.isComparing && baselineBox.currentIndex >= 0)
+                    onClicked: {
+                        if (viewMode === "growth") {
+                            diskAnalyzer.compareSnapshots(baselineBox.model[baselineBox.currentIndex].file)
+                        } else if (viewMode === "duplicates") {
+                            if (diskAnalyzer.isFindingDuplicates) {
+                                diskAnalyzer.cancelDuplicates()
+                            } else {
+                                diskAnalyzer.findDuplicates()
+                            }
+                        } else if (diskAnalyzer.isScanning) {
+                            diskAnalyzer.cancelScan()
+                        } else {
+                            summaryText = ""
+                            diskAnalyzer.startScan()
+                        }
+                    }
+                }
+
+                Column {
+                    spacing: 4
+                    anchors.verticalCenter: parent.verticalCenter
+
+                    Text {
+                        id: statusText
+                        text: {
+                            if (viewMode === "duplicates")
+                                return diskAnalyzer.duplicateProgress !== "" ? diskAnalyzer.duplicateProgress
+                                                                            : "Find identical files to reclaim space"
+                            if (viewMode === "growth")
+                                return diskAnalyzer.growthSummary !== "" ? diskAnalyzer.growthSummary
+                                                                         : "See which directories grew since an earlier scan"
+                            if (diskAnalyzer.isRevalidating)
+                                return "Cached results from " + diskAnalyzer.cachedScanTime + " • revalidating..."
+                            return !diskAnalyzer.isScanning && summaryText !== "" ? summaryText : diskAnalyzer.scanProgress
+                        }
+                        color: "#888"
+                        font.pixelSize: 12
+                        elide: Text.ElideMiddle
+                        width: 420
+                    }
+
+                    Text {
+                        visible: diskAnalyzer.isDeleting
+                        text: "Deleting: " + diskAnalyzer.formatSize(diskAnalyzer.deletedBytes) + " freed • "
+                              + diskAnalyzer.deletedFiles + " files"
+                              + (diskAnalyzer.deleteQueueLength > 0 ? " • " + diskAnalyzer.deleteQueueLength + " queued" : "")
+                        color: "#00FF00"
+                        font.pixelSize: 10
+                        font.family: "Consolas"
+                    }
+
+                    Text {
+                        visible: viewMode !== "duplicates" && viewMode !== "growth" && !diskAnalyzer.isDeleting && diskAnalyzer.scannedDirs > 0
+                        text: diskAnalyzer.scannedDirs + " dirs • " + diskAnalyzer.scannedFiles + " files • "
+                              + diskAnalyzer.formatSize(diskAnalyzer.scannedBytes) + " • "
+                              + diskAnalyzer.formatSize(diskAnalyzer.bytesPerSecond) + "/s"
+                        color: "#555"
+                        font.pixelSize: 10
+                        font.family: "Consolas"
+                    }
+                }
+
+                // Delete selected / cancel deletion
+                Button {
+                    width: 150
+                    height: 30
+                    anchors.verticalCenter: parent.verticalCenter
+                    visible: diskAnalyzer.isDeleting || diskAnalyzer.cleanupTargets.selectedCount > 0
+                    text: diskAnalyzer.isDeleting && diskAnalyzer.cleanupTargets.selectedCount === 0
+                          ? "Stop Deleting"
+                          : "Delete " + diskAnalyzer.cleanupTargets.selectedCount + " ("
+                            + diskAnalyzer.formatSize(diskAnalyzer.cleanupTargets.selectedSize) + ")"
+                    background: Rectangle {
+                        color: parent.hovered ? "#CC0000" : "#660000"
+                        border.color: "#FF0000"
+                        border.width: 1
+                        radius: 0
+                    }
+                    contentItem: Text {
+                        text: parent.text
+                        color: "white"
+                        horizontalAlignment: Text.AlignHCenter
+                        verticalAlignment: Text.AlignVCenter
+                        font.family: "Segoe UI"
+                        font.weight: Font.Light
+                        font.pixelSize: 11
+                    }
+                    onClicked: {
+                        if (diskAnalyzer.cleanupTargets.selectedCount > 0) {
+                            diskAnalyzer.deleteSelected()
+                        } else {
+                            diskAnalyzer.cancelDeletion()
+                        }
+                    }
+                }
+
+                // Polite mode: idle I/O priority, rate cap, pauses under I/O pressure
+                Rectangle {
+                    width: 60
+                    height: 24
+                    anchors.verticalCenter: parent.verticalCenter
+                    color: diskAnalyzer.politeScan ? "#8B0000" : "transparent"
+                    border.color: diskAnalyzer.politeScan ? "#FF0000" : "#444"
+                    border.width: 1
+
+                    Text {
+                        anchors.centerIn: parent
+                        text: "POLITE"
+                        color: diskAnalyzer.politeScan ? "white" : "#888"
+                        font.pixelSize: 9
+                        font.weight: Font.Light
+                        font.family: "Segoe UI"
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        cursorShape: Qt.PointingHandCursor
+                        onClicked: diskAnalyzer.politeScan = !diskAnalyzer.politeScan
+                    }
+                }
+
+                // Trash mode: move aside instantly, delete in the background
+                Rectangle {
+                    width: 60
+                    height: 24
+                    anchors.verticalCenter: parent.verticalCenter
+                    color: diskAnalyzer.useTrash ? "#8B0000" : "transparent"
+                    border.color: diskAnalyzer.useTrash ? "#FF0000" : "#444"
+                    border.width: 1
+
+                    Text {
+                        anchors.centerIn: parent
+                        text: "TRASH"
+                        color: diskAnalyzer.useTrash ? "white" : "#888"
+                        font.pixelSize: 9
+                        font.weight: Font.Light
+                        font.family: "Segoe UI"
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        cursorShape: Qt.PointingHandCursor
+                        onClicked: diskAnalyzer.useTrash = !diskAnalyzer.useTrash
+                    }
+                }
+
+                // Live update toggle
+                Rectangle {
+                    width: 110
+                    height: 24
+                    anchors.verticalCenter: parent.verticalCenter
+                    color: diskAnalyzer.liveUpdates ? "#8B0000" : "transparent"
+                    border.color: diskAnalyzer.liveUpdates ? "#FF0000" : "#444"
+                    border.width: 1
+
+                    Text {
+                        anchors.centerIn: parent
+                        text: diskAnalyzer.liveUpdates && diskAnalyzer.liveMode !== "off"
+                              ? "● LIVE (" + diskAnalyzer.liveMode + ")" : "LIVE"
+                        color: diskAnalyzer.liveUpdates ? "white" : "#888"
+                        font.pixelSize: 9
+                        font.weight: Font.Light
+                        font.family: "Segoe UI"
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        cursorShape: Qt.PointingHandCursor
+                        onClicked: diskAnalyzer.liveUpdates = !diskAnalyzer.liveUpdates
+                    }
+                }
+            }
+        }
+
+        // Filters, applied by the proxy model
+        Row {
+            width: parent.width
+            height: 28
+            spacing: 10
+            visible: viewMode === "targets"
+
+            TextField {
+                id: pathFilterField
+                width: 280
+                height: 28
+                placeholderText: "Filter by path..."
+                color: "white"
+                font.pixelSize: 11
+                font.family: "Segoe UI"
+                background: Rectangle {
+                    color: "#0F0F0F"
+                    border.color: pathFilterField.activeFocus ? "#FF0000" : "#444"
+                    border.width: 1
                 }
+                onTextChanged: diskAnalyzer.visibleTargets.pathFilter = text
+            }
+
+            ComboBox {
+                width: 180
+                height: 28
+                model: ["All types"].concat(diskAnalyzer.cleanupTargets.types)
+                font.pixelSize: 11
+                onActivated: (index) => diskAnalyzer.visibleTargets.typeFilter = index === 0 ? "" : model[index]
+            }
+
+            ComboBox {
+                width: 120
+                height: 28
+                textRole: "label"
+                model: [
+                    {label: "Any size", bytes: 0},
+                    {label: "> 10 MB", bytes: 10 * 1024 * 1024},
+                    {label: "> 100 MB", bytes: 100 * 1024 * 1024},
+                    {label: "> 1 GB", bytes: 1024 * 1024 * 1024}
+                ]
+                font.pixelSize: 11
+                onActivated: (index) => diskAnalyzer.visibleTargets.minSize = model[index].bytes
+            }
+
+            Rectangle {
+                width: 80
+                height: 24
+                anchors.verticalCenter: parent.verticalCenter
+                color: diskAnalyzer.visibleTargets.safeOnly ? "#8B0000" : "transparent"
+                border.color: diskAnalyzer.visibleTargets.safeOnly ? "#FF0000" : "#444"
+                border.width: 1
 
                 Text {
-                    id: statusText
-                    text: diskAnalyzer.scanProgress
-                    color: "#888"
-                    font.pixelSize: 12
+                    anchors.centerIn: parent
+                    text: "SAFE ONLY"
+                    color: diskAnalyzer.visibleTargets.safeOnly ? "white" : "#888"
+                    font.pixelSize: 9
+                    font.weight: Font.Light
+                    font.family: "Segoe UI"
+                }
+
+                MouseArea {
+                    anchors.fill: parent
+                    cursorShape: Qt.PointingHandCursor
+                    onClicked: diskAnalyzer.visibleTargets.safeOnly = !diskAnalyzer.visibleTargets.safeOnly
+                }
+            }
+
+            Text {
+                text: diskAnalyzer.visibleTargets.count + " of " + diskAnalyzer.cleanupTargets.count + " shown"
+                color: "#666"
+                font.pixelSize: 10
+                font.family: "Segoe UI"
+                anchors.verticalCenter: parent.verticalCenter
+            }
+        }
+
+        // Largest files or directories of the last scan
+        Row {
+            width: parent.width
+            height: 28
+            spacing: 10
+            visible: viewMode === "largest"
+
+            Repeater {
+                model: [
+                    {label: "FILES", directories: false},
+                    {label: "DIRECTORIES", directories: true}
+                ]
+
+                Rectangle {
+                    width: 90
+                    height: 24
                     anchors.verticalCenter: parent.verticalCenter
+                    color: largestDirectories === modelData.directories ? "#8B0000" : "transparent"
+                    border.color: largestDirectories === modelData.directories ? "#FF0000" : "#444"
+                    border.width: 1
+
+                    Text {
+                        anchors.centerIn: parent
+                        text: modelData.label
+                        color: largestDirectories === modelData.directories ? "white" : "#888"
+                        font.pixelSize: 9
+                        font.weight: Font.Light
+                        font.family: "Segoe UI"
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        cursorShape: Qt.PointingHandCursor
+                        onClicked: largestDirectories = modelData.directories
+                    }
                 }
             }
+
+            Text {
+                text: largestView.count + " largest " + (largestDirectories ? "directories" : "files")
+                color: "#666"
+                font.pixelSize: 10
+                font.family: "Segoe UI"
+                anchors.verticalCenter: parent.verticalCenter
+            }
+        }
+
+        // Growth baseline: every snapshot but the latest
+        Row {
+            width: parent.width
+            height: 28
+            spacing: 10
+            visible: viewMode === "growth"
+
+            Text {
+                text: "Compare latest scan with"
+                color: "#888"
+                font.pixelSize: 11
+                font.family: "Segoe UI"
+                anchors.verticalCenter: parent.verticalCenter
+            }
+
+            ComboBox {
+                id: baselineBox
+                width: 260
+                height: 28
+                textRole: "label"
+                model: diskAnalyzer.snapshots.slice(1)
+                font.pixelSize: 11
+            }
+
+            Text {
+                text: diskAnalyzer.snapshots.length + " snapshots kept"
+                color: "#666"
+                font.pixelSize: 10
+                font.family: "Segoe UI"
+                anchors.verticalCenter: parent.verticalCenter
+            }
         }
 
         // Results List
         Rectangle {
             width: parent.width
-            height: parent.height - 180
+            height: parent.height - (viewMode === "targets" || viewMode === "largest" || viewMode === "growth" ? 228 : 180)
             color: "transparent"
             border.color: "#333333"
             border.width: 1
             radius: 0
 
+            TreeMap {
+                anchors.fill: parent
+                anchors.margins: 1
+                visible: viewMode === "map"
+                usageModel: diskAnalyzer.usageTree
+            }
+
+            ListView {
+                id: duplicateView
+                anchors.fill: parent
+                clip: true
+                visible: viewMode === "duplicates"
+                model: diskAnalyzer.duplicateGroups
+
+                delegate: Item {
+                    width: duplicateView.width
+                    height: 36 + model.paths.length * 14
+
+                    Rectangle {
+                        anchors.bottom: parent.bottom
+                        width: parent.width
+                        height: 1
+                        color: "#222222"
+                    }
+
+                    Column {
+                        anchors.fill: parent
+                        anchors.leftMargin: 20
+                        anchors.rightMargin: 20
+                        anchors.topMargin: 8
+                        spacing: 3
+
+                        Row {
+                            spacing: 8
+                            Text {
+                                text: model.fileCount + " copies of " + model.fileSizeFormatted
+                                color: "#8B0000"
+                                font.pixelSize: 10
+                                font.weight: Font.DemiBold
+                                font.family: "Segoe UI"
+                            }
+                            Text {
+                                text: "• " + model.reclaimableFormatted + " reclaimable"
+                                color: "#00FF00"
+                                font.pixelSize: 10
+                                font.family: "Consolas"
+                            }
+                        }
+
+                        Repeater {
+                            model: paths
+                            Text {
+                                text: modelData
+                                color: "#999"
+                                font.pixelSize: 9
+                                font.family: "Consolas"
+                                elide: Text.ElideMiddle
+                                width: duplicateView.width - 40
+                            }
+                        }
+                    }
+                }
+            }
+
+            Text {
+                anchors.centerIn: parent
+                text: "Click 'Find Duplicates' to look for identical files"
+                color: "#666"
+                font.pixelSize: 14
+                visible: viewMode === "duplicates" && diskAnalyzer.duplicateGroups.count === 0
+                         && !diskAnalyzer.isFindingDuplicates
+            }
+
+            ListView {
+                id: largestView
+                anchors.fill: parent
+                clip: true
+                visible: viewMode === "largest"
+                model: largestDirectories ? diskAnalyzer.largestDirectories : diskAnalyzer.largestFiles
+
+                delegate: Item {
+                    width: largestView.width
+                    height: 32
+
+                    Rectangle {
+                        anchors.bottom: parent.bottom
+                        width: parent.width
+                        height: 1
+                        color: "#222222"
+                    }
+
+                    Text {
+                        anchors.left: parent.left
+                        anchors.leftMargin: 20
+                        anchors.verticalCenter: parent.verticalCenter
+                        text: (index + 1) + "."
+                        color: "#666"
+                        font.pixelSize: 10
+                        font.family: "Consolas"
+                    }
+
+                    Text {
+                        anchors.left: parent.left
+                        anchors.leftMargin: 60
+                        anchors.verticalCenter: parent.verticalCenter
+                        text: model.path
+                        color: "#CCCCCC"
+                        font.pixelSize: 11
+                        font.family: "Consolas"
+                        elide: Text.ElideMiddle
+                        width: largestView.width - 200
+                    }
+
+                    Text {
+                        anchors.right: parent.right
+                        anchors.rightMargin: 20
+                        anchors.verticalCenter: parent.verticalCenter
+                        text: model.sizeFormatted
+                        color: "#00FF00"
+                        font.pixelSize: 13
+                        font.family: "Consolas"
+                    }
+                }
+            }
+
+            Text {
+                anchors.centerIn: parent
+                text: "Run a scan to list the largest files and directories"
+                color: "#666"
+                font.pixelSize: 14
+                visible: viewMode === "largest" && largestView.count === 0
+            }
+
+            ListView {
+                id: growthView
+                anchors.fill: parent
+                clip: true
+                visible: viewMode === "growth"
+                model: diskAnalyzer.growers.concat(diskAnalyzer.shrinkers)
+
+                delegate: Item {
+                    width: growthView.width
+                    height: 40
+
+                    Rectangle {
+                        anchors.bottom: parent.bottom
+                        width: parent.width
+                        height: 1
+                        color: "#222222"
+                    }
+
+                    Column {
+                        anchors.left: parent.left
+                        anchors.leftMargin: 20
+                        anchors.verticalCenter: parent.verticalCenter
+                        spacing: 3
+
+                        Text {
+                            text: modelData.path === "" ? "(scan root)" : modelData.path
+                            color: "#CCCCCC"
+                            font.pixelSize: 11
+                            font.family: "Consolas"
+                            elide: Text.ElideMiddle
+                            width: growthView.width - 180
+                        }
+                        Text {
+                            text: diskAnalyzer.formatSize(modelData.oldSize) + " → " + diskAnalyzer.formatSize(modelData.newSize)
+                            color: "#777"
+                            font.pixelSize: 9
+                            font.family: "Consolas"
+                        }
+                    }
+
+                    Text {
+                        anchors.right: parent.right
+                        anchors.rightMargin: 20
+                        anchors.verticalCenter: parent.verticalCenter
+                        text: modelData.deltaFormatted
+                        color: modelData.delta >= 0 ? "#FF4444" : "#00FF00"
+                        font.pixelSize: 13
+                        font.family: "Consolas"
+                    }
+                }
+            }
+
+            Text {
+                anchors.centerIn: parent
+                text: diskAnalyzer.snapshots.length < 2 ? "Growth needs at least two completed scans"
+                                                        : "Pick an earlier scan and click 'Compare'"
+                color: "#666"
+                font.pixelSize: 14
+                visible: viewMode === "growth" && diskAnalyzer.growers.length === 0
+                         && diskAnalyzer.shrinkers.length === 0 && !diskAnalyzer.isComparing
+            }
+
             ListView {
                 id: listView
                 anchors.fill: parent
                 clip: true
-                model: sortedTargets
+                visible: viewMode === "targets"
+                model: diskAnalyzer.visibleTargets
 
                 delegate: Item {
                     width: listView.width
@@ -191,7 +742,8 @@ Item {
 
                     Rectangle {
                         anchors.fill: parent
-                        color: mouseArea.containsMouse ? "#1a1a1a" : "transparent"
+                        color: model.selected ? "#2a0000" : mouseArea.containsMouse ? "#1a1a1a" : "transparent"
+                        opacity: model.isDeleting ? 0.5 : 1.0
                         
                         // Bottom border
                         Rectangle {
@@ -207,37 +759,62 @@ Item {
                             anchors.rightMargin: 20
                             spacing: 15
 
+                            // Selection checkbox
+                            Rectangle {
+                                width: 14
+                                height: 14
+                                anchors.verticalCenter: parent.verticalCenter
+                                color: model.selected ? "#8B0000" : "transparent"
+                                border.color: model.selected ? "#FF0000" : "#555"
+                                border.width: 1
+
+                                Text {
+                                    anchors.centerIn: parent
+                                    text: model.selected ? "✓" : ""
+                                    color: "white"
+                                    font.pixelSize: 10
+                                }
+
+                                MouseArea {
+                                    anchors.fill: parent
+                                    anchors.margins: -6
+                                    cursorShape: Qt.PointingHandCursor
+                                    enabled: !model.isDeleting
+                                    onClicked: model.selected = !model.selected
+                                }
+                            }
+
                             // Type indicator
                             Rectangle {
                                 width: 3
                                 height: 32
                                 anchors.verticalCenter: parent.verticalCenter
-                                color: modelData.isSafe ? "#8B0000" : "#FF0000"
+                                color: model.isSafe ? "#8B0000" : "#FF0000"
                             }
 
                             // Content
                             Column {
-                                width: parent.width - 220
+                                width: parent.width - 250
                                 anchors.verticalCenter: parent.verticalCenter
                                 spacing: 3
 
                                 Row {
                                     spacing: 8
                                     Text {
-                                        text: modelData.type
+                                        text: model.type
                                         color: "#8B0000"
                                         font.pixelSize: 10
                                         font.weight: Font.DemiBold
                                         font.family: "Segoe UI"
                                     }
                                     Text {
-                                        text: "• " + modelData.lastModified
+                                        text: "• " + model.lastModified
                                         color: "#555"
                                         font.pixelSize: 9
                                         font.family: "Segoe UI"
                                     }
                                     Text {
-                                        text: "• " + modelData.reason
+                                        text: "• " + model.reason
                                         color: "#555"
                                         font.pixelSize: 9
                                         font.family: "Segoe UI"
@@ -246,7 +823,7 @@ Item {
                                 }
 
                                 Text {
-                                    text: modelData.path
+                                    text: model.path
                                     color: "#999"
                                     font.pixelSize: 9
                                     font.family: "Consolas"
@@ -261,7 +838,7 @@ Item {
                                 spacing: 12
 
                                 Text {
-                                    text: modelData.sizeFormatted
+                                    text: model.sizeFormatted
                                     color: "#00FF00"
                                     font.pixelSize: 11
                                     font.weight: Font.Light
@@ -270,7 +847,8 @@ Item {
                                 }
 
                                 Button {
-                                    text: "DELETE"
+                                    text: model.isDeleting ? "DELETING" : "DELETE"
+                                    enabled: !model.isDeleting
                                     width: 70
                                     height: 26
                                     anchors.verticalCenter: parent.verticalCenter
@@ -290,15 +868,7 @@ Item {
                                         font.letterSpacing: 1
                                         font.family: "Segoe UI"
                                     }
-                                    onClicked: {
-                                        // Find original index in unsorted array
-                                        for (var i = 0; i < diskAnalyzer.cleanupTargets.length; i++) {
-                                            if (diskAnalyzer.cleanupTargets[i].path === modelData.path) {
-                                                diskAnalyzer.deleteTarget(i)
-                                                break
-                                            }
-                                        }
-                                    }
+                                    onClicked: diskAnalyzer.deleteTarget(model.path)
                                 }
                             }
                         }
@@ -315,10 +885,10 @@ Item {
 
             Text {
                 anchors.centerIn: parent
-                text: diskAnalyzer.cleanupTargets.length === 0 ? "Click 'Start Scan' to analyze disk usage" : ""
+                text: diskAnalyzer.cleanupTargets.count === 0 ? "Click 'Start Scan' to analyze disk usage" : ""
                 color: "#666"
                 font.pixelSize: 14
-                visible: diskAnalyzer.cleanupTargets.length === 0
+                visible: viewMode === "targets" && diskAnalyzer.cleanupTargets.count === 0
             }
         }
     }
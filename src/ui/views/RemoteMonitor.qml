@@ -35,7 +35,10 @@ Item {
     property string editServerHost: ""
     property int editServerPort: 22
     property string editServerUsername: ""
-    property string editServerPassword: ""
+    property string editServerTags: ""
+    property int editServerPollInterval: 0
+    // Span of the per-server sparklines: 10 min, 6 h or 24 h
+    property int historyTier: HistorySparkLine.Raw
 
     Column {
         anchors.fill: parent
@@ -48,6 +51,7 @@ Item {
             height: 40
 
             Text {
+                id: titleText
                 text: "REMOTE SERVER MONITORING"
                 color: "white"
                 font.pixelSize: 16
@@ -58,7 +62,183 @@ Item {
                 anchors.verticalCenter: parent.verticalCenter
             }
 
+            // Time to all connected of the last connect-all run
+            Text {
+                visible: serverManager.connectingAll || serverManager.connectAllMs >= 0
+                text: serverManager.connectingAll ? "CONNECTING…"
+                    : "LIVE IN " + (serverManager.connectAllMs / 1000).toFixed(1) + " s"
+                      + (serverManager.connectAllFailures > 0 ? " · " + serverManager.connectAllFailures + " FAILED" : "")
+                color: serverManager.connectAllFailures > 0 ? "#FF3333" : "#888"
+                font.pixelSize: 9
+                font.weight: Font.Light
+                font.family: "Segoe UI"
+                font.letterSpacing: 1
+                anchors.left: titleText.right
+                anchors.leftMargin: 16
+                anchors.verticalCenter: parent.verticalCenter
+            }
+
+            // Connects every saved server, a bounded number at a time
+            Rectangle {
+                width: 90
+                height: 24
+                anchors.right: startupToggle.left
+                anchors.rightMargin: 10
+                anchors.verticalCenter: parent.verticalCenter
+                color: connectAllHover.hovered ? "#8B0000" : "transparent"
+                border.color: "#444"
+                border.width: 1
+
+                Text {
+                    anchors.centerIn: parent
+                    text: "CONNECT ALL"
+                    color: "white"
+                    font.pixelSize: 9
+                    font.weight: Font.Light
+                    font.family: "Segoe UI"
+                }
+
+                MouseArea {
+                    anchors.fill: parent
+                    cursorShape: Qt.PointingHandCursor
+                    onClicked: serverManager.connectAll()
+                }
+
+                HoverHandler { id: connectAllHover }
+            }
+
+            Rectangle {
+                id: startupToggle
+                width: 80
+                height: 24
+                anchors.right: historyToggle.left
+                anchors.rightMargin: 10
+                anchors.verticalCenter: parent.verticalCenter
+                color: serverManager.connectOnStartup ? "#8B0000" : "transparent"
+                border.color: serverManager.connectOnStartup ? "#FF0000" : "#444"
+                border.width: 1
+
+                Text {
+                    anchors.centerIn: parent
+                    text: "ON START"
+                    color: serverManager.connectOnStartup ? "white" : "#888"
+                    font.pixelSize: 9
+                    font.weight: Font.Light
+                    font.family: "Segoe UI"
+                }
+
+                MouseArea {
+                    anchors.fill: parent
+                    cursorShape: Qt.PointingHandCursor
+                    onClicked: serverManager.connectOnStartup = !serverManager.connectOnStartup
+                }
+
+                ToolTip.visible: startupHover.hovered
+                ToolTip.text: "Connect all servers when the application starts"
+                HoverHandler { id: startupHover }
+            }
+
+            // Cycles the sparkline span through the history tiers
+            Rectangle {
+                id: historyToggle
+                width: 60
+                height: 24
+                anchors.right: agentToggle.left
+                anchors.rightMargin: 10
+                anchors.verticalCenter: parent.verticalCenter
+                color: "transparent"
+                border.color: "#444"
+                border.width: 1
+
+                Text {
+                    anchors.centerIn: parent
+                    text: historyTier === HistorySparkLine.Raw ? "10 MIN"
+                        : historyTier === HistorySparkLine.Minute ? "6 H" : "24 H"
+                    color: "white"
+                    font.pixelSize: 9
+                    font.weight: Font.Light
+                    font.family: "Segoe UI"
+                }
+
+                MouseArea {
+                    anchors.fill: parent
+                    cursorShape: Qt.PointingHandCursor
+                    onClicked: historyTier = historyTier === HistorySparkLine.Raw ? HistorySparkLine.Minute
+                        : historyTier === HistorySparkLine.Minute ? HistorySparkLine.QuarterHour : HistorySparkLine.Raw
+                }
+
+                ToolTip.visible: historyHover.hovered
+                ToolTip.text: "History shown in the CPU and network sparklines"
+                HoverHandler { id: historyHover }
+            }
+
+            // The agent replaces the shell sampler inside the streaming session
+            Rectangle {
+                id: agentToggle
+                width: 80
+                height: 24
+                anchors.right: streamToggle.left
+                anchors.rightMargin: 10
+                anchors.verticalCenter: parent.verticalCenter
+                opacity: serverManager.streamingMode ? 1.0 : 0.4
+                color: serverManager.agentMode ? "#8B0000" : "transparent"
+                border.color: serverManager.agentMode ? "#FF0000" : "#444"
+                border.width: 1
+
+                Text {
+                    anchors.centerIn: parent
+                    text: "AGENT"
+                    color: serverManager.agentMode ? "white" : "#888"
+                    font.pixelSize: 9
+                    font.weight: Font.Light
+                    font.family: "Segoe UI"
+                }
+
+                MouseArea {
+                    anchors.fill: parent
+                    cursorShape: Qt.PointingHandCursor
+                    onClicked: serverManager.agentMode = !serverManager.agentMode
+                }
+
+                ToolTip.visible: agentHover.hovered
+                ToolTip.text: "Upload and stream from ac-agent, with the shell as fallback (streaming only, new connections)"
+                HoverHandler { id: agentHover }
+            }
+
+            // Streaming keeps one ssh session per server open between samples
+            Rectangle {
+                id: streamToggle
+                width: 80
+                height: 24
+                anchors.right: addServerButton.left
+                anchors.rightMargin: 10
+                anchors.verticalCenter: parent.verticalCenter
+                color: serverManager.streamingMode ? "#8B0000" : "transparent"
+                border.color: serverManager.streamingMode ? "#FF0000" : "#444"
+                border.width: 1
+
+                Text {
+                    anchors.centerIn: parent
+                    text: "STREAM"
+                    color: serverManager.streamingMode ? "white" : "#888"
+                    font.pixelSize: 9
+                    font.weight: Font.Light
+                    font.family: "Segoe UI"
+                }
+
+                MouseArea {
+                    anchors.fill: parent
+                    cursorShape: Qt.PointingHandCursor
+                    onClicked: serverManager.streamingMode = !serverManager.streamingMode
+                }
+
+                ToolTip.visible: streamHover.hovered
+                ToolTip.text: "One persistent SSH session per server (applies to new connections)"
+                HoverHandler { id: streamHover }
+            }
+
             Button {
+                id: addServerButton
                 text: "+ ADD SERVER"
                 width: 120
                 height: 32
@@ -84,10 +264,74 @@ Item {
             }
         }
 
+        // Fleet summary: the whole fleet first, then one line per tag
+        Column {
+            id: fleetSummary
+            width: parent.width
+            spacing: 4
+
+            Repeater {
+                model: serverManager.fleet
+
+                delegate: Row {
+                    spacing: 16
+
+                    Text {
+                        width: 120
+                        text: model.group + " · " + model.servers
+                        color: "white"
+                        font.pixelSize: 11
+                        font.weight: Font.DemiBold
+                        font.family: "Segoe UI"
+                        elide: Text.ElideRight
+                    }
+                    Text {
+                        text: "CPU p50 " + model.cpuP50.toFixed(0) + "%  p95 " + model.cpuP95.toFixed(0)
+                              + "%  p99 " + model.cpuP99.toFixed(0) + "%"
+                        color: "#FF3333"
+                        font.pixelSize: 11
+                        font.family: "Consolas"
+                    }
+                    Text {
+                        text: "RAM p99 " + model.ramP99.toFixed(0) + "%" + (model.hotHosts !== "" ? " (" + model.hotHosts + ")" : "")
+                        color: "#FF3333"
+                        font.pixelSize: 11
+                        font.family: "Consolas"
+                    }
+                    Text {
+                        text: "↑ " + model.netUp + "  ↓ " + model.netDown
+                        color: "#00FF00"
+                        font.pixelSize: 11
+                        font.family: "Consolas"
+                    }
+                    // Poll interval of the tag's servers, in seconds
+                    TextField {
+                        visible: index > 0
+                        width: 60
+                        height: 20
+                        padding: 2
+                        placeholderText: "5 s"
+                        placeholderTextColor: "#666"
+                        text: index > 0 && serverManager.groupInterval(model.group) > 0
+                              ? serverManager.groupInterval(model.group).toString() : ""
+                        color: "white"
+                        font.pixelSize: 10
+                        validator: IntValidator { bottom: 0; top: 3600 }
+                        background: Rectangle {
+                            color: "#1a1a1a"
+                            border.color: "#333"
+                            border.width: 1
+                        }
+                        onEditingFinished: serverManager.setGroupInterval(model.group, parseInt(text) || 0)
+                    }
+                }
+            }
+        }
+
         // Server List
         Rectangle {
             width: parent.width
-            height: parent.height - 100
+            height: parent.height - 100 - fleetSummary.height - parent.spacing
             color: "transparent"
             border.color: "#333333"
             border.width: 1
@@ -99,6 +343,9 @@ Item {
                 clip: true
                 model: serverManager.servers
                 spacing: 0
+                // Stats ticks only touch the changed roles of a row; scrolling
+                // recycles delegates instead of creating new ones
+                reuseItems: true
 
                 delegate: Item {
                     width: serverList.width
@@ -143,7 +390,7 @@ Item {
                                     height: 8
                                     radius: 4
                                     anchors.verticalCenter: parent.verticalCenter
-                                    color: modelData.connected ? "#00FF00" : "#FF0000"
+                                    color: model.connected ? "#00FF00" : "#FF0000"
                                 }
 
                                 // Server info
@@ -153,7 +400,7 @@ Item {
                                     spacing: 5
 
                                     Text {
-                                        text: modelData.name
+                                        text: model.name
                                         color: "white"
                                         font.pixelSize: 14
                                         font.weight: Font.DemiBold
@@ -161,7 +408,7 @@ Item {
                                     }
 
                                     Text {
-                                        text: modelData.username + "@" + modelData.host + ":" + modelData.port
+                                        text: model.username + "@" + model.host + ":" + model.port
                                         color: "#888"
                                         font.pixelSize: 10
                                         font.family: "Consolas"
@@ -174,10 +421,10 @@ Item {
                                         Text {
                                             id: statusText
                                             text: {
-                                                var displayText = modelData.connected ? "Connected" : (modelData.lastError || "Disconnected");
+                                                var displayText = model.connected ? "Connected" : (model.lastError || "Disconnected");
                                                 return displayText;
                                             }
-                                            color: modelData.connected ? "#00FF00" : "#FF0000"
+                                            color: model.connected ? "#00FF00" : "#FF0000"
                                             font.pixelSize: 9
                                             font.family: "Segoe UI"
                                             maximumLineCount: 2
@@ -188,7 +435,7 @@ Item {
 
                                         Button {
                                             id: copyButton
-                                            visible: !modelData.connected && modelData.lastError && modelData.lastError !== ""
+                                            visible: !model.connected && model.lastError && model.lastError !== ""
                                             width: 18
                                             height: 18
                                             anchors.verticalCenter: parent.verticalCenter
@@ -208,8 +455,8 @@ Item {
                                             }
                                             
                                             onClicked: {
-                                                serverManager.copyToClipboard(modelData.lastError);
-                                                console.log("Error copied to clipboard: " + modelData.lastError);
+                                                serverManager.copyToClipboard(model.lastError);
+                                                console.log("Error copied to clipboard: " + model.lastError);
                                             }
                                             
                                             ToolTip.visible: hovered
@@ -228,7 +475,7 @@ Item {
                                     StatCircle {
                                         width: 70
                                         height: 70
-                                        value: modelData.cpuUsage
+                                        value: model.cpuUsage
                                         label: "CPU"
                                         primaryColor: "#8B0000"
                                         glowColor: "#FF3333"
@@ -238,7 +485,7 @@ Item {
                                     StatCircle {
                                         width: 70
                                         height: 70
-                                        value: modelData.ramUsage
+                                        value: model.ramUsage
                                         label: "RAM"
                                         primaryColor: "#8B0000"
                                         glowColor: "#FF3333"
@@ -248,7 +495,7 @@ Item {
                                     StatCircle {
                                         width: 70
                                         height: 70
-                                        value: modelData.diskUsage
+                                        value: model.diskUsage
                                         label: "DISK"
                                         primaryColor: "#8B0000"
                                         glowColor: "#FF3333"
@@ -260,17 +507,57 @@ Item {
                                         anchors.verticalCenter: parent.verticalCenter
                                         width: 100  // Fixed width to prevent button shifting
                                         Text {
-                                            text: "↑ " + modelData.networkUp
+                                            text: "↑ " + model.networkUp
                                             color: "#00FF00"
                                             font.pixelSize: 10
                                             font.family: "Consolas"
                                         }
                                         Text {
-                                            text: "↓ " + modelData.networkDown
+                                            text: "↓ " + model.networkDown
                                             color: "#00FF00"
                                             font.pixelSize: 10
                                             font.family: "Consolas"
                                         }
+                                        Text {
+                                            text: "R " + model.diskRead
+                                            color: "#888"
+                                            font.pixelSize: 10
+                                            font.family: "Consolas"
+                                        }
+                                        Text {
+                                            text: "W " + model.diskWrite
+                                            color: "#888"
+                                            font.pixelSize: 10
+                                            font.family: "Consolas"
+                                        }
+                                    }
+
+                                    // CPU and download history, painted from the model
+                                    Column {
+                                        spacing: 6
+                                        anchors.verticalCenter: parent.verticalCenter
+
+                                        HistorySparkLine {
+                                            width: 120
+                                            height: 30
+                                            source: serverManager.servers
+                                            serverId: model.serverId
+                                            revision: model.historyRevision
+                                            metric: HistorySparkLine.Cpu
+                                            tier: historyTier
+                                            lineColor: "#FF3333"
+                                        }
+
+                                        HistorySparkLine {
+                                            width: 120
+                                            height: 30
+                                            source: serverManager.servers
+                                            serverId: model.serverId
+                                            revision: model.historyRevision
+                                            metric: HistorySparkLine.NetDown
+                                            tier: historyTier
+                                            lineColor: "#00FF00"
+                                        }
                                     }
                                 }
                             }
@@ -283,12 +570,12 @@ Item {
                                 z: 10  // Ensure buttons are above MouseArea
 
                                 Button {
-                                    text: modelData.connected ? "DISCONNECT" : "CONNECT"
+                                    text: model.connected ? "DISCONNECT" : "CONNECT"
                                     width: 90
                                     height: 26
                                     background: Rectangle {
-                                        color: parent.hovered ? (modelData.connected ? "#CC0000" : "#008B00") : (modelData.connected ? "#660000" : "#004400")
-                                        border.color: parent.hovered ? (modelData.connected ? "#FF0000" : "#00FF00") : (modelData.connected ? "#8B0000" : "#008B00")
+                                        color: parent.hovered ? (model.connected ? "#CC0000" : "#008B00") : (model.connected ? "#660000" : "#004400")
+                                        border.color: parent.hovered ? (model.connected ? "#FF0000" : "#00FF00") : (model.connected ? "#8B0000" : "#008B00")
                                         border.width: 1
                                         radius: 0
                                     }
@@ -303,10 +590,10 @@ Item {
                                         font.family: "Segoe UI"
                                     }
                                     onClicked: {
-                                        if (modelData.connected) {
-                                            serverManager.disconnectFromServer(modelData.id)
+                                        if (model.connected) {
+                                            serverManager.disconnectFromServer(model.serverId)
                                         } else {
-                                            serverManager.connectToServer(modelData.id)
+                                            serverManager.connectToServer(model.serverId)
                                         }
                                     }
                                 }
@@ -332,13 +619,14 @@ Item {
                                         font.family: "Segoe UI"
                                     }
                                     onClicked: {
-                                        console.log("EDIT button clicked for server:", modelData.id, modelData.name)
-                                        editServerId = modelData.id
-                                        editServerName = modelData.name
-                                        editServerHost = modelData.host
-                                        editServerPort = modelData.port
-                                        editServerUsername = modelData.username
-                                        editServerPassword = modelData.password || ""  // Store current password or empty string
+                                        console.log("EDIT button clicked for server:", model.serverId, model.name)
+                                        editServerId = model.serverId
+                                        editServerName = model.name
+                                        editServerHost = model.host
+                                        editServerPort = model.port
+                                        editServerUsername = model.username
+                                        editServerTags = model.tags
+                                        editServerPollInterval = model.pollInterval
                                         showEditDialog = true
                                         console.log("showEditDialog set to:", showEditDialog)
                                     }
@@ -364,7 +652,7 @@ Item {
                                         font.letterSpacing: 1
                                         font.family: "Segoe UI"
                                     }
-                                    onClicked: serverManager.removeServer(modelData.id)
+                                    onClicked: serverManager.removeServer(model.serverId)
                                 }
                             }
                         }
@@ -374,10 +662,10 @@ Item {
 
             Text {
                 anchors.centerIn: parent
-                text: serverManager.servers.length === 0 ? "No servers added. Click '+ ADD SERVER' to get started." : ""
+                text: serverManager.servers.count === 0 ? "No servers added. Click '+ ADD SERVER' to get started." : ""
                 color: "#666"
                 font.pixelSize: 14
-                visible: serverManager.servers.length === 0
+                visible: serverManager.servers.count === 0
             }
         }
     }
@@ -397,7 +685,7 @@ Item {
         Rectangle {
             anchors.centerIn: parent
             width: 400
-            height: 350
+            height: 450
             color: "#0F0F0F"
             border.color: "#8B0000"
             border.width: 2
@@ -482,6 +770,33 @@ Item {
                     }
                 }
 
+                TextField {
+                    id: tagsField
+                    width: parent.width
+                    placeholderText: "Tags, comma-separated (e.g. prod, db)"
+                    placeholderTextColor: "#666"
+                    color: "white"
+                    background: Rectangle {
+                        color: "#1a1a1a"
+                        border.color: "#333"
+                        border.width: 1
+                    }
+                }
+
+                TextField {
+                    id: pollIntervalField
+                    width: parent.width
+                    placeholderText: "Poll interval in seconds (default: from tags or 5)"
+                    placeholderTextColor: "#666"
+                    validator: IntValidator { bottom: 0; top: 3600 }
+                    color: "white"
+                    background: Rectangle {
+                        color: "#1a1a1a"
+                        border.color: "#333"
+                        border.width: 1
+                    }
+                }
+
                 CheckBox {
                     id: autoConnectCheck
                     text: "Auto-connect after adding"
@@ -526,6 +841,8 @@ Item {
                                 parseInt(portField.text) || 22,
                                 usernameField.text,
                                 passwordField.text,
+                                tagsField.text,
+                                parseInt(pollIntervalField.text) || 0,
                                 autoConnectCheck.checked
                             )
                             showAddDialog = false
@@ -534,6 +851,8 @@ Item {
                             portField.text = "22"
                             usernameField.text = ""
                             passwordField.text = ""
+                            tagsField.text = ""
+                            pollIntervalField.text = ""
                             autoConnectCheck.checked = false
                         }
                     }
@@ -577,7 +896,7 @@ Item {
         Rectangle {
             anchors.centerIn: parent
             width: 400
-            height: 350
+            height: 450
             color: "#0F0F0F"
             border.color: "#8B0000"
             border.width: 2
@@ -666,6 +985,35 @@ Item {
                     }
                 }
 
+                TextField {
+                    id: editTagsField
+                    width: parent.width
+                    placeholderText: "Tags, comma-separated (e.g. prod, db)"
+                    placeholderTextColor: "#666"
+                    text: editServerTags
+                    color: "white"
+                    background: Rectangle {
+                        color: "#1a1a1a"
+                        border.color: "#333"
+                        border.width: 1
+                    }
+                }
+
+                TextField {
+                    id: editPollIntervalField
+                    width: parent.width
+                    placeholderText: "Poll interval in seconds (default: from tags or 5)"
+                    placeholderTextColor: "#666"
+                    text: editServerPollInterval > 0 ? editServerPollInterval.toString() : ""
+                    validator: IntValidator { bottom: 0; top: 3600 }
+                    color: "white"
+                    background: Rectangle {
+                        color: "#1a1a1a"
+                        border.color: "#333"
+                        border.width: 1
+                    }
+                }
+
                 Item { height: 10 }  // Extra spacing before buttons
 
                 Row {
@@ -696,7 +1044,9 @@ Item {
                                 editHostField.text,
                                 parseInt(editPortField.text) || 22,
                                 editUsernameField.text,
-                                editPasswordField.text || editServerPassword  // Use current if empty
+                                editPasswordField.text,  // Empty keeps the current password
+                                editTagsField.text,
+                                parseInt(editPollIntervalField.text) || 0
                             )
                             showEditDialog = false
                         }